@@ -14,88 +14,91 @@ This library is distributed in the hope that it will be useful, but WITHOUT ANY
 #include <pgmspace.h>
 #endif
 
+#define BASE64_INVALID 0xFF
+#define BASE64_PAD 0xFE
+
 const char PROGMEM _Base64AlphabetTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
 		"abcdefghijklmnopqrstuvwxyz"
 		"0123456789+/";
 
+// reverse lookup table: character -> 6 bit value, BASE64_PAD for '=', BASE64_INVALID for all other characters
+const uint8_t PROGMEM _Base64ReverseTable[256] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+	0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF,
+	0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+	0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+static inline uint8_t lookupReverse(char c) {
+	return pgm_read_byte(&_Base64ReverseTable[(uint8_t)c]);
+}
+
 int Base64Class::encode(char *output, char *input, int inputLength) {
-	int i = 0, j = 0;
+	const uint8_t *in = (const uint8_t *)input;
 	int encodedLength = 0;
-	unsigned char A3[3];
-	unsigned char A4[4];
-
-	while(inputLength--) {
-		A3[i++] = *(input++);
-		if(i == 3) {
-			fromA3ToA4(A4, A3);
-
-			for(i = 0; i < 4; i++) {
-				output[encodedLength++] = pgm_read_byte(&_Base64AlphabetTable[A4[i]]);
-			}
 
-			i = 0;
-		}
+	// 3 bytes -> 4 characters per iteration
+	for(; inputLength >= 3; inputLength -= 3, in += 3) {
+		uint32_t block = ((uint32_t)in[0] << 16) | ((uint32_t)in[1] << 8) | in[2];
+		output[encodedLength++] = pgm_read_byte(&_Base64AlphabetTable[block >> 18]);
+		output[encodedLength++] = pgm_read_byte(&_Base64AlphabetTable[(block >> 12) & 0x3f]);
+		output[encodedLength++] = pgm_read_byte(&_Base64AlphabetTable[(block >> 6) & 0x3f]);
+		output[encodedLength++] = pgm_read_byte(&_Base64AlphabetTable[block & 0x3f]);
 	}
 
-	if(i) {
-		for(j = i; j < 3; j++) {
-			A3[j] = '\0';
-		}
-
-		fromA3ToA4(A4, A3);
-
-		for(j = 0; j < i + 1; j++) {
-			output[encodedLength++] = pgm_read_byte(&_Base64AlphabetTable[A4[j]]);
-		}
-
-		while((i++ < 3)) {
-			output[encodedLength++] = '=';
+	if(inputLength > 0) {
+		uint32_t block = (uint32_t)in[0] << 16;
+		if(inputLength == 2) {
+			block |= (uint32_t)in[1] << 8;
 		}
+		output[encodedLength++] = pgm_read_byte(&_Base64AlphabetTable[block >> 18]);
+		output[encodedLength++] = pgm_read_byte(&_Base64AlphabetTable[(block >> 12) & 0x3f]);
+		output[encodedLength++] = inputLength == 2 ? pgm_read_byte(&_Base64AlphabetTable[(block >> 6) & 0x3f]) : '=';
+		output[encodedLength++] = '=';
 	}
 	output[encodedLength] = '\0';
 	return encodedLength;
 }
 
 int Base64Class::decode(char * output, char * input, int inputLength) {
-	int i = 0, j = 0;
 	int decodedLength = 0;
-	unsigned char A3[3];
-	unsigned char A4[4];
-
+	uint32_t block = 0;
+	int count = 0;
 
-	while (inputLength--) {
-		if(*input == '=') {
+	// decoding stops at the first '=' (invalid characters are decoded as 0)
+	while(inputLength--) {
+		uint8_t value = lookupReverse(*(input++));
+		if(value == BASE64_PAD) {
 			break;
 		}
-
-		A4[i++] = *(input++);
-		if (i == 4) {
-			for (i = 0; i <4; i++) {
-				A4[i] = lookupTable(A4[i]);
-			}
-
-			fromA4ToA3(A3,A4);
-
-			for (i = 0; i < 3; i++) {
-				output[decodedLength++] = A3[i];
-			}
-			i = 0;
+		block = (block << 6) | (value & 0x3f);
+		if(++count == 4) {
+			output[decodedLength++] = block >> 16;
+			output[decodedLength++] = block >> 8;
+			output[decodedLength++] = block;
+			block = 0;
+			count = 0;
 		}
 	}
 
-	if (i) {
-		for (j = i; j < 4; j++) {
-			A4[j] = '\0';
-		}
-
-		for (j = 0; j <4; j++) {
-			A4[j] = lookupTable(A4[j]);
-		}
-
-		fromA4ToA3(A3,A4);
-
-		for (j = 0; j < i - 1; j++) {
-			output[decodedLength++] = A3[j];
+	// remaining 2 or 3 characters -> 1 or 2 bytes
+	if(count > 1) {
+		block <<= 6 * (4 - count);
+		output[decodedLength++] = block >> 16;
+		if(count == 3) {
+			output[decodedLength++] = block >> 8;
 		}
 	}
 	output[decodedLength] = '\0';
@@ -110,34 +113,89 @@ int Base64Class::encodedLength(int plainLength) {
 int Base64Class::decodedLength(char * input, int inputLength) {
 	int i = 0;
 	int numEq = 0;
-	for(i = inputLength - 1; input[i] == '='; i--) {
+	for(i = inputLength - 1; i >= 0 && input[i] == '='; i--) {
 		numEq++;
 	}
 
 	return ((6 * inputLength) / 8) - numEq;
 }
 
-//Private utility functions
-inline void Base64Class::fromA3ToA4(unsigned char * A4, unsigned char * A3) {
-	A4[0] = (A3[0] & 0xfc) >> 2;
-	A4[1] = ((A3[0] & 0x03) << 4) + ((A3[1] & 0xf0) >> 4);
-	A4[2] = ((A3[1] & 0x0f) << 2) + ((A3[2] & 0xc0) >> 6);
-	A4[3] = (A3[2] & 0x3f);
+Base64Class Base64;
+
+Base64Decoder::Base64Decoder() {
+	reset();
+}
+
+// start decoding of new data
+void Base64Decoder::reset() {
+	bits = 0;
+	count = 0;
+	padding = 0;
+	error = false;
+}
+
+// decode the next chunk of characters, output needs space for maxDecodedLength(inputLength) bytes,
+// returns the number of decoded bytes (-1 on error)
+int Base64Decoder::update(uint8_t *output, const char *input, int inputLength) {
+	int decodedLength = 0;
+	if(error) {
+		return -1;
+	}
+
+	while(inputLength--) {
+		uint8_t value = lookupReverse(*(input++));
+		if(value == BASE64_PAD) {
+			// padding is only valid for the last 1 or 2 characters of a quantum
+			if(count + padding < 2) {
+				error = true;
+				return -1;
+			}
+			padding++;
+			continue;
+		}
+		if(value == BASE64_INVALID || padding > 0) {
+			error = true;
+			return -1;
+		}
+		bits = (bits << 6) | value;
+		if(++count == 4) {
+			output[decodedLength++] = bits >> 16;
+			output[decodedLength++] = bits >> 8;
+			output[decodedLength++] = bits;
+			bits = 0;
+			count = 0;
+		}
+	}
+	return decodedLength;
 }
 
-inline void Base64Class::fromA4ToA3(unsigned char * A3, unsigned char * A4) {
-	A3[0] = (A4[0] << 2) + ((A4[1] & 0x30) >> 4);
-	A3[1] = ((A4[1] & 0xf) << 4) + ((A4[2] & 0x3c) >> 2);
-	A3[2] = ((A4[2] & 0x3) << 6) + A4[3];
+// finish decoding (input with or without padding), output needs space for 2 bytes,
+// returns the number of decoded bytes (-1 on error)
+int Base64Decoder::final(uint8_t *output) {
+	int decodedLength = 0;
+	if(error || count == 1 || (padding > 0 && count + padding != 4)) {
+		error = true;
+		return -1;
+	}
+	if(count > 1) {
+		uint32_t block = bits << (6 * (4 - count));
+		output[decodedLength++] = block >> 16;
+		if(count == 3) {
+			output[decodedLength++] = block >> 8;
+		}
+	}
+	bits = 0;
+	count = 0;
+	padding = 0;
+	return decodedLength;
 }
 
-inline unsigned char Base64Class::lookupTable(char c) {
-	if(c >='A' && c <='Z') return c - 'A';
-	if(c >='a' && c <='z') return c - 71;
-	if(c >='0' && c <='9') return c + 4;
-	if(c == '+') return 62;
-	if(c == '/') return 63;
-	return -1;
+// true if invalid data was detected
+bool Base64Decoder::isError() {
+	return error;
 }
 
-Base64Class Base64;
+// max. number of bytes returned by update() for the given number of characters
+int Base64Decoder::maxDecodedLength(int inputLength) {
+	return (inputLength + 3) / 4 * 3;
+}
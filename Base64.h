@@ -9,18 +9,33 @@ This library is distributed in the hope that it will be useful, but WITHOUT ANY
 #ifndef _BASE64_H
 #define _BASE64_H
 
+#include <stdint.h>
+
 class Base64Class{
   public:
     int encode(char *output, char *input, int inputLength);
     int decode(char * output, char * input, int inputLength);
     int encodedLength(int plainLength);
     int decodedLength(char * input, int inputLength);
+};
+extern Base64Class Base64;
+
+// Incremental decoder: the encoded data can be passed in chunks of any size (e.g. as received from a socket).
+// Invalid characters, data after padding and incomplete input are reported as error.
+class Base64Decoder{
+  public:
+    Base64Decoder();
+    void reset();
+    int update(uint8_t *output, const char *input, int inputLength);
+    int final(uint8_t *output);
+    bool isError();
+    static int maxDecodedLength(int inputLength);
 
   private:
-    inline void fromA3ToA4(unsigned char * A4, unsigned char * A3);
-    inline void fromA4ToA3(unsigned char * A3, unsigned char * A4);
-    inline unsigned char lookupTable(char c);
+    uint32_t bits;      // collected 6 bit groups of the current quantum
+    uint8_t count;      // number of characters in the current quantum
+    uint8_t padding;    // number of '=' received
+    bool error;
 };
-extern Base64Class Base64;
 
 #endif // _BASE64_H
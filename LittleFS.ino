@@ -28,9 +28,6 @@
 // Die Funktion "setupFS();" muss im Setup aufgerufen werden.
 /**************************************************************************************/
 
-#include <list>
-#include <tuple>
-
 const char WARNING[] PROGMEM = R"(<h2>Der Sketch wurde mit "FS:none" kompilliert!)";
 const char HELPER[] PROGMEM = R"(<form method="POST" action="/upload" enctype="multipart/form-data">
 <input type="file" name="[]" multiple><button>Upload</button></form>Lade die fs.html hoch.)";
@@ -45,55 +42,109 @@ void setupFS() {
   });
 }
 
+#define FS_NAME_LEN 32                                                                  // max. Länge der Datei- und Ordnernamen inkl. NUL
+
+struct DirEntry {                                                                      // Eintrag der Dateiliste
+  uint8_t folder;                                                                      // Index des Ordners (0 = Wurzelverzeichnis)
+  char name[FS_NAME_LEN];
+  uint32_t size;
+};
+
+static char (*sortFolders)[FS_NAME_LEN];                                               // Ordnernamen für compareDirEntries()
+static bool sortBySize;
+
+int compareDirEntries(const void *a, const void *b) {                                  // Ordner alphabetisch, darin Dateien alphabetisch oder nach Größe
+  const DirEntry *f = static_cast<const DirEntry*>(a);
+  const DirEntry *l = static_cast<const DirEntry*>(b);
+  int cmp = strncasecmp(sortFolders[f->folder], sortFolders[l->folder], FS_NAME_LEN - 1);
+  if (cmp != 0) return cmp;
+  if (f->folder != l->folder) return f->folder < l->folder ? -1 : 1;                   // Ordner, die sich nur in Groß-/Kleinschreibung unterscheiden
+  if (sortBySize && f->size != l->size) return f->size < l->size ? 1 : -1;
+  cmp = strncasecmp(f->name, l->name, FS_NAME_LEN - 1);                                 // gleiche Größe: nach Namen, qsort ist nicht stabil
+  if (cmp != 0) return cmp;
+  return strncmp(f->name, l->name, FS_NAME_LEN - 1);
+}
+
 bool handleList() {                                                                    // Senden aller Daten an den Client
   FSInfo fs_info;  LittleFS.info(fs_info);                                             // Füllt FSInfo Struktur mit Informationen über das Dateisystem
+  uint16_t numFolders {1}, numEntries {0};
   Dir dir = LittleFS.openDir("/");
-  using namespace std;
-  using records = tuple<String, String, int>;
-  list<records> dirList;
-  while (dir.next()) {                                                                 // Ordner und Dateien zur Liste hinzufügen
+  while (dir.next()) {                                                                 // Ordner und Dateien zählen
     if (dir.isDirectory()) {
-      uint8_t ran {0};
+      uint16_t ran {0};
       Dir fold = LittleFS.openDir(dir.fileName());
-      while (fold.next())  {
-        ran++;
-        dirList.emplace_back(dir.fileName(), fold.fileName(), fold.fileSize());
-      }
-      if (!ran) dirList.emplace_back(dir.fileName(), "", 0);
+      while (fold.next()) ran++;
+      numFolders++;
+      numEntries += ran ? ran : 1;                                                     // leerer Ordner als eigener Eintrag
     }
     else {
-      dirList.emplace_back("", dir.fileName(), dir.fileSize());
+      numEntries++;
     }
   }
-  dirList.sort([](const records & f, const records & l) {                              // Dateien sortieren
-    if (server.arg(0) == "1") {
-      return get<2>(f) > get<2>(l);
-    } else {
-      for (uint8_t i = 0; i < 31; i++) {
-        if (tolower(get<1>(f)[i]) < tolower(get<1>(l)[i])) return true;
-        else if (tolower(get<1>(f)[i]) > tolower(get<1>(l)[i])) return false;
+  numFolders = min(numFolders, (uint16_t)256);
+  // ein einziger Block für Ordnernamen und Einträge, wird nach dem Senden wieder freigegeben
+  uint8_t *block = static_cast<uint8_t*>(malloc(numFolders * FS_NAME_LEN + numEntries * sizeof(DirEntry)));
+  if (!block) {
+    server.send(500, "text/plain", "Not enough memory");
+    return true;
+  }
+  char (*folders)[FS_NAME_LEN] = reinterpret_cast<char (*)[FS_NAME_LEN]>(block);
+  DirEntry *entries = reinterpret_cast<DirEntry*>(block + numFolders * FS_NAME_LEN);
+  folders[0][0] = '\0';
+  uint16_t folder {0}, count {0};
+  dir = LittleFS.openDir("/");
+  while (dir.next() && count < numEntries) {                                           // Ordner und Dateien zur Liste hinzufügen
+    if (dir.isDirectory()) {
+      if (folder + 1 >= numFolders) continue;
+      folder++;
+      strlcpy(folders[folder], dir.fileName().c_str(), FS_NAME_LEN);
+      uint16_t ran {0};
+      Dir fold = LittleFS.openDir(dir.fileName());
+      while (fold.next() && count < numEntries) {
+        ran++;
+        entries[count].folder = folder;
+        strlcpy(entries[count].name, fold.fileName().c_str(), FS_NAME_LEN);
+        entries[count++].size = fold.fileSize();
       }
-      return false;
-    }
-  });
-  dirList.sort([](const records & f, const records & l) {                              // Ordner sortieren
-    if (get<0>(f)[0] != 0x00 || get<0>(l)[0] != 0x00) {
-      for (uint8_t i = 0; i < 31; i++) {
-          if (tolower(get<0>(f)[i]) < tolower(get<0>(l)[i])) return true;
-          else if (tolower(get<0>(f)[i]) > tolower(get<0>(l)[i])) return false;
+      if (!ran && count < numEntries) {
+        entries[count].folder = folder;
+        entries[count].name[0] = '\0';
+        entries[count++].size = 0;
       }
     }
-    return false;
-  });
-  String temp = "[";
-  for (auto& t : dirList) {
-    if (temp != "[") temp += ',';
-    temp += "{\"folder\":\"" + get<0>(t) + "\",\"name\":\"" + get<1>(t) + "\",\"size\":\"" + formatBytes(get<2>(t)) + "\"}";
+    else {
+      entries[count].folder = 0;
+      strlcpy(entries[count].name, dir.fileName().c_str(), FS_NAME_LEN);
+      entries[count++].size = dir.fileSize();
+    }
+  }
+  sortFolders = folders;
+  sortBySize = server.arg(0) == "1";
+  qsort(entries, count, sizeof(DirEntry), compareDirEntries);                          // Ordner und Dateien sortieren
+
+  char bytes[16];
+  JsonWriter json(&server);                                                            // Antwort direkt aus kleinem Puffer senden
+  json.begin(200);
+  json.beginArray();
+  for (uint16_t i = 0; i < count; i++) {
+    json.beginObject();
+    json.field("folder", folders[entries[i].folder]);
+    json.field("name", entries[i].name);
+    formatBytes(bytes, sizeof(bytes), entries[i].size);
+    json.field("size", bytes);
+    json.endObject();
   }
-  temp += ",{\"usedBytes\":\"" + formatBytes(fs_info.usedBytes) +                      // Berechnet den verwendeten Speicherplatz
-          "\",\"totalBytes\":\"" + formatBytes(fs_info.totalBytes) +                   // Zeigt die Größe des Speichers
-          "\",\"freeBytes\":\"" + (fs_info.totalBytes - fs_info.usedBytes) + "\"}]";   // Berechnet den freien Speicherplatz
-  server.send(200, "application/json", temp);
+  free(block);
+  json.beginObject();
+  formatBytes(bytes, sizeof(bytes), fs_info.usedBytes);                                // Berechnet den verwendeten Speicherplatz
+  json.field("usedBytes", bytes);
+  formatBytes(bytes, sizeof(bytes), fs_info.totalBytes);                               // Zeigt die Größe des Speichers
+  json.field("totalBytes", bytes);
+  snprintf(bytes, sizeof(bytes), "%u", (unsigned)(fs_info.totalBytes - fs_info.usedBytes));    // Berechnet den freien Speicherplatz
+  json.field("freeBytes", bytes);
+  json.endObject();
+  json.endArray();
+  json.end();
   return true;
 }
 
@@ -155,6 +206,8 @@ void sendResponce() {
   server.send(303, "message/http");
 }
 
-const String formatBytes(size_t const& bytes) {                                        // lesbare Anzeige der Speichergrößen
-  return bytes < 1024 ? static_cast<String>(bytes) + " Byte" : bytes < 1048576 ? static_cast<String>(bytes / 1024.0) + " KB" : static_cast<String>(bytes / 1048576.0) + " MB";
+void formatBytes(char *buffer, size_t size, size_t bytes) {                            // lesbare Anzeige der Speichergrößen
+  if (bytes < 1024) snprintf(buffer, size, "%u Byte", (unsigned)bytes);
+  else if (bytes < 1048576) snprintf(buffer, size, "%.2f KB", bytes / 1024.0);
+  else snprintf(buffer, size, "%.2f MB", bytes / 1048576.0);
 }
@@ -0,0 +1,145 @@
+// Optional cache of all clock faces: the face only depends on (hours, minutes, layout), so all faces
+// are rendered once at boot and the clock state just copies the precomputed bitmask to the targetgrid.
+//
+// Memory layout (RAM, allocated on heap when cache is built):
+//  - clockFaceIndex: one uint16_t per minute of the day (1440 entries),
+//    bits 0-11 = index of the face bitmask, bits 12-15 = minute indicator pattern
+//  - clockFaceMasks: deduplicated bitmasks of the letters (GRID_MASK_BYTES each)
+// The index covers 24h (not 12h) because some layouts distinguish e.g. midnight and noon.
+
+#define NUM_FACE_MINUTES (24 * 60)
+#define MAX_CLOCK_FACES 512           // upper bound of distinct faces (before shrinking)
+#define FACE_INDEX_MASK 0x0FFF
+#define FACE_INDICATOR_SHIFT 12
+#define FACE_BENCHMARK_RUNS 100
+
+uint16_t *clockFaceIndex = NULL;
+uint8_t *clockFaceMasks = NULL;
+uint16_t numClockFaces = 0;
+
+/**
+ * @brief Render all clock faces of the current layout once and store them as bitmasks
+ *
+ * Uses the targetgrid of the ledmatrix for rendering, so the grid is flushed afterwards.
+ *
+ * @return true if the cache was built successfully
+ */
+bool buildClockFaceCache(){
+  freeClockFaceCache();
+  unsigned long start = micros();
+
+  clockFaceIndex = (uint16_t*) malloc(NUM_FACE_MINUTES * sizeof(uint16_t));
+  clockFaceMasks = (uint8_t*) malloc(MAX_CLOCK_FACES * GRID_MASK_BYTES);
+  if(clockFaceIndex == NULL || clockFaceMasks == NULL){
+    LOG_ERROR(logger, "Clock face cache: not enough memory");
+    freeClockFaceCache();
+    return false;
+  }
+
+  // render without dynamic color shift, only the active pixels are of interest
+  ledmatrix.setDynamicColorShiftPhase(-1);
+  uint8_t mask[GRID_MASK_BYTES];
+  for(uint16_t m = 0; m < NUM_FACE_MINUTES; m++){
+    showTimeOnClock(m / 60, m % 60, colors24bit[0]);
+    drawMinuteIndicator(m % 60, colors24bit[0]);
+    ledmatrix.gridGetMask(mask);
+
+    // search for an identical face, newest first as consecutive minutes mostly share the same face
+    int16_t face = numClockFaces - 1;
+    while(face >= 0 && memcmp(clockFaceMasks + face * GRID_MASK_BYTES, mask, GRID_MASK_BYTES) != 0){
+      face--;
+    }
+    if(face < 0){
+      if(numClockFaces >= MAX_CLOCK_FACES){
+        LOG_ERROR(logger, "Clock face cache: too many faces");
+        freeClockFaceCache();
+        ledmatrix.gridFlush();
+        return false;
+      }
+      face = numClockFaces++;
+      memcpy(clockFaceMasks + face * GRID_MASK_BYTES, mask, GRID_MASK_BYTES);
+    }
+    clockFaceIndex[m] = face | (ledmatrix.getMinIndicatorPattern() << FACE_INDICATOR_SHIFT);
+  }
+  ledmatrix.gridFlush();
+
+  // give back the unused part of the mask buffer
+  uint8_t *shrunk = (uint8_t*) realloc(clockFaceMasks, numClockFaces * GRID_MASK_BYTES);
+  if(shrunk != NULL){
+    clockFaceMasks = shrunk;
+  }
+
+  LOG_INFO(logger, "Clock face cache: %u faces, %u bytes RAM, built in %lu us", numClockFaces, getClockFaceCacheSize(),
+            (unsigned long)(micros() - start));
+  return true;
+}
+
+/**
+ * @brief Release the memory of the clock face cache
+ */
+void freeClockFaceCache(){
+  free(clockFaceIndex);
+  free(clockFaceMasks);
+  clockFaceIndex = NULL;
+  clockFaceMasks = NULL;
+  numClockFaces = 0;
+}
+
+/**
+ * @brief Check if the clock face cache is built
+ *
+ * @return true if faces can be drawn from cache
+ */
+bool isClockFaceCacheValid(){
+  return clockFaceIndex != NULL && clockFaceMasks != NULL;
+}
+
+/**
+ * @brief Get the RAM footprint of the clock face cache
+ *
+ * @return uint32_t size in bytes
+ */
+uint32_t getClockFaceCacheSize(){
+  if(!isClockFaceCacheValid()) return 0;
+  return NUM_FACE_MINUTES * sizeof(uint16_t) + numClockFaces * GRID_MASK_BYTES;
+}
+
+/**
+ * @brief Draw the time and the minute indicator from the clock face cache
+ *
+ * @param hours hours of the time to display (0-23)
+ * @param minutes minutes of the time to display (0-59)
+ * @param color color to display
+ */
+void showTimeFromCache(uint8_t hours, uint8_t minutes, uint32_t color){
+  uint16_t entry = clockFaceIndex[(hours % 24) * 60 + minutes % 60];
+  ledmatrix.gridFlush();
+  ledmatrix.gridAddMask(clockFaceMasks + (entry & FACE_INDEX_MASK) * GRID_MASK_BYTES, color);
+  ledmatrix.setMinIndicator(entry >> FACE_INDICATOR_SHIFT, color);
+}
+
+/**
+ * @brief Log the per-update cost of the different ways to render the clock face (for comparison)
+ *
+ * Uses the targetgrid of the ledmatrix, so the grid is flushed afterwards.
+ */
+void benchmarkClockFace(){
+  unsigned long start = micros();
+  for(uint8_t i = 0; i < FACE_BENCHMARK_RUNS; i++){
+    showTimeOnClock(i % 24, i % 60, colors24bit[0]);
+    drawMinuteIndicator(i % 60, colors24bit[0]);
+  }
+  unsigned long timeWords = (micros() - start) / FACE_BENCHMARK_RUNS;
+
+  unsigned long timeCache = 0;
+  if(isClockFaceCacheValid()){
+    start = micros();
+    for(uint8_t i = 0; i < FACE_BENCHMARK_RUNS; i++){
+      showTimeFromCache(i % 24, i % 60, colors24bit[0]);
+    }
+    timeCache = (micros() - start) / FACE_BENCHMARK_RUNS;
+  }
+  ledmatrix.gridFlush();
+
+  LOG_INFO(logger, "Clock face update (us): words %lu, cache %lu", timeWords, timeCache);
+}
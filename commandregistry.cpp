@@ -0,0 +1,85 @@
+#include "commandregistry.h"
+
+/**
+ * @brief Construct a new CommandRegistry object without commands
+ *
+ */
+CommandRegistry::CommandRegistry(){
+    numCommands = 0;
+}
+
+/**
+ * @brief Register a command, the table is kept sorted by name
+ *
+ * @param name name of the command (parameter name in the URL), needs to stay valid (e.g. string literal)
+ * @param handler function to check and execute the command
+ * @return true if the command was added, false if the table is full or the name exists already
+ */
+bool CommandRegistry::addCommand(const char *name, CommandHandler handler){
+    if(numCommands >= CMDREGISTRY_MAX_COMMANDS){
+        return false;
+    }
+    // insertion sort, commands are only added during setup
+    uint8_t pos = numCommands;
+    while(pos > 0){
+        int cmp = strcmp(name, commands[pos - 1].name);
+        if(cmp == 0){
+            return false;
+        }
+        if(cmp > 0){
+            break;
+        }
+        pos--;
+    }
+    for(uint8_t i = numCommands; i > pos; i--){
+        commands[i] = commands[i - 1];
+    }
+    commands[pos].name = name;
+    commands[pos].handler = handler;
+    numCommands++;
+    return true;
+}
+
+/**
+ * @brief Find the handler of a command by binary search
+ *
+ * @param name name of the command
+ * @return CommandHandler handler of the command, NULL if the command is unknown
+ */
+CommandHandler CommandRegistry::find(const char *name){
+    int16_t low = 0;
+    int16_t high = numCommands - 1;
+    while(low <= high){
+        int16_t mid = (low + high) / 2;
+        int cmp = strcmp(name, commands[mid].name);
+        if(cmp == 0){
+            return commands[mid].handler;
+        }
+        if(cmp < 0){
+            high = mid - 1;
+        }
+        else{
+            low = mid + 1;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Get the number of registered commands
+ *
+ * @return uint8_t number of commands
+ */
+uint8_t CommandRegistry::getNumCommands(){
+    return numCommands;
+}
+
+/**
+ * @brief Get the name of a command (in alphabetical order)
+ *
+ * @param index index of the command (0 ... getNumCommands() - 1)
+ * @return const char* name of the command, empty string if index is invalid
+ */
+const char* CommandRegistry::getName(uint8_t index){
+    return index < numCommands ? commands[index].name : "";
+}
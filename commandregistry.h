@@ -0,0 +1,55 @@
+/**
+ * @file commandregistry.h
+ * @brief Registry of the commands of the /cmd route, sorted by name for lookup by binary search
+ *
+ * Each command has a handler, which is called twice for a request: first with apply = false to check
+ * the value, then with apply = true to execute it. So a request with several commands
+ * (e.g. /cmd?setting=...&lang=german) can be checked completely before anything is changed.
+ *
+ * Usage:
+ *  bool cmdLedOff(const char *value, bool apply){
+ *    if(strcmp(value, "0") != 0 && strcmp(value, "1") != 0) return false;
+ *    if(apply) ledOff = (value[0] == '1');
+ *    return true;
+ *  }
+ *  commands.addCommand("ledoff", cmdLedOff);
+ *  CommandHandler handler = commands.find("ledoff");
+ *
+ */
+
+#ifndef commandregistry_h
+#define commandregistry_h
+
+#include <Arduino.h>
+
+#define CMDREGISTRY_MAX_COMMANDS 24
+
+/**
+ * @brief Handler of a command
+ *
+ * @param value value of the command (empty string if the command has no value)
+ * @param apply false: only check the value, true: execute the command
+ * @return true if the value is valid
+ */
+typedef bool (*CommandHandler)(const char *value, bool apply);
+
+class CommandRegistry{
+
+    public:
+        CommandRegistry();
+        bool addCommand(const char *name, CommandHandler handler);
+        CommandHandler find(const char *name);
+        uint8_t getNumCommands();
+        const char* getName(uint8_t index);
+
+    private:
+        struct Command {
+            const char *name;
+            CommandHandler handler;
+        };
+
+        Command commands[CMDREGISTRY_MAX_COMMANDS];     // sorted by name (strcmp)
+        uint8_t numCommands = 0;
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include "eventstream.h"
+
+/**
+ * @brief Construct a new EventStream object
+ *
+ * @param myserver pointer to the webserver, which receives the subscriptions
+ */
+EventStream::EventStream(ESP8266WebServer *myserver){
+    server = myserver;
+}
+
+/**
+ * @brief Take over the connection of the current request as event stream, needs to be called in the
+ * handler of the event route. Answers with 503 if all slots are used.
+ *
+ * @return int8_t slot of the new client (-1 if no slot was free)
+ */
+int8_t EventStream::subscribe(){
+    int8_t slot = -1;
+    for(int8_t i = 0; i < EVENTSTREAM_MAX_CLIENTS; i++){
+        if(!clients[i].connected()){
+            slot = i;
+            break;
+        }
+    }
+    if(slot < 0){
+        server->send(503, "text/plain", "Too many event clients");
+        return -1;
+    }
+
+    // the copy keeps the connection open after the webserver has finished the request
+    clients[slot] = server->client();
+    clients[slot].setNoDelay(true);
+    clients[slot].setTimeout(EVENTSTREAM_WRITE_TIMEOUT);
+
+    int length = snprintf(buffer, sizeof(buffer), "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                            "Cache-Control: no-cache\r\nConnection: keep-alive\r\n\r\nretry: %d\n\n", EVENTSTREAM_RETRY);
+    if(!write(slot, buffer, length)){
+        return -1;
+    }
+    return slot;
+}
+
+/**
+ * @brief Send an event to one client
+ *
+ * @param client slot of the client
+ * @param event name of the event
+ * @param data data of the event (single line)
+ * @return true if the event was sent
+ */
+bool EventStream::send(int8_t client, const char *event, const char *data){
+    if(client < 0 || client >= EVENTSTREAM_MAX_CLIENTS || !clients[client].connected()){
+        return false;
+    }
+    int length = snprintf(buffer, sizeof(buffer), "event: %s\ndata: %s\n\n", event, data);
+    if(length <= 0 || length >= (int)sizeof(buffer)){
+        return false;
+    }
+    if(!write(client, buffer, length)){
+        return false;
+    }
+    eventsSent++;
+    return true;
+}
+
+/**
+ * @brief Send an event to all clients
+ *
+ * @param event name of the event
+ * @param data data of the event (single line)
+ */
+void EventStream::broadcast(const char *event, const char *data){
+    for(int8_t i = 0; i < EVENTSTREAM_MAX_CLIENTS; i++){
+        send(i, event, data);
+    }
+}
+
+/**
+ * @brief Send keep-alive comments and release closed connections, needs to be called regularly
+ *
+ */
+void EventStream::handle(){
+    bool keepAlive = millis() - lastKeepAlive >= EVENTSTREAM_KEEPALIVE;
+    if(keepAlive){
+        lastKeepAlive = millis();
+    }
+    for(int8_t i = 0; i < EVENTSTREAM_MAX_CLIENTS; i++){
+        if(!clients[i].connected()){
+            // release the connection
+            clients[i] = WiFiClient();
+        }
+        else if(keepAlive){
+            write(i, ":\n\n", 3);
+        }
+    }
+}
+
+/**
+ * @brief Get the number of connected clients
+ *
+ * @return uint8_t number of clients
+ */
+uint8_t EventStream::getNumClients(){
+    uint8_t num = 0;
+    for(int8_t i = 0; i < EVENTSTREAM_MAX_CLIENTS; i++){
+        if(clients[i].connected()){
+            num++;
+        }
+    }
+    return num;
+}
+
+/**
+ * @brief Get the number of events sent since start (counted per client)
+ *
+ * @return uint32_t number of events
+ */
+uint32_t EventStream::getEventsSent(){
+    return eventsSent;
+}
+
+/**
+ * @brief Get the number of bytes sent since start (incl. HTTP header and keep-alive comments)
+ *
+ * @return uint32_t number of bytes
+ */
+uint32_t EventStream::getBytesSent(){
+    return bytesSent;
+}
+
+/**
+ * @brief (private) Write to a client, the client is dropped if the data can not be written completely
+ *
+ * @param client slot of the client
+ * @param data data to be written
+ * @param length length of the data
+ * @return true if all data was written
+ */
+bool EventStream::write(int8_t client, const char *data, size_t length){
+    size_t written = clients[client].write((const uint8_t*)data, length);
+    bytesSent += written;
+    if(written != length){
+        clients[client].stop();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file eventstream.h
+ * @brief Class for pushing events to browsers via Server-Sent Events (SSE) on the port of the webserver
+ *
+ * The handler of the event route (e.g. /events) calls subscribe(), which takes over the connection
+ * of the current request from the ESP8266WebServer and keeps it open. Events are written as
+ *  event: <name>
+ *  data: <data>
+ * followed by an empty line. Closed connections are detected on write or by the keep-alive comment.
+ *
+ */
+
+#ifndef eventstream_h
+#define eventstream_h
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+
+#define EVENTSTREAM_MAX_CLIENTS 5
+#define EVENTSTREAM_BUFFER_SIZE 512         // max. size of an event incl. name and framing
+#define EVENTSTREAM_KEEPALIVE 30000         // period (ms) of keep-alive comments
+#define EVENTSTREAM_WRITE_TIMEOUT 200       // clients which do not accept an event within this time (ms) are dropped
+#define EVENTSTREAM_RETRY 5000              // reconnect delay (ms) for the browser
+
+class EventStream{
+
+    public:
+        EventStream(ESP8266WebServer *myserver);
+        int8_t subscribe();
+        bool send(int8_t client, const char *event, const char *data);
+        void broadcast(const char *event, const char *data);
+        void handle();
+        uint8_t getNumClients();
+        uint32_t getEventsSent();
+        uint32_t getBytesSent();
+
+    private:
+        ESP8266WebServer *server;
+        WiFiClient clients[EVENTSTREAM_MAX_CLIENTS];
+        char buffer[EVENTSTREAM_BUFFER_SIZE];
+        unsigned long lastKeepAlive = 0;
+        uint32_t eventsSent = 0;
+        uint32_t bytesSent = 0;
+
+        bool write(int8_t client, const char *data, size_t length);
+};
+
+#endif
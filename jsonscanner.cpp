@@ -0,0 +1,405 @@
+#include "jsonscanner.h"
+
+/**
+ * @brief Construct a new JsonScanner object
+ *
+ * @param fields table of the keys to extract and their value buffers
+ * @param numFields number of fields in the table
+ */
+JsonScanner::JsonScanner(JsonField *fields, uint8_t numFields)
+{
+    this->_fields = fields;
+    this->_numFields = numFields;
+    this->reset();
+}
+
+/**
+ * @brief Reset the scanner and clear all values of the field table
+ *
+ */
+void JsonScanner::reset()
+{
+    this->_state = SCAN_START;
+    this->_keyLen = 0;
+    this->_current = NULL;
+    this->_escape = false;
+    this->_unicodeDigits = 0;
+    this->_depth = 0;
+    this->_nestedString = false;
+    for (uint8_t i = 0; i < this->_numFields; i++)
+    {
+        this->_fields[i].found = false;
+        if (this->_fields[i].size > 0)
+        {
+            this->_fields[i].value[0] = '\0';
+        }
+    }
+}
+
+/**
+ * @brief Process the next character of the JSON text
+ *
+ * @param c character
+ * @return false if the JSON text is invalid
+ */
+bool JsonScanner::feed(char c)
+{
+    switch (this->_state)
+    {
+    case SCAN_START:
+        if (c == '{')
+        {
+            this->_state = SCAN_KEY_START;
+        }
+        else if (!isWhitespace(c))
+        {
+            this->_state = SCAN_ERROR;
+        }
+        break;
+
+    case SCAN_KEY_START:
+        if (c == '"')
+        {
+            this->_keyLen = 0;
+            this->_escape = false;
+            this->_state = SCAN_KEY;
+        }
+        else if (c == '}')
+        {
+            this->_state = SCAN_DONE;
+        }
+        else if (!isWhitespace(c))
+        {
+            this->_state = SCAN_ERROR;
+        }
+        break;
+
+    case SCAN_KEY:
+        if (this->_escape)
+        {
+            this->_escape = false;
+            // escaped keys are not matched
+            this->_keyLen = JSON_MAX_KEY_LEN + 1;
+        }
+        else if (c == '\\')
+        {
+            this->_escape = true;
+        }
+        else if (c == '"')
+        {
+            this->matchKey();
+            this->_state = SCAN_COLON;
+        }
+        else if (this->_keyLen < JSON_MAX_KEY_LEN)
+        {
+            this->_key[this->_keyLen++] = c;
+        }
+        else
+        {
+            this->_keyLen = JSON_MAX_KEY_LEN + 1;
+        }
+        break;
+
+    case SCAN_COLON:
+        if (c == ':')
+        {
+            this->_state = SCAN_VALUE_START;
+        }
+        else if (!isWhitespace(c))
+        {
+            this->_state = SCAN_ERROR;
+        }
+        break;
+
+    case SCAN_VALUE_START:
+        this->_valueLen = 0;
+        if (c == '"')
+        {
+            this->_escape = false;
+            this->_unicodeDigits = 0;
+            this->_state = SCAN_STRING;
+        }
+        else if (c == '{' || c == '[')
+        {
+            this->_depth = 1;
+            this->_nestedString = false;
+            this->_escape = false;
+            this->_current = NULL;
+            this->_state = SCAN_NESTED;
+        }
+        else if (c == '-' || isalnum((unsigned char)c))
+        {
+            this->appendValue(c);
+            this->_state = SCAN_SCALAR;
+        }
+        else if (!isWhitespace(c))
+        {
+            this->_state = SCAN_ERROR;
+        }
+        break;
+
+    case SCAN_STRING:
+        if (this->_unicodeDigits > 0)
+        {
+            // characters outside of ASCII are replaced by '?'
+            if (!isxdigit((unsigned char)c))
+            {
+                this->_state = SCAN_ERROR;
+            }
+            else if (--this->_unicodeDigits == 0)
+            {
+                this->appendValue('?');
+            }
+        }
+        else if (this->_escape)
+        {
+            this->_escape = false;
+            switch (c)
+            {
+            case 'n': this->appendValue('\n'); break;
+            case 't': this->appendValue('\t'); break;
+            case 'r': this->appendValue('\r'); break;
+            case 'b': this->appendValue('\b'); break;
+            case 'f': this->appendValue('\f'); break;
+            case 'u': this->_unicodeDigits = 4; break;
+            default: this->appendValue(c); break; // \" \\ \/
+            }
+        }
+        else if (c == '\\')
+        {
+            this->_escape = true;
+        }
+        else if (c == '"')
+        {
+            this->_state = SCAN_VALUE_END;
+            if (this->_current != NULL)
+            {
+                this->_current->found = true;
+            }
+        }
+        else
+        {
+            this->appendValue(c);
+        }
+        break;
+
+    case SCAN_SCALAR:
+        if (c == '-' || c == '+' || c == '.' || isalnum((unsigned char)c))
+        {
+            this->appendValue(c);
+        }
+        else
+        {
+            if (this->_current != NULL)
+            {
+                this->_current->found = true;
+            }
+            return this->endValue(c);
+        }
+        break;
+
+    case SCAN_NESTED:
+        if (this->_nestedString)
+        {
+            if (this->_escape)
+            {
+                this->_escape = false;
+            }
+            else if (c == '\\')
+            {
+                this->_escape = true;
+            }
+            else if (c == '"')
+            {
+                this->_nestedString = false;
+            }
+        }
+        else if (c == '"')
+        {
+            this->_nestedString = true;
+        }
+        else if (c == '{' || c == '[')
+        {
+            this->_depth++;
+        }
+        else if ((c == '}' || c == ']') && --this->_depth == 0)
+        {
+            this->_state = SCAN_VALUE_END;
+        }
+        break;
+
+    case SCAN_VALUE_END:
+        return this->endValue(c);
+
+    case SCAN_DONE:
+    case SCAN_ERROR:
+        break;
+    }
+
+    return this->_state != SCAN_ERROR;
+}
+
+/**
+ * @brief Scan a complete JSON text
+ *
+ * @param json zero terminated JSON text
+ * @return true if the top level object was scanned completely
+ */
+bool JsonScanner::parse(const char *json)
+{
+    this->reset();
+    while (*json != '\0' && this->_state != SCAN_DONE)
+    {
+        if (!this->feed(*json++))
+        {
+            return false;
+        }
+    }
+    return this->_state == SCAN_DONE;
+}
+
+/**
+ * @brief Scan a JSON text directly from a stream (e.g. the body of a HTTP response), until the
+ * top level object is complete (the rest of the stream is not read)
+ *
+ * @param stream stream to read from
+ * @param timeout max. time in ms to wait for the next character
+ * @return true if the top level object was scanned completely
+ */
+bool JsonScanner::parse(Stream &stream, unsigned long timeout)
+{
+    this->reset();
+    unsigned long lastRead = millis();
+    while (this->_state != SCAN_DONE)
+    {
+        if (stream.available() > 0)
+        {
+            if (!this->feed(stream.read()))
+            {
+                return false;
+            }
+            lastRead = millis();
+        }
+        else if (millis() - lastRead > timeout)
+        {
+            return false;
+        }
+        else
+        {
+            yield();
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Check if the top level object was scanned completely
+ *
+ * @return true if the closing '}' was processed
+ */
+bool JsonScanner::isDone() const
+{
+    return this->_state == SCAN_DONE;
+}
+
+/**
+ * @brief Check if the JSON text was invalid
+ *
+ * @return true if a syntax error was detected
+ */
+bool JsonScanner::isError() const
+{
+    return this->_state == SCAN_ERROR;
+}
+
+/**
+ * @brief Get the number of fields found so far
+ *
+ * @return uint8_t number of fields with a value
+ */
+uint8_t JsonScanner::countFound() const
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < this->_numFields; i++)
+    {
+        if (this->_fields[i].found)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief (private) Select the field of the key just read (or none)
+ *
+ */
+void JsonScanner::matchKey()
+{
+    this->_current = NULL;
+    if (this->_keyLen > JSON_MAX_KEY_LEN)
+    {
+        return;
+    }
+    this->_key[this->_keyLen] = '\0';
+    for (uint8_t i = 0; i < this->_numFields; i++)
+    {
+        if (strcmp(this->_fields[i].key, this->_key) == 0)
+        {
+            this->_current = &this->_fields[i];
+            return;
+        }
+    }
+}
+
+/**
+ * @brief (private) Append a character to the value of the current field (truncated at the buffer size)
+ *
+ * @param c character
+ */
+void JsonScanner::appendValue(char c)
+{
+    if (this->_current != NULL && this->_valueLen + 1 < this->_current->size)
+    {
+        this->_current->value[this->_valueLen++] = c;
+        this->_current->value[this->_valueLen] = '\0';
+    }
+}
+
+/**
+ * @brief (private) Process the character after a value
+ *
+ * @param c character
+ * @return false if the JSON text is invalid
+ */
+bool JsonScanner::endValue(char c)
+{
+    if (c == ',')
+    {
+        this->_state = SCAN_KEY_START;
+    }
+    else if (c == '}')
+    {
+        this->_state = SCAN_DONE;
+    }
+    else if (isWhitespace(c))
+    {
+        this->_state = SCAN_VALUE_END;
+    }
+    else
+    {
+        this->_state = SCAN_ERROR;
+    }
+    return this->_state != SCAN_ERROR;
+}
+
+/**
+ * @brief (private) Check for JSON whitespace
+ *
+ * @param c character
+ * @return true if c is whitespace
+ */
+bool JsonScanner::isWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
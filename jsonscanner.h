@@ -0,0 +1,80 @@
+/**
+ * @file jsonscanner.h
+ * @brief Streaming JSON scanner which extracts the values of top level keys of an object in one pass
+ *
+ * The scanner is fed character by character (from a buffer or directly from a Stream) and copies the
+ * values of the requested keys into fixed buffers of a field table, no heap memory is used.
+ * String values are unescaped, other values (numbers, true, false, null) are copied as text,
+ * nested objects and arrays are skipped.
+ *
+ * Example:
+ *   char timezone[40];
+ *   char offset[12];
+ *   JsonField fields[] = {{"timezone", timezone, sizeof(timezone)}, {"offset", offset, sizeof(offset)}};
+ *   JsonScanner scanner(fields, 2);
+ *   scanner.parse(json);
+ *
+ */
+
+#ifndef jsonscanner_h
+#define jsonscanner_h
+
+#include <Arduino.h>
+
+#define JSON_MAX_KEY_LEN 24    // keys longer than this are never matched
+
+// field of the table to be filled by the scanner
+struct JsonField {
+    const char *key;
+    char *value;        // buffer for the value (zero terminated, truncated if too long)
+    uint8_t size;       // size of the buffer
+    bool found;
+};
+
+class JsonScanner{
+
+    public:
+        JsonScanner(JsonField *fields, uint8_t numFields);
+        void reset();
+        bool feed(char c);
+        bool parse(const char *json);
+        bool parse(Stream &stream, unsigned long timeout);
+        bool isDone() const;
+        bool isError() const;
+        uint8_t countFound() const;
+
+    private:
+        enum ScanState {
+            SCAN_START,         // waiting for '{' of the top level object
+            SCAN_KEY_START,     // waiting for '"' of a key or '}'
+            SCAN_KEY,           // inside of a key
+            SCAN_COLON,         // waiting for ':'
+            SCAN_VALUE_START,   // waiting for the first character of a value
+            SCAN_STRING,        // inside of a string value
+            SCAN_SCALAR,        // inside of a number, true, false or null
+            SCAN_NESTED,        // inside of a nested object or array (skipped)
+            SCAN_VALUE_END,     // waiting for ',' or '}'
+            SCAN_DONE,
+            SCAN_ERROR
+        };
+
+        JsonField *_fields;
+        uint8_t _numFields;
+        ScanState _state = SCAN_START;
+
+        char _key[JSON_MAX_KEY_LEN + 1];
+        uint8_t _keyLen = 0;
+        JsonField *_current = NULL;     // field of the current value (NULL if value is not requested)
+        uint8_t _valueLen = 0;
+        bool _escape = false;           // last character was a backslash
+        uint8_t _unicodeDigits = 0;     // remaining hex digits of a \uXXXX escape sequence
+        uint8_t _depth = 0;             // depth of skipped nested objects/arrays
+        bool _nestedString = false;     // inside of a string in a skipped nested object/array
+
+        void matchKey();
+        void appendValue(char c);
+        bool endValue(char c);
+        static bool isWhitespace(char c);
+};
+
+#endif
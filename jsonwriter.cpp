@@ -0,0 +1,281 @@
+#include "jsonwriter.h"
+
+/**
+ * @brief Construct a new JsonWriter object
+ *
+ * @param myserver pointer to the webserver, which sends the response
+ */
+JsonWriter::JsonWriter(ESP8266WebServer *myserver){
+    server = myserver;
+}
+
+/**
+ * @brief Construct a new JsonWriter object, which writes into a buffer instead of a response
+ *
+ * @param mytarget buffer for the JSON (NUL-terminated by end(), truncated if too small)
+ * @param mytargetSize size of the buffer
+ */
+JsonWriter::JsonWriter(char *mytarget, size_t mytargetSize){
+    target = mytarget;
+    targetSize = mytargetSize;
+    if(targetSize > 0){
+        target[0] = '\0';
+    }
+}
+
+/**
+ * @brief Send the header of the response (chunked transfer encoding, content type application/json)
+ *
+ * @param code HTTP status code
+ */
+void JsonWriter::begin(int code){
+    length = 0;
+    bytesWritten = 0;
+    depth = 0;
+    firstElement = 1;
+    afterKey = false;
+    targetLength = 0;
+    if(server){
+        server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+        server->send(code, "application/json", "");
+    }
+}
+
+/**
+ * @brief Send the remaining JSON and finish the response (or the string in the buffer of the caller)
+ *
+ */
+void JsonWriter::end(){
+    flush();
+    if(server){
+        // empty chunk marks the end of the response
+        server->sendContent("");
+    }
+}
+
+/**
+ * @brief Start a JSON object
+ *
+ */
+void JsonWriter::beginObject(){
+    separator();
+    write('{');
+    if(depth < JSONWRITER_MAX_DEPTH - 1){
+        depth++;
+    }
+    firstElement |= (1 << depth);
+}
+
+/**
+ * @brief Finish a JSON object
+ *
+ */
+void JsonWriter::endObject(){
+    write('}');
+    if(depth > 0){
+        depth--;
+    }
+}
+
+/**
+ * @brief Start a JSON array
+ *
+ */
+void JsonWriter::beginArray(){
+    separator();
+    write('[');
+    if(depth < JSONWRITER_MAX_DEPTH - 1){
+        depth++;
+    }
+    firstElement |= (1 << depth);
+}
+
+/**
+ * @brief Finish a JSON array
+ *
+ */
+void JsonWriter::endArray(){
+    write(']');
+    if(depth > 0){
+        depth--;
+    }
+}
+
+/**
+ * @brief Write the key of the next field in an object
+ *
+ * @param name name of the key
+ */
+void JsonWriter::key(const char *name){
+    separator();
+    writeEscaped(name);
+    write(':');
+    afterKey = true;
+}
+
+/**
+ * @brief Write a string value
+ *
+ * @param str string (escaped if necessary)
+ */
+void JsonWriter::value(const char *str){
+    separator();
+    writeEscaped(str);
+}
+
+/**
+ * @brief Write a boolean value
+ *
+ * @param b value
+ */
+void JsonWriter::value(bool b){
+    separator();
+    write(b ? "true" : "false");
+}
+
+/**
+ * @brief Write a number
+ *
+ * @param number value
+ */
+void JsonWriter::value(int number){
+    value((long)number);
+}
+
+/**
+ * @brief Write a number
+ *
+ * @param number value
+ */
+void JsonWriter::value(unsigned int number){
+    value((unsigned long)number);
+}
+
+/**
+ * @brief Write a number
+ *
+ * @param number value
+ */
+void JsonWriter::value(long number){
+    char str[12];
+    snprintf(str, sizeof(str), "%ld", number);
+    separator();
+    write(str);
+}
+
+/**
+ * @brief Write a number
+ *
+ * @param number value
+ */
+void JsonWriter::value(unsigned long number){
+    char str[12];
+    snprintf(str, sizeof(str), "%lu", number);
+    separator();
+    write(str);
+}
+
+/**
+ * @brief Write an already formatted JSON value (e.g. an object) as next element
+ *
+ * @param json JSON value
+ */
+void JsonWriter::raw(const char *json){
+    separator();
+    write(json);
+}
+
+/**
+ * @brief Get the number of bytes of the JSON written since begin()
+ *
+ * @return uint32_t number of bytes
+ */
+uint32_t JsonWriter::getBytesWritten(){
+    return bytesWritten;
+}
+
+/**
+ * @brief (private) Write a comma if the next element is not the first one of the current object/array
+ *
+ */
+void JsonWriter::separator(){
+    if(afterKey){
+        afterKey = false;
+        return;
+    }
+    if(firstElement & (1 << depth)){
+        firstElement &= ~(1 << depth);
+    }
+    else{
+        write(',');
+    }
+}
+
+/**
+ * @brief (private) Append a character to the buffer, the buffer is sent if it is full
+ *
+ * @param c character
+ */
+void JsonWriter::write(char c){
+    if(length >= sizeof(buffer)){
+        flush();
+    }
+    buffer[length++] = c;
+    bytesWritten++;
+}
+
+/**
+ * @brief (private) Append a string to the buffer
+ *
+ * @param str string
+ */
+void JsonWriter::write(const char *str){
+    while(*str){
+        write(*str++);
+    }
+}
+
+/**
+ * @brief (private) Append a string in quotes with escaped special characters
+ *
+ * @param str string
+ */
+void JsonWriter::writeEscaped(const char *str){
+    write('"');
+    for(; *str; str++){
+        char c = *str;
+        if(c == '"' || c == '\\'){
+            write('\\');
+            write(c);
+        }
+        else if((uint8_t)c < 0x20){
+            char escaped[7];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (uint8_t)c);
+            write(escaped);
+        }
+        else{
+            write(c);
+        }
+    }
+    write('"');
+}
+
+/**
+ * @brief (private) Send the buffer as chunk of the response or append it to the buffer of the caller
+ *
+ */
+void JsonWriter::flush(){
+    if(length == 0){
+        return;
+    }
+    if(server){
+        server->sendContent(buffer, length);
+    }
+    else if(targetLength + 1 < targetSize){
+        size_t n = min(length, targetSize - 1 - targetLength);
+        memcpy(target + targetLength, buffer, n);
+        targetLength += n;
+        target[targetLength] = '\0';
+    }
+    length = 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file jsonwriter.h
+ * @brief Class for writing JSON responses directly into the chunked response of the ESP8266WebServer
+ *
+ * The JSON is collected in a small fixed buffer, which is sent as a chunk whenever it is full,
+ * so the size of the response does not depend on the available heap. Commas between elements
+ * are inserted automatically, strings are escaped.
+ *
+ * Alternatively the JSON is written into a fixed buffer of the caller (e.g. for the event stream),
+ * begin() is not needed then and end() terminates the string.
+ *
+ * Usage:
+ *  JsonWriter json(&server);
+ *  json.begin(200);
+ *  json.beginObject();
+ *  json.field("name", "value");
+ *  json.endObject();
+ *  json.end();
+ *
+ */
+
+#ifndef jsonwriter_h
+#define jsonwriter_h
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+
+#define JSONWRITER_BUFFER_SIZE 256
+#define JSONWRITER_MAX_DEPTH 16
+
+class JsonWriter{
+
+    public:
+        JsonWriter(ESP8266WebServer *myserver);
+        JsonWriter(char *mytarget, size_t mytargetSize);
+        void begin(int code);
+        void end();
+        void beginObject();
+        void endObject();
+        void beginArray();
+        void endArray();
+        void key(const char *name);
+        void value(const char *str);
+        void value(bool b);
+        void value(int number);
+        void value(unsigned int number);
+        void value(long number);
+        void value(unsigned long number);
+        void raw(const char *json);
+        template<typename T> void field(const char *name, T fieldValue){
+            key(name);
+            value(fieldValue);
+        }
+        uint32_t getBytesWritten();
+
+    private:
+        ESP8266WebServer *server = NULL;
+        char *target = NULL;                // buffer of the caller instead of the response (NULL = response)
+        size_t targetSize = 0;
+        size_t targetLength = 0;
+        char buffer[JSONWRITER_BUFFER_SIZE];
+        size_t length = 0;
+        uint32_t bytesWritten = 0;
+        uint16_t firstElement = 1;          // one bit per nesting level: next element is the first one
+        uint8_t depth = 0;
+        bool afterKey = false;
+
+        void separator();
+        void write(char c);
+        void write(const char *str);
+        void writeEscaped(const char *str);
+        void flush();
+};
+
+#endif
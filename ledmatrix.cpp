@@ -11,8 +11,13 @@
 LEDMatrix::LEDMatrix(Adafruit_NeoMatrix *mymatrix, uint8_t mybrightness, UDPLogger *mylogger){
     neomatrix = mymatrix;
     brightness = mybrightness;
+    appliedBrightness = mybrightness;
     logger = mylogger;
     currentLimit = DEFAULT_CURRENT_LIMIT;
+    channelCurrent[0] = DEFAULT_CHANNEL_CURRENT;
+    channelCurrent[1] = DEFAULT_CHANNEL_CURRENT;
+    channelCurrent[2] = DEFAULT_CHANNEL_CURRENT;
+    updateCurrentLUT();
 }
 
 /**
@@ -75,15 +80,63 @@ uint32_t LEDMatrix::Wheel(uint8_t WheelPos)
  */
 uint32_t LEDMatrix::interpolateColor24bit(uint32_t color1, uint32_t color2, float factor)
 {
-    uint8_t resultRed = color1 >> 16 & 0xff;
-    uint8_t resultGreen = color1 >> 8 & 0xff;
-    uint8_t resultBlue = color1 & 0xff;
-    resultRed = (uint8_t)(resultRed + (int16_t)(factor * ((int16_t)(color2 >> 16 & 0xff) - (int16_t)resultRed)));
-    resultGreen = (uint8_t)(resultGreen + (int16_t)(factor * ((int16_t)(color2 >> 8 & 0xff) - (int16_t)resultGreen)));
-    resultBlue = (uint8_t)(resultBlue + (int16_t)(factor * ((int16_t)(color2 & 0xff) - (int16_t)resultBlue)));
+    return interpolateColor24bitQ8(color1, color2, factorToQ8(factor));
+}
+
+/**
+ * @brief Interpolates two colors24bit with a fixed-point factor (no float operations)
+ * 
+ * Each channel is interpolated with integer arithmetic and truncated towards zero,
+ * so the result stays within one LSB of the float implementation.
+ * 
+ * @param color1 startcolor for interpolation
+ * @param color2 endcolor for interpolation
+ * @param factorQ8 factor in Q8 format (0 = color1, BLEND_FACTOR_ONE = color2)
+ * @return uint32_t interpolated color
+ */
+uint32_t LEDMatrix::interpolateColor24bitQ8(uint32_t color1, uint32_t color2, uint16_t factorQ8)
+{
+    if(color1 == color2){
+      return color1;
+    }
+    uint8_t resultRed = interpolateChannelQ8(color1 >> 16 & 0xff, color2 >> 16 & 0xff, factorQ8);
+    uint8_t resultGreen = interpolateChannelQ8(color1 >> 8 & 0xff, color2 >> 8 & 0xff, factorQ8);
+    uint8_t resultBlue = interpolateChannelQ8(color1 & 0xff, color2 & 0xff, factorQ8);
     return Color24bit(resultRed, resultGreen, resultBlue);
 }
 
+/**
+ * @brief Interpolates a single 8bit color channel with a fixed-point factor
+ * 
+ * @param start start value of the channel
+ * @param end end value of the channel
+ * @param factorQ8 factor in Q8 format (0 = start, BLEND_FACTOR_ONE = end)
+ * @return uint8_t interpolated value
+ */
+uint8_t LEDMatrix::interpolateChannelQ8(uint8_t start, uint8_t end, uint16_t factorQ8)
+{
+    int32_t diff = (int16_t)end - (int16_t)start;
+    // division (instead of shift) truncates towards zero like the cast of the float product
+    return (uint8_t)(start + (int16_t)(diff * factorQ8 / BLEND_FACTOR_ONE));
+}
+
+/**
+ * @brief Convert a float factor (0.0 - 1.0) to Q8 fixed-point format
+ * 
+ * @param factor factor between 0 and 1
+ * @return uint16_t factor in Q8 format (0 - BLEND_FACTOR_ONE)
+ */
+uint16_t LEDMatrix::factorToQ8(float factor)
+{
+    if(factor <= 0.0){
+      return 0;
+    }
+    if(factor >= 1.0){
+      return BLEND_FACTOR_ONE;
+    }
+    return (uint16_t)(factor * BLEND_FACTOR_ONE + 0.5);
+}
+
 /**
  * @brief Setup function for LED matrix
  * 
@@ -93,6 +146,8 @@ void LEDMatrix::setupMatrix()
     (*neomatrix).begin();       
     (*neomatrix).setTextWrap(false);
     (*neomatrix).setBrightness(brightness);
+    appliedBrightness = brightness;
+    forceRefresh = true;
     randomSeed(analogRead(0));
 }
 
@@ -114,17 +169,11 @@ void LEDMatrix::setMinIndicator(uint8_t pattern, uint32_t color)
   //  2 -> 0010
   //  1 -> 0001
   //  0 -> 0000
-  if(pattern & 1){
-    targetindicators[0] = color;
-  }
-  if(pattern >> 1 & 1){
-    targetindicators[1] = color;
-  }
-  if(pattern >> 2 & 1){
-    targetindicators[2] = color;
-  }
-  if(pattern >> 3 & 1){
-    targetindicators[3] = color;
+  for(uint8_t i = 0; i < 4; i++){
+    if((pattern >> i & 1) && targetindicators[i] != color){
+      targetindicators[i] = color;
+      dirtyRows |= 1 << HEIGHT;
+    }
   }
 }
 
@@ -142,7 +191,10 @@ void LEDMatrix::gridAddPixel(uint8_t x, uint8_t y, uint32_t color)
   }
   // limit ranges of x and y
   if(x < WIDTH && y < HEIGHT){
-    targetgrid[y][x] = color;
+    if(targetgrid[y][x] != color){
+      targetgrid[y][x] = color;
+      dirtyRows |= 1 << y;
+    }
   }
   else{
     //logger->logString("Index out of Range: " + String(x) + ", " + String(y));
@@ -158,14 +210,101 @@ void LEDMatrix::gridFlush(void)
     // set a zero to each pixel
     for(uint8_t i=0; i<HEIGHT; i++){
         for(uint8_t j=0; j<WIDTH; j++){
-            targetgrid[i][j] = 0;
+            if(targetgrid[i][j] != 0){
+                targetgrid[i][j] = 0;
+                dirtyRows |= 1 << i;
+            }
         }
     }
     // set every minutes indicator led to 0
-    targetindicators[0] = 0;
-    targetindicators[1] = 0;
-    targetindicators[2] = 0;
-    targetindicators[3] = 0;
+    for(uint8_t i=0; i<4; i++){
+        if(targetindicators[i] != 0){
+            targetindicators[i] = 0;
+            dirtyRows |= 1 << HEIGHT;
+        }
+    }
+}
+
+/**
+ * @brief Get the active pixels of the targetgrid as bitmask (bit index = x + y * WIDTH)
+ * 
+ * @param mask bitmask to be filled, needs GRID_MASK_BYTES bytes
+ */
+void LEDMatrix::gridGetMask(uint8_t *mask)
+{
+    memset(mask, 0, GRID_MASK_BYTES);
+    for(uint8_t i=0; i<HEIGHT; i++){
+        for(uint8_t j=0; j<WIDTH; j++){
+            if(targetgrid[i][j] != 0){
+                uint8_t index = i * WIDTH + j;
+                mask[index / 8] |= 1 << (index % 8);
+            }
+        }
+    }
+}
+
+/**
+ * @brief "Activates" all pixels of the given bitmask in targetgrid with color
+ * 
+ * @param mask bitmask of pixels (bit index = x + y * WIDTH), GRID_MASK_BYTES bytes
+ * @param color color of pixels
+ */
+void LEDMatrix::gridAddMask(const uint8_t *mask, uint32_t color)
+{
+    for(uint8_t b=0; b<GRID_MASK_BYTES; b++){
+        // skip empty bytes, most of the pixels are off
+        if(mask[b] == 0){
+            continue;
+        }
+        for(uint8_t k=0; k<8; k++){
+            if(mask[b] >> k & 1){
+                uint8_t index = b * 8 + k;
+                gridAddPixel(index % WIDTH, index / WIDTH, color);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Set consecutive pixels of targetgrid from raw RGB data (without dynamic color shift)
+ * 
+ * @param firstPixel index of first pixel (index = x + y * WIDTH)
+ * @param rgb pixel data, 3 bytes (red, green, blue) per pixel
+ * @param count number of pixels, pixels outside of the grid are ignored
+ */
+void LEDMatrix::gridSetPixelsRGB(uint16_t firstPixel, const uint8_t *rgb, uint16_t count)
+{
+    if(firstPixel >= WIDTH * HEIGHT){
+        return;
+    }
+    if(count > WIDTH * HEIGHT - firstPixel){
+        count = WIDTH * HEIGHT - firstPixel;
+    }
+    for(uint16_t i=firstPixel; i<firstPixel+count; i++, rgb += 3){
+        uint32_t color = Color24bit(rgb[0], rgb[1], rgb[2]);
+        uint8_t y = i / WIDTH;
+        uint8_t x = i % WIDTH;
+        if(targetgrid[y][x] != color){
+            targetgrid[y][x] = color;
+            dirtyRows |= 1 << y;
+        }
+    }
+}
+
+/**
+ * @brief Get the pattern of active minute indicator leds (binary encoded, see setMinIndicator)
+ * 
+ * @return uint8_t pattern of the minute indicator
+ */
+uint8_t LEDMatrix::getMinIndicatorPattern()
+{
+    uint8_t pattern = 0;
+    for(uint8_t i=0; i<4; i++){
+        if(targetindicators[i] != 0){
+            pattern |= 1 << i;
+        }
+    }
+    return pattern;
 }
 
 /**
@@ -173,7 +312,7 @@ void LEDMatrix::gridFlush(void)
  * 
  */
 void LEDMatrix::drawOnMatrixInstant(){
-  drawOnMatrix(1.0);
+  drawOnMatrix(BLEND_FACTOR_ONE);
 }
 
 /**
@@ -182,42 +321,167 @@ void LEDMatrix::drawOnMatrixInstant(){
  * @param factor factor between 0 and 1 (1.0 = hard, 0.1 = smooth)
  */
 void LEDMatrix::drawOnMatrixSmooth(float factor){
-  drawOnMatrix(factor);
+  // convert once per frame, the blending itself runs on integers only
+  drawOnMatrix(factorToQ8(factor));
 }
 
 /**
  * @brief Draws the targetgrid to the ledmatrix
  * 
- * @param factor factor between 0 and 1 (1.0 = hard, 0.1 = smooth)
+ * Only rows which are marked as dirty are blended. A row stays dirty as long as the
+ * blending changes at least one of its pixels. If no pixel changed, the call to show()
+ * is skipped, as it disables the interrupts for several milliseconds.
+ * 
+ * @param factorQ8 factor in Q8 format (BLEND_FACTOR_ONE = hard, 26 = smooth)
  */
-void LEDMatrix::drawOnMatrix(float factor){
-  uint16_t totalCurrent = 0;
-  // loop over all leds in matrix
-  for(int s = 0; s < WIDTH; s++){
-    for(int z = 0; z < HEIGHT; z++){
+void LEDMatrix::drawOnMatrix(uint16_t factorQ8){
+  unsigned long frameStart = micros();
+  bool refresh = forceRefresh;
+  if(refresh){
+    dirtyRows = ALL_ROWS_DIRTY;
+  }
+  if(dirtyRows == 0){
+    framesSkipped++;
+    updateFrameTime(micros() - frameStart);
+    return;
+  }
+
+  bool changed = false;
+  // loop over all dirty rows of the matrix
+  for(int z = 0; z < HEIGHT; z++){
+    if(!(dirtyRows >> z & 1)){
+      continue;
+    }
+    bool rowChanged = false;
+    for(int s = 0; s < WIDTH; s++){
       // inplement momentum as smooth transistion function
-      uint32_t filteredColor = interpolateColor24bit(currentgrid[z][s], targetgrid[z][s], factor);
-      (*neomatrix).drawPixel(s, z, color24to16bit(filteredColor)); 
-      currentgrid[z][s] = filteredColor;
-      totalCurrent += calcEstimatedLEDCurrent(filteredColor);
-    } 
+      uint32_t filteredColor = interpolateColor24bitQ8(currentgrid[z][s], targetgrid[z][s], factorQ8);
+      if(filteredColor != currentgrid[z][s]){
+        rowChanged = true;
+        totalCurrent += calcEstimatedLEDCurrent(filteredColor) - calcEstimatedLEDCurrent(currentgrid[z][s]);
+        currentgrid[z][s] = filteredColor;
+        (*neomatrix).drawPixel(s, z, color24to16bit(filteredColor));
+      }
+      else if(refresh){
+        (*neomatrix).drawPixel(s, z, color24to16bit(filteredColor));
+      }
+    }
+    if(!rowChanged){
+      dirtyRows &= ~(1 << z);
+    }
+    changed |= rowChanged;
   }
 
   // loop over all minute indicator leds
-  for(int i = 0; i < 4; i++){
-    uint32_t filteredColor = interpolateColor24bit(currentindicators[i], targetindicators[i], factor);
-    (*neomatrix).drawPixel(WIDTH - (1+i), HEIGHT, color24to16bit(filteredColor));
-    currentindicators[i] = filteredColor;
-    totalCurrent += calcEstimatedLEDCurrent(filteredColor);
+  if(dirtyRows >> HEIGHT & 1){
+    bool rowChanged = false;
+    for(int i = 0; i < 4; i++){
+      uint32_t filteredColor = interpolateColor24bitQ8(currentindicators[i], targetindicators[i], factorQ8);
+      if(filteredColor != currentindicators[i]){
+        rowChanged = true;
+        totalCurrent += calcEstimatedLEDCurrent(filteredColor) - calcEstimatedLEDCurrent(currentindicators[i]);
+        currentindicators[i] = filteredColor;
+        (*neomatrix).drawPixel(WIDTH - (1+i), HEIGHT, color24to16bit(filteredColor));
+      }
+      else if(refresh){
+        (*neomatrix).drawPixel(WIDTH - (1+i), HEIGHT, color24to16bit(filteredColor));
+      }
+    }
+    if(!rowChanged){
+      dirtyRows &= ~(1 << HEIGHT);
+    }
+    changed |= rowChanged;
   }
 
   // Check if totalCurrent reaches CURRENTLIMIT -> if yes reduce brightness
-  if(totalCurrent > currentLimit){
-    uint8_t newBrightness = brightness * float(currentLimit)/float(totalCurrent);
+  uint8_t newBrightness = brightness;
+  uint32_t limit = (uint32_t)currentLimit * CURRENT_UNITS_PER_MA;
+  if(totalCurrent > limit){
+    newBrightness = (uint32_t)brightness * limit / totalCurrent;
     //logger->logString("CurrentLimit reached!!!: " + String(totalCurrent) + ", new: " + String(newBrightness));
+  }
+  bool brightnessChanged = (newBrightness != appliedBrightness);
+  if(brightnessChanged){
     (*neomatrix).setBrightness(newBrightness);
+    appliedBrightness = newBrightness;
+  }
+
+  forceRefresh = false;
+  if(changed || refresh || brightnessChanged){
+    (*neomatrix).show();
+    framesShown++;
+  }
+  else{
+    framesSkipped++;
+  }
+  // setBrightness() of the neomatrix rescales the pixel buffer lossy -> rewrite all pixels with next frame
+  if(brightnessChanged){
+    forceRefresh = true;
+  }
+  updateFrameTime(micros() - frameStart);
+}
+
+/**
+ * @brief (private) Update the frame time statistics
+ * 
+ * @param frameTime duration of the last frame in microseconds
+ */
+void LEDMatrix::updateFrameTime(uint32_t frameTime){
+  lastFrameTime = frameTime;
+  if(frameTime > maxFrameTime){
+    maxFrameTime = frameTime;
   }
-  (*neomatrix).show();
+}
+
+/**
+ * @brief Force a rewrite of all pixels with the next frame
+ * 
+ * Needs to be called after the neomatrix was modified directly (e.g. LED test),
+ * otherwise unchanged rows would not be written to the leds again.
+ */
+void LEDMatrix::forceRedraw(){
+  forceRefresh = true;
+}
+
+/**
+ * @brief Get the number of frames which were written to the leds (calls of show())
+ * 
+ * @return uint32_t number of frames
+ */
+uint32_t LEDMatrix::getFramesShown(){
+  return framesShown;
+}
+
+/**
+ * @brief Get the number of frames which were skipped as nothing changed
+ * 
+ * @return uint32_t number of frames
+ */
+uint32_t LEDMatrix::getFramesSkipped(){
+  return framesSkipped;
+}
+
+/**
+ * @brief Get the duration of the last frame (blending, current estimation and show())
+ * 
+ * @return uint32_t duration in microseconds
+ */
+uint32_t LEDMatrix::getLastFrameTime(){
+  return lastFrameTime;
+}
+
+/**
+ * @brief Get the longest frame duration since the last reset
+ * 
+ * @param reset if true, the maximum is reset afterwards
+ * @return uint32_t duration in microseconds
+ */
+uint32_t LEDMatrix::getMaxFrameTime(bool reset){
+  uint32_t result = maxFrameTime;
+  if(reset){
+    maxFrameTime = 0;
+  }
+  return result;
 }
 
 /**
@@ -272,29 +536,72 @@ void LEDMatrix::printChar(uint8_t xpos, uint8_t ypos, char character, uint32_t c
  * @param mybrightness brightness to be set [0..255]
  */
 void LEDMatrix::setBrightness(uint8_t mybrightness){
+  if(mybrightness == brightness){
+    return;
+  }
   brightness = mybrightness;
   (*neomatrix).setBrightness(brightness);
+  appliedBrightness = brightness;
+  updateCurrentLUT();
+  forceRefresh = true;
 }
 
 /**
- * @brief Calc estimated current (mA) for one pixel with the given color and brightness
+ * @brief Calc estimated current for one pixel with the given color and brightness
  * 
  * @param color 24bit color value of the pixel for which the current should be calculated
- * @return the current in mA
- */
-uint16_t LEDMatrix::calcEstimatedLEDCurrent(uint32_t color){
-  // extract rgb values
-  uint8_t red = color >> 16 & 0xff;
-  uint8_t green = color >> 8 & 0xff;
-  uint8_t blue = color & 0xff;
-  
-  // Linear estimation: 20mA for full brightness per LED 
-  // (calculation avoids float numbers)
-  uint32_t estimatedCurrent = (20 * red) + (20 * green) + (20 * blue);
-  estimatedCurrent /= 255;
-  estimatedCurrent = (estimatedCurrent * brightness)/255;
-
-  return estimatedCurrent;
+ * @return the current in 1/CURRENT_UNITS_PER_MA mA
+ */
+uint32_t LEDMatrix::calcEstimatedLEDCurrent(uint32_t color){
+  return currentLUT[0][color >> 16 & 0xff] + currentLUT[1][color >> 8 & 0xff] + currentLUT[2][color & 0xff];
+}
+
+/**
+ * @brief Recalc the current lookup table for the actual brightness and the estimated total current
+ * 
+ * Linear estimation per channel: channelCurrent (mA) for full value at full brightness.
+ */
+void LEDMatrix::updateCurrentLUT(){
+  for(uint8_t c = 0; c < 3; c++){
+    // 16.16 fixed-point current per channel step, avoids a division per table entry
+    uint32_t step = ((uint64_t)channelCurrent[c] * CURRENT_UNITS_PER_MA * brightness << 16) / (255UL * 255UL);
+    for(uint16_t v = 0; v < 256; v++){
+      currentLUT[c][v] = (v * step) >> 16;
+    }
+  }
+
+  totalCurrent = 0;
+  for(uint8_t z = 0; z < HEIGHT; z++){
+    for(uint8_t s = 0; s < WIDTH; s++){
+      totalCurrent += calcEstimatedLEDCurrent(currentgrid[z][s]);
+    }
+  }
+  for(uint8_t i = 0; i < 4; i++){
+    totalCurrent += calcEstimatedLEDCurrent(currentindicators[i]);
+  }
+}
+
+/**
+ * @brief Get the estimated current of all leds
+ * 
+ * @return uint16_t the current in mA
+ */
+uint16_t LEDMatrix::getEstimatedCurrent(){
+  return totalCurrent / CURRENT_UNITS_PER_MA;
+}
+
+/**
+ * @brief Set the current model of the leds (WS2812 channels differ in current draw)
+ * 
+ * @param red current (mA) of the red channel at full value
+ * @param green current (mA) of the green channel at full value
+ * @param blue current (mA) of the blue channel at full value
+ */
+void LEDMatrix::setCurrentModel(uint8_t red, uint8_t green, uint8_t blue){
+  channelCurrent[0] = red;
+  channelCurrent[1] = green;
+  channelCurrent[2] = blue;
+  updateCurrentLUT();
 }
 
 /**
@@ -13,6 +13,20 @@
 
 #define DEFAULT_CURRENT_LIMIT 9999
 
+// default current (mA) of one color channel of a led at full value
+#define DEFAULT_CHANNEL_CURRENT 20
+// resolution of the current estimation (1/100 mA)
+#define CURRENT_UNITS_PER_MA 100
+
+// bitmask with all rows of the matrix and the minute indicator row set
+#define ALL_ROWS_DIRTY ((1 << (HEIGHT + 1)) - 1)
+
+// number of bytes of a bitmask with one bit per pixel of the matrix (without minute indicators)
+#define GRID_MASK_BYTES ((WIDTH * HEIGHT + 7) / 8)
+
+// blend factor 1.0 in Q8 fixed-point representation (factor * 256)
+#define BLEND_FACTOR_ONE 256
+
 class LEDMatrix{
     public:
         LEDMatrix(Adafruit_NeoMatrix *mymatrix, uint8_t mybrightness, UDPLogger *mylogger);
@@ -20,16 +34,28 @@ class LEDMatrix{
         static uint16_t color24to16bit(uint32_t color24bit);
         static uint32_t Wheel(uint8_t WheelPos);
         static uint32_t interpolateColor24bit(uint32_t color1, uint32_t color2, float factor);
+        static uint32_t interpolateColor24bitQ8(uint32_t color1, uint32_t color2, uint16_t factorQ8);
         void setupMatrix();
         void setMinIndicator(uint8_t pattern, uint32_t color);
         void gridAddPixel(uint8_t x, uint8_t y, uint32_t color);
         void gridFlush(void);
+        void gridGetMask(uint8_t *mask);
+        void gridAddMask(const uint8_t *mask, uint32_t color);
+        void gridSetPixelsRGB(uint16_t firstPixel, const uint8_t *rgb, uint16_t count);
+        uint8_t getMinIndicatorPattern();
         void drawOnMatrixInstant();
         void drawOnMatrixSmooth(float factor);
+        void forceRedraw();
+        uint32_t getFramesShown();
+        uint32_t getFramesSkipped();
+        uint32_t getLastFrameTime();
+        uint32_t getMaxFrameTime(bool reset);
         void printNumber(uint8_t xpos, uint8_t ypos, uint8_t number, uint32_t color);
         void printChar(uint8_t xpos, uint8_t ypos, char character, uint32_t color);
         void setBrightness(uint8_t mybrightness);
         void setCurrentLimit(uint16_t mycurrentLimit);
+        void setCurrentModel(uint8_t red, uint8_t green, uint8_t blue);
+        uint16_t getEstimatedCurrent();
         void setDynamicColorShiftPhase(int16_t phase);
 
     private:
@@ -38,6 +64,7 @@ class LEDMatrix{
         UDPLogger *logger;
 
         uint8_t brightness;
+        uint8_t appliedBrightness;
         uint16_t currentLimit;
         int16_t dynamicColorShiftActivePhase = -1; // -1: not active, 0-255: active phase shift
 
@@ -53,8 +80,35 @@ class LEDMatrix{
         // current representation of minutes indicator leds
         uint32_t currentindicators[4] = {0, 0, 0, 0};
 
-        void drawOnMatrix(float factor);
-        uint16_t calcEstimatedLEDCurrent(uint32_t color);
+        // bitmask of rows which need to be blended (bit HEIGHT = minute indicators)
+        uint16_t dirtyRows = ALL_ROWS_DIRTY;
+
+        // if true, all pixels are written to the leds with the next frame
+        bool forceRefresh = true;
+
+        // current per channel (mA) at full value and full brightness (r, g, b)
+        uint8_t channelCurrent[3];
+
+        // estimated current per channel value at actual brightness (1/CURRENT_UNITS_PER_MA mA)
+        uint16_t currentLUT[3][256];
+
+        // estimated current of all leds (1/CURRENT_UNITS_PER_MA mA), updated with every changed pixel
+        uint32_t totalCurrent = 0;
+
+        // statistics of written and skipped frames
+        uint32_t framesShown = 0;
+        uint32_t framesSkipped = 0;
+
+        // duration of frames in microseconds
+        uint32_t lastFrameTime = 0;
+        uint32_t maxFrameTime = 0;
+
+        void drawOnMatrix(uint16_t factorQ8);
+        static uint8_t interpolateChannelQ8(uint8_t start, uint8_t end, uint16_t factorQ8);
+        static uint16_t factorToQ8(float factor);
+        uint32_t calcEstimatedLEDCurrent(uint32_t color);
+        void updateCurrentLUT();
+        void updateFrameTime(uint32_t frameTime);
 
 
 };
@@ -0,0 +1,171 @@
+#include "ledstream.h"
+
+/**
+ * @brief Construct a new LEDStream object
+ *
+ * @param mymatrix pointer to LEDMatrix object, which receives the pixels
+ */
+LEDStream::LEDStream(LEDMatrix *mymatrix){
+    ledmatrix = mymatrix;
+}
+
+/**
+ * @brief Start listening for frames
+ *
+ * @param port UDP port
+ */
+void LEDStream::begin(uint16_t port){
+    udp.begin(port);
+    running = true;
+    intervalStart = millis();
+}
+
+/**
+ * @brief Stop listening for frames
+ *
+ */
+void LEDStream::stop(){
+    udp.stop();
+    running = false;
+}
+
+/**
+ * @brief Process all received packets (non-blocking), needs to be called in every loop cycle
+ *
+ * @return true if a complete frame was written into the targetgrid (needs to be drawn on the matrix)
+ */
+bool LEDStream::handle(){
+    if(!running){
+        return false;
+    }
+
+    bool frameComplete = false;
+    int size = udp.parsePacket();
+    while(size > 0){
+        // oversized packets are truncated to the pixels of the matrix
+        int length = udp.read(packetBuffer, sizeof(packetBuffer));
+        udp.flush();
+        if(length > 0 && processPacket(length)){
+            frameComplete = true;
+        }
+        size = udp.parsePacket();
+    }
+
+    if(frameComplete){
+        framesReceived++;
+        framesInInterval++;
+    }
+
+    // update frame rate once per second
+    if(millis() - intervalStart >= 1000){
+        framesPerSecond = framesInInterval;
+        framesInInterval = 0;
+        intervalStart = millis();
+    }
+
+    return frameComplete;
+}
+
+/**
+ * @brief Get number of complete frames received since start
+ *
+ * @return uint32_t number of frames
+ */
+uint32_t LEDStream::getFramesReceived(){
+    return framesReceived;
+}
+
+/**
+ * @brief Get number of packets dropped because they were out of order or duplicated
+ *
+ * @return uint32_t number of packets
+ */
+uint32_t LEDStream::getPacketsDropped(){
+    return packetsDropped;
+}
+
+/**
+ * @brief Get number of packets ignored because of an invalid or unsupported header
+ *
+ * @return uint32_t number of packets
+ */
+uint32_t LEDStream::getPacketsInvalid(){
+    return packetsInvalid;
+}
+
+/**
+ * @brief Get frame rate of the last second
+ *
+ * @return uint16_t frames per second
+ */
+uint16_t LEDStream::getFramesPerSecond(){
+    return framesPerSecond;
+}
+
+/**
+ * @brief (private) Check the sequence number of a packet, packets which are older than
+ * or equal to the last accepted packet are rejected
+ *
+ * @param sequence sequence number of packet (0 = not used, 1-15)
+ * @return true if packet should be processed
+ */
+bool LEDStream::acceptSequence(uint8_t sequence){
+    // resync after the stream was paused (e.g. new sender)
+    if(millis() - lastPacketTime > LEDSTREAM_RESYNC_TIMEOUT){
+        lastSequence = 0;
+    }
+    lastPacketTime = millis();
+
+    if(sequence == 0 || lastSequence == 0){
+        lastSequence = sequence;
+        return true;
+    }
+    // distance on the ring of sequence numbers 1-15
+    uint8_t distance = (sequence + 15 - lastSequence) % 15;
+    if(distance == 0 || distance > LEDSTREAM_SEQUENCE_WINDOW){
+        return false;
+    }
+    lastSequence = sequence;
+    return true;
+}
+
+/**
+ * @brief (private) Write the pixels of a packet in packetBuffer into the targetgrid
+ *
+ * @param size size of the packet in packetBuffer
+ * @return true if the packet completes a frame (push flag)
+ */
+bool LEDStream::processPacket(uint16_t size){
+    uint8_t flags = packetBuffer[0];
+    uint8_t headerLength = (flags & DDP_FLAGS_TIMECODE) ? DDP_HEADER_LEN_TIMECODE : DDP_HEADER_LEN;
+    uint8_t dataType = packetBuffer[2];
+    uint8_t destination = packetBuffer[3];
+
+    // only version 1 data packets for the display are supported (no queries, replies or storage)
+    if(size < headerLength || (flags & DDP_FLAGS_VERSION_MASK) != DDP_FLAGS_VERSION_1
+        || (flags & (DDP_FLAGS_QUERY | DDP_FLAGS_REPLY | DDP_FLAGS_STORAGE))
+        || (dataType != DDP_TYPE_RGB8 && dataType != DDP_TYPE_UNDEFINED)
+        || (destination != DDP_ID_DISPLAY && destination != 0)){
+        packetsInvalid++;
+        return false;
+    }
+
+    if(!acceptSequence(packetBuffer[1] & DDP_SEQUENCE_MASK)){
+        packetsDropped++;
+        return false;
+    }
+
+    uint32_t offset = ((uint32_t)packetBuffer[4] << 24) | ((uint32_t)packetBuffer[5] << 16)
+                        | ((uint32_t)packetBuffer[6] << 8) | packetBuffer[7];
+    uint16_t length = ((uint16_t)packetBuffer[8] << 8) | packetBuffer[9];
+    if(length > size - headerLength){
+        length = size - headerLength;
+    }
+
+    // only complete pixels starting at a pixel boundary are used
+    if(offset % 3 == 0 && offset / 3 < WIDTH * HEIGHT){
+        ledmatrix->gridSetPixelsRGB(offset / 3, packetBuffer + headerLength, length / 3);
+    }
+
+    return flags & DDP_FLAGS_PUSH;
+}
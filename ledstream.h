@@ -0,0 +1,78 @@
+/**
+ * @file ledstream.h
+ * @brief Class for receiving raw RGB frames via UDP (DDP protocol) for real-time control of the LEDs
+ *
+ * Packet format (Distributed Display Protocol, http://www.3waylabs.com/ddp/), all values big endian:
+ *  byte 0:    flags (version 1 = 0x40, push = 0x01, timecode = 0x10)
+ *  byte 1:    sequence number (lower 4 bits, 1-15, 0 = not used)
+ *  byte 2:    data type (0x0B = RGB 8bit, 0x00 = undefined/RGB)
+ *  byte 3:    destination id (1 = display)
+ *  byte 4-7:  offset of the data in bytes (pixel index * 3)
+ *  byte 8-9:  length of the data in bytes
+ *  (byte 10-13: timecode, only if timecode flag is set)
+ *  followed by the pixel data (red, green, blue), pixel index = x + y * WIDTH
+ *
+ * The pixels are written into the targetgrid of the LEDMatrix, a frame is complete
+ * when a packet with push flag is received.
+ *
+ */
+
+#ifndef ledstream_h
+#define ledstream_h
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include "ledmatrix.h"
+
+#define LEDSTREAM_PORT 4048             // default DDP port
+
+#define DDP_HEADER_LEN 10
+#define DDP_HEADER_LEN_TIMECODE 14
+#define DDP_FLAGS_VERSION_MASK 0xC0
+#define DDP_FLAGS_VERSION_1 0x40
+#define DDP_FLAGS_TIMECODE 0x10
+#define DDP_FLAGS_STORAGE 0x08
+#define DDP_FLAGS_REPLY 0x04
+#define DDP_FLAGS_QUERY 0x02
+#define DDP_FLAGS_PUSH 0x01
+#define DDP_SEQUENCE_MASK 0x0F
+#define DDP_TYPE_UNDEFINED 0x00
+#define DDP_TYPE_RGB8 0x0B
+#define DDP_ID_DISPLAY 1
+
+#define LEDSTREAM_SEQUENCE_WINDOW 7     // packets with sequence number up to this distance ahead are accepted
+#define LEDSTREAM_RESYNC_TIMEOUT 1000   // after this time (ms) without packets any sequence number is accepted
+
+class LEDStream{
+
+    public:
+        LEDStream(LEDMatrix *mymatrix);
+        void begin(uint16_t port);
+        void stop();
+        bool handle();
+        uint32_t getFramesReceived();
+        uint32_t getPacketsDropped();
+        uint32_t getPacketsInvalid();
+        uint16_t getFramesPerSecond();
+
+    private:
+        LEDMatrix *ledmatrix;
+        WiFiUDP udp;
+        bool running = false;
+
+        uint8_t packetBuffer[DDP_HEADER_LEN_TIMECODE + WIDTH * HEIGHT * 3];
+        uint8_t lastSequence = 0;               // 0 = no packet with sequence number received yet
+        unsigned long lastPacketTime = 0;
+
+        uint32_t framesReceived = 0;
+        uint32_t packetsDropped = 0;            // out of order or duplicate packets
+        uint32_t packetsInvalid = 0;            // packets with unsupported header
+        uint16_t framesInInterval = 0;
+        uint16_t framesPerSecond = 0;
+        unsigned long intervalStart = 0;
+
+        bool acceptSequence(uint8_t sequence);
+        bool processPacket(uint16_t size);
+};
+
+#endif
@@ -0,0 +1,72 @@
+import argparse
+import colorsys
+import socket
+import struct
+import time
+
+# size of the led matrix of the wordclock
+WIDTH = 11
+HEIGHT = 11
+
+DDP_PORT = 4048
+DDP_FLAGS_VERSION_1 = 0x40
+DDP_FLAGS_PUSH = 0x01
+DDP_TYPE_RGB8 = 0x0B
+DDP_ID_DISPLAY = 1
+
+
+def ddp_packet(sequence, pixels):
+    """Build a DDP packet with push flag from a list of (r, g, b) tuples (index = x + y * WIDTH)."""
+    data = bytes(channel for pixel in pixels for channel in pixel)
+    header = struct.pack('>BBBBIH', DDP_FLAGS_VERSION_1 | DDP_FLAGS_PUSH, sequence, DDP_TYPE_RGB8,
+                         DDP_ID_DISPLAY, 0, len(data))
+    return header + data
+
+
+def rainbow(frame):
+    """Test pattern: diagonal rainbow moving with each frame."""
+    pixels = []
+    for y in range(HEIGHT):
+        for x in range(WIDTH):
+            hue = ((x + y) / (WIDTH + HEIGHT) + frame / 120) % 1.0
+            r, g, b = colorsys.hsv_to_rgb(hue, 1.0, 1.0)
+            pixels.append((int(r * 255), int(g * 255), int(b * 255)))
+    return pixels
+
+
+def start(host, port, fps, duration):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    period = 1.0 / fps
+    frame = 0
+    start_time = time.monotonic()
+    next_time = start_time
+
+    print(f"Sending {fps} fps to {host}:{port}")
+    while duration <= 0 or time.monotonic() - start_time < duration:
+        # sequence numbers 1-15 (0 = not used)
+        sequence = frame % 15 + 1
+        sock.sendto(ddp_packet(sequence, rainbow(frame)), (host, port))
+        frame += 1
+
+        next_time += period
+        delay = next_time - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+        else:
+            # sender too slow, do not try to catch up
+            next_time = time.monotonic()
+
+    elapsed = time.monotonic() - start_time
+    print(f"Sent {frame} frames in {elapsed:.1f} s ({frame / elapsed:.1f} fps)")
+
+
+# Main
+if __name__ == '__main__':
+    # Usage: python3 ledstream_sender.py <ip of wordclock> [--fps 60] [--duration 10]
+    parser = argparse.ArgumentParser(description='Stream a test pattern to the wordclock via UDP (DDP protocol)')
+    parser.add_argument('host', help='ip address of the wordclock')
+    parser.add_argument('--port', type=int, default=DDP_PORT)
+    parser.add_argument('--fps', type=float, default=60)
+    parser.add_argument('--duration', type=float, default=0, help='duration in seconds (0 = endless)')
+    args = parser.parse_args()
+    start(args.host, args.port, args.fps, args.duration)
@@ -5,15 +5,13 @@
  * 
  * @param udp   UDP client
  * @param poolServerName    time server name
- * @param utcx  UTC offset (in 1h)
- * @param _swChange should summer/winter time be considered
+ * @param timezone  POSIX TZ string with UTC offset and daylight saving time rule (e.g. "CET-1CEST,M3.5.0,M10.5.0/3")
  */
-NTPClientPlus::NTPClientPlus(UDP &udp, const char *poolServerName, int utcx, bool _swChange)
+NTPClientPlus::NTPClientPlus(UDP &udp, const char *poolServerName, const char *timezone)
 {
     this->_udp = &udp;
-    this->_utcx = utcx;
     this->_poolServerName = poolServerName;
-    this->_swChange = _swChange;
+    this->_timezone.parse(timezone);
 }
 
 /**
@@ -29,34 +27,160 @@ void NTPClientPlus::setupNTPClient()
 }
 
 /**
- * @brief Get new update from NTP
+ * @brief Get new update from NTP (blocking, waits for the answer of the server)
  * 
  * @return 0     after successful update
  * @return -1    timeout after 1000 ms
  * @return 1     too much difference to previous received time (try again)
+ * @return 2     NTP time not valid
  */
 int NTPClientPlus::updateNTP()
 {
+    this->beginUpdate();
+
+    int res = this->poll();
+    while (res == NTP_UPDATE_PENDING)
+    {
+        delay(10);
+        res = this->poll();
+    }
+    return res;
+}
+
+/**
+ * @brief Send a request to the NTP server without waiting for the answer, 
+ * the answer needs to be collected by calling poll() regularly
+ * 
+ * @return true     request sent
+ * @return false    a request is already pending
+ */
+bool NTPClientPlus::beginUpdate()
+{
+    if (this->_updatePending)
+    {
+        return false;
+    }
 
     // flush any existing packets
     while (this->_udp->parsePacket() != 0)
         this->_udp->flush();
 
     this->sendNTPPacket();
+    this->_requestSent = millis();
+    this->_updatePending = true;
+    return true;
+}
 
-    // Wait till data is there or timeout...
-    byte timeout = 0;
-    int cb = 0;
-    do
+/**
+ * @brief Check for the answer of a pending request (non-blocking)
+ * 
+ * @return NTP_UPDATE_PENDING   still waiting for the answer
+ * @return NTP_UPDATE_IDLE      no request pending
+ * @return other                result of the update (see updateNTP())
+ */
+int NTPClientPlus::poll()
+{
+    if (!this->_updatePending)
     {
-        delay(10);
-        cb = this->_udp->parsePacket();
-        if (timeout > 100)
-            return -1; // timeout after 1000 ms
-        timeout++;
-    } while (cb == 0);
+        return NTP_UPDATE_IDLE;
+    }
 
-    this->_udp->read(this->_packetBuffer, NTP_PACKET_SIZE);
+    if (this->_udp->parsePacket() != 0)
+    {
+        this->_udp->read(this->_packetBuffer, NTP_PACKET_SIZE);
+        // the answer belongs to the pending request if the server returns our transmit timestamp as originate timestamp
+        if (readTimestamp(this->_packetBuffer + 24) == this->_requestTimestamp)
+        {
+            this->_updatePending = false;
+            return this->processNTPPacket();
+        }
+    }
+
+    if (millis() - this->_requestSent > NTP_TIMEOUT)
+    {
+        this->_updatePending = false;
+        return NTP_UPDATE_TIMEOUT;
+    }
+    return NTP_UPDATE_PENDING;
+}
+
+/**
+ * @brief Check if a request is waiting for the answer of the NTP server
+ * 
+ * @return true if a request is pending
+ */
+bool NTPClientPlus::isUpdatePending() const
+{
+    return this->_updatePending;
+}
+
+/**
+ * @brief Check if the local clock was set by at least one valid NTP answer
+ * 
+ * @return true if the time is valid
+ */
+bool NTPClientPlus::isSynced() const
+{
+    return this->_synced;
+}
+
+/**
+ * @brief Get the current poll interval, it grows while the local clock keeps in sync with the server
+ * 
+ * @return unsigned long poll interval in ms
+ */
+unsigned long NTPClientPlus::getPollInterval() const
+{
+    return this->_pollInterval;
+}
+
+/**
+ * @brief Get the offset of the local clock measured with the last successful update
+ * 
+ * @return long offset in ms (positive = local clock was behind)
+ */
+long NTPClientPlus::getOffset() const
+{
+    return static_cast<long>(constrain(this->_lastOffset, static_cast<int64_t>(LONG_MIN), static_cast<int64_t>(LONG_MAX)));
+}
+
+/**
+ * @brief Get the round trip delay of the last successful update
+ * 
+ * @return long delay in ms
+ */
+long NTPClientPlus::getDelay() const
+{
+    return this->_lastDelay;
+}
+
+/**
+ * @brief Get the estimated drift of the local oscillator
+ * 
+ * @return long drift in ppb (positive = local oscillator too slow)
+ */
+long NTPClientPlus::getDrift() const
+{
+    return this->_driftPpb;
+}
+
+/**
+ * @brief (private) Read the received NTP packet and update the time
+ * 
+ * Offset and delay are calculated from all four timestamps:
+ * T1 = request sent (local), T2 = request received (server), T3 = answer sent (server), T4 = answer received (local)
+ * 
+ * @return int result of the update (see updateNTP())
+ */
+int NTPClientPlus::processNTPPacket()
+{
+    int64_t t4 = this->getUTCMillis();
+
+    // leap indicator 3 = server not synchronized, stratum 0 = kiss-o'-death packet
+    if ((this->_packetBuffer[0] >> 6) == 3 || this->_packetBuffer[1] == 0)
+    {
+        return NTP_UPDATE_INVALID;
+    }
 
     unsigned long highWord = word(this->_packetBuffer[40], this->_packetBuffer[41]);
     unsigned long lowWord = word(this->_packetBuffer[42], this->_packetBuffer[43]);
@@ -66,31 +190,133 @@ int NTPClientPlus::updateNTP()
 
     if(tempSecsSince1900 < SEVENZYYEARS){
         // NTP time is not valid
-        return 2;
+        return NTP_UPDATE_INVALID;
     }
 
     // check if time off last ntp update is roughly in the same range: 100sec apart (validation check)
     if(this->_lastSecsSince1900 == 0 || tempSecsSince1900 - this->_lastSecsSince1900 < 100000){
         // Only update time then
-        this->_lastUpdate = millis() - (10 * (timeout + 1)); // Account for delay in reading the time
-
-        this->_secsSince1900 = tempSecsSince1900;
+        int64_t t1 = this->_requestTimestamp;
+        int64_t t2 = readTimestamp(this->_packetBuffer + 32);
+        int64_t t3 = readTimestamp(this->_packetBuffer + 40);
 
-        this->_currentEpoc = this->_secsSince1900 - SEVENZYYEARS;
+        this->_lastOffset = ((t2 - t1) + (t3 - t4)) / 2;
+        this->_lastDelay = static_cast<long>((t4 - t1) - (t3 - t2));
+        this->disciplineClock(this->_lastOffset);
 
         // Remember time of last update
         this->_lastSecsSince1900 = tempSecsSince1900;
 
-        return 0; // return 0 after successful update
+        return NTP_UPDATE_OK; // return 0 after successful update
     }
     else{
         // Remember time of last update
         this->_lastSecsSince1900 = tempSecsSince1900;
         
-        return 1;
+        return NTP_UPDATE_DIFF;
+    }
+}
+
+/**
+ * @brief (private) Get the local clock (UTC) with millisecond resolution
+ * 
+ * @return int64_t milliseconds since 1. Jan. 1900 (UTC)
+ */
+int64_t NTPClientPlus::getUTCMillis() const
+{
+    int64_t elapsed = static_cast<unsigned long>(millis() - this->_clockMillis);
+    // correct the drift of millis() and slew the remaining offset with limited rate, so the clock never jumps back
+    int64_t slewLimit = elapsed * NTP_SLEW_RATE_PPM / 1000000;
+    int64_t slew = constrain(static_cast<int64_t>(this->_slewMs), -slewLimit, slewLimit);
+    return this->_clockMs + elapsed + elapsed * this->_driftPpb / 1000000000 + slew;
+}
+
+/**
+ * @brief (private) Correct the local clock by the measured offset, update the drift estimation and the poll interval
+ * 
+ * @param offset measured offset in ms
+ */
+void NTPClientPlus::disciplineClock(int64_t offset)
+{
+    // restart the local clock from now, keep the part of the last offset which is not slewed yet
+    int64_t elapsed = static_cast<unsigned long>(millis() - this->_clockMillis);
+    int64_t slewLimit = elapsed * NTP_SLEW_RATE_PPM / 1000000;
+    long remainingSlew = this->_slewMs - constrain(static_cast<int64_t>(this->_slewMs), -slewLimit, slewLimit);
+    this->_clockMs = this->getUTCMillis();
+    this->_clockMillis = millis();
+
+    if (!this->_synced || offset > NTP_STEP_THRESHOLD || offset < -NTP_STEP_THRESHOLD)
+    {
+        // large offset -> step the clock and start drift estimation again
+        this->_clockMs += offset;
+        this->_slewMs = 0;
+        this->_driftOffsetSum = 0;
+        this->_driftRefMillis = this->_clockMillis;
+        this->_pollInterval = NTP_POLL_MIN;
+        this->_synced = true;
+        return;
+    }
+
+    this->_slewMs = offset;
+
+    // the offset minus the not yet slewed part of the last offset is the error accumulated by drift since last update
+    this->_driftOffsetSum += offset - remainingSlew;
+    unsigned long driftInterval = this->_clockMillis - this->_driftRefMillis;
+    if (driftInterval >= NTP_DRIFT_MIN_INTERVAL)
+    {
+        // correct only half of the measured drift to damp the noise of single measurements
+        // signed division, a negative sum must not be converted to unsigned where unsigned long has 64 bit
+        int64_t residualPpb = static_cast<int64_t>(this->_driftOffsetSum) * 1000000000 / static_cast<int64_t>(driftInterval);
+        this->_driftPpb = constrain(this->_driftPpb + static_cast<long>(residualPpb / 2), -NTP_MAX_DRIFT_PPB, NTP_MAX_DRIFT_PPB);
+        this->_driftOffsetSum = 0;
+        this->_driftRefMillis = this->_clockMillis;
+    }
+
+    // poll less often while the clock keeps in sync, faster again if the offset grows
+    if (offset < NTP_POLL_STABLE_OFFSET && offset > -NTP_POLL_STABLE_OFFSET)
+    {
+        this->_pollInterval = min(this->_pollInterval * 2, static_cast<unsigned long>(NTP_POLL_MAX));
+    }
+    else if (offset > 4 * NTP_POLL_STABLE_OFFSET || offset < -4 * NTP_POLL_STABLE_OFFSET)
+    {
+        this->_pollInterval = max(this->_pollInterval / 2, static_cast<unsigned long>(NTP_POLL_MIN));
     }
 }
 
+/**
+ * @brief (private) Read a NTP timestamp (64 bit, seconds and fraction since 1900)
+ * 
+ * @param buffer pointer to the 8 bytes of the timestamp
+ * @return int64_t timestamp in ms since 1900
+ */
+int64_t NTPClientPlus::readTimestamp(const byte *buffer)
+{
+    uint32_t seconds = static_cast<uint32_t>(buffer[0]) << 24 | static_cast<uint32_t>(buffer[1]) << 16 | static_cast<uint32_t>(buffer[2]) << 8 | buffer[3];
+    uint32_t fraction = static_cast<uint32_t>(buffer[4]) << 24 | static_cast<uint32_t>(buffer[5]) << 16 | static_cast<uint32_t>(buffer[6]) << 8 | buffer[7];
+    // round the fraction to ms, so that written timestamps are read back unchanged
+    return static_cast<int64_t>(seconds) * 1000 + ((static_cast<uint64_t>(fraction) * 1000 + 0x80000000UL) >> 32);
+}
+
+/**
+ * @brief (private) Write a NTP timestamp (64 bit, seconds and fraction since 1900)
+ * 
+ * @param buffer pointer to the 8 bytes of the timestamp
+ * @param ms timestamp in ms since 1900
+ */
+void NTPClientPlus::writeTimestamp(byte *buffer, int64_t ms)
+{
+    uint32_t seconds = static_cast<uint32_t>(ms / 1000);
+    uint32_t fraction = static_cast<uint32_t>((static_cast<uint64_t>(ms % 1000) << 32) / 1000);
+    buffer[0] = seconds >> 24;
+    buffer[1] = seconds >> 16;
+    buffer[2] = seconds >> 8;
+    buffer[3] = seconds;
+    buffer[4] = fraction >> 24;
+    buffer[5] = fraction >> 16;
+    buffer[6] = fraction >> 8;
+    buffer[7] = fraction;
+}
+
 /**
  * @brief Stops the underlying UDP client
  * 
@@ -103,13 +329,30 @@ void NTPClientPlus::end()
 }
 
 /**
- * @brief Setter UTC offset
+ * @brief Setter UTC offset of standard time, the daylight saving time rule of the timezone is kept
  * 
  * @param utcOffset offset from UTC in minutes
  */
 void NTPClientPlus::setUTCOffset(int utcOffset)
 {
-    this->_utcx = utcOffset;
+    this->_timezone.setStandardOffset(static_cast<int32_t>(utcOffset) * this->secondperminute);
+}
+
+/**
+ * @brief Set timezone (UTC offset and daylight saving time rule)
+ * 
+ * @param timezone POSIX TZ string, e.g. "CET-1CEST,M3.5.0,M10.5.0/3" or "JST-9"
+ * @return true if the timezone is valid (otherwise the previous timezone is kept)
+ */
+bool NTPClientPlus::setTimezone(const char *timezone)
+{
+    if (!this->_timezone.parse(timezone))
+    {
+        return false;
+    }
+    // offset may have changed, recalculate date
+    this->_dateDays1900 = ULONG_MAX;
+    return true;
 }
 
 /**
@@ -129,11 +372,9 @@ void NTPClientPlus::setPoolServerName(const char *poolServerName)
  */
 unsigned long NTPClientPlus::getSecsSince1900() const
 {    
-    int64_t secsSince1900WithDST =  static_cast<int64_t>(this->_secsSince1900) +                    // seconds returned by the NTP server
-                                    static_cast<int64_t>((millis() - this->_lastUpdate) / 1000) +   // Time since last update
-                                    this->_summertime * this->secondperhour +                       // Summer time offset
-                                    (static_cast<int64_t>(this->_utcx) * this->secondperminute);    // UTC offset
-    return static_cast<unsigned long>(secsSince1900WithDST);
+    int64_t utcSeconds = this->getUTCMillis() / 1000;                       // local clock synchronized with NTP
+    int64_t secsSince1900 = utcSeconds + this->_timezone.getOffset(utcSeconds); // UTC offset incl. daylight saving time
+    return static_cast<unsigned long>(secsSince1900);
 }
 
 /**
@@ -192,6 +433,16 @@ int NTPClientPlus::getSeconds() const
     return (this->getEpochTime() % 60);
 }
 
+/**
+ * @brief Get milliseconds of the current second
+ * 
+ * @return int 
+ */
+int NTPClientPlus::getMilliseconds() const
+{
+    return (this->getUTCMillis() % 1000);
+}
+
 /**
  * @brief 
  * 
@@ -230,78 +481,25 @@ String NTPClientPlus::getFormattedDate() {
 
 
 /**
- * @brief Calc date from seconds since 1900
+ * @brief Calc date from seconds since 1900, the date is only recalculated on day rollover
  * 
  */
 void NTPClientPlus::calcDate()
 {
-    // Start: Calc date
-
     // get days since 1900
     unsigned long days1900 = this->getSecsSince1900() / secondperday;
 
-    // calc current year
-    this->_dateYear = this->getYear();
-
-    // calc how many leap days since 1.Jan 1900
-    int leapDays = 0;
-    for (unsigned int i = 1900; i < this->_dateYear; i++)
+    if (days1900 != this->_dateDays1900)
     {
-        // check if leap year
-        if (this->isLeapYear(i))
-        {
-            leapDays++;
-        }
-    }
-    leapDays = leapDays - 1;
+        this->_dateDays1900 = days1900;
 
-    // check if current year is leap year
-    if (this->isLeapYear(this->_dateYear))
-    {
-        daysInMonth[2] = 29;
-    }
-    else
-    {
-        daysInMonth[2] = 28;
-    }
-
-    unsigned int dayOfYear = (days1900 - ((this->_dateYear - 1900) * 365) - leapDays);
-
-    // calc current month
-    this->_dateMonth = this->getMonth(dayOfYear);
-
-    this->_dateDay = 0;
-
-    // calc day of month
-    for (unsigned int i = 0; i < this->_dateMonth; i++)
-    {
-        this->_dateDay = this->_dateDay + daysInMonth[i];
-    }
-    this->_dateDay = dayOfYear - this->_dateDay;
+        TimezoneRule::civilFromDays(days1900, &this->_dateYear, &this->_dateMonth, &this->_dateDay);
 
-    // calc day of week:
-    // Monday = 1, Tuesday = 2, Wednesday = 3, Thursday = 4, Friday = 5, Saturday = 6, Sunday = 7
-    // 1. Januar 1900 was a monday
-    this->_dayOfWeek = 1;
-
-    for (unsigned long i = 0; i < days1900; i++)
-    {
-
-        if (this->_dayOfWeek < 7)
-        {
-            this->_dayOfWeek = this->_dayOfWeek + 1;
-        }
-        else
-        {
-            this->_dayOfWeek = 1;
-        }
+        // calc day of week:
+        // Monday = 1, Tuesday = 2, Wednesday = 3, Thursday = 4, Friday = 5, Saturday = 6, Sunday = 7
+        // 1. Januar 1900 was a monday
+        this->_dayOfWeek = days1900 % 7 + 1;
     }
-
-    // End: Calc date (dateDay, dateMonth, dateYear)
-
-    // calc if summer time active
-
-    this->updateSWChange();
 }
 
 /**
@@ -341,45 +539,9 @@ unsigned int NTPClientPlus::getMonthNumber()
  */
 unsigned int NTPClientPlus::getYear()
 {
-
-    unsigned long sec1900 = this->getSecsSince1900();
-
-    //NTP starts at 1. Jan 1900
-    unsigned int result = 1900;
-    unsigned int dayInYear = 0;
-    unsigned int days = 0;
-    unsigned int days1900 = 0;
-
-    unsigned long for_i = 0;
-    bool leapYear = LOW;
-
-    days1900 = sec1900 / this->secondperday;
-
-    for (for_i = 0; for_i < days1900; for_i++)
-    {
-
-        leapYear = this->isLeapYear(result);
-
-        if (leapYear)
-        {
-            dayInYear = 366;
-        }
-
-        else
-        {
-            dayInYear = 365;
-        }
-
-        days++;
-
-        if (days >= dayInYear)
-        {
-            result++;
-            days = 0;
-        }
-    }
-
-    return result;
+    unsigned int year, month, day;
+    TimezoneRule::civilFromDays(this->getSecsSince1900() / this->secondperday, &year, &month, &day);
+    return year;
 }
 
 /**
@@ -549,6 +711,9 @@ void NTPClientPlus::sendNTPPacket()
     this->_packetBuffer[13] = 0x4E;
     this->_packetBuffer[14] = 49;
     this->_packetBuffer[15] = 52;
+    // transmit timestamp (T1), returned by the server as originate timestamp
+    this->_requestTimestamp = this->getUTCMillis();
+    writeTimestamp(this->_packetBuffer + 40, this->_requestTimestamp);
 
     // all NTP fields have been given values, now
     // you can send a packet requesting a timestamp:
@@ -565,170 +730,11 @@ void NTPClientPlus::sendNTPPacket()
 }
 
 /**
- * @brief (private) Set time offset accordance to summer time
- * 
- * @param summertime 
- */
-void NTPClientPlus::setSummertime(bool summertime)
-{
-    this->_summertime = summertime;
-}
-
-/**
- * @brief Update Summer/Winter time change
+ * @brief Check if daylight saving time is active (according to the rule of the timezone)
  * 
  * @returns bool summertime active
  */
 bool NTPClientPlus::updateSWChange()
 {
-    unsigned int dayOfWeek = this->_dayOfWeek; 
-    unsigned int dateDay = this->_dateDay; 
-    unsigned int dateMonth = this->_dateMonth;
-
-    // Calculate local STANDARD time (without DST) for exact switch-hour handling.
-    // EU rule: DST starts on last Sunday in March at 02:00 (standard time),
-    // and ends on last Sunday in October at 03:00 local summer time
-    // (== 02:00 standard time).
-    int64_t currentUtcSeconds = static_cast<int64_t>(this->_secsSince1900) +
-                                static_cast<int64_t>((millis() - this->_lastUpdate) / 1000);
-    int64_t secsSince1900NoDST = currentUtcSeconds +
-                                 (static_cast<int64_t>(this->_utcx) * this->secondperminute);
-    int64_t secondsIntoDay = secsSince1900NoDST % this->secondperday;
-    if (secondsIntoDay < 0)
-    {
-        secondsIntoDay += this->secondperday;
-    }
-    unsigned int hourNoDST = static_cast<unsigned int>(secondsIntoDay / this->secondperhour);
-
-    bool summertimeActive = false;
-    
-    if (this->_swChange)
-    {
-        //Start: Set summer-/ winter time
-
-        // current month is march
-        if (dateMonth == 3)
-        {
-
-            // it is last week in march
-            if ((this->daysInMonth[3] - dateDay) < 7)
-            {
-
-                //Example year 2020: March 31 days; Check on March 26, 2020 (Thursday = weekday = 4); 5 days remaining; Last Sunday March 29, 2020
-                //Calculation: 31 - 26 = 5; 5 + 4 = 9;
-                //Result: Last day in March is a Tuesday. There follows another Sunday in October => set winter time
-
-                //Example year 2021: March 31 days; Check on March 30, 2021 (Tuesday = weekday = 2); 1 days remaining; Last Sunday March 28, 2021
-                //Calculation: 31 - 30 = 1; 1 + 2 = 3;
-                //Result: Last day in March is a Wednesday. Changeover to summer time already done => set summer time
-
-                // If today is Sunday (dayOfWeek == 7) then this is the last Sunday in March.
-                // Switch to summer time at 02:00 standard time (clock jumps to 03:00).
-                if(dayOfWeek == 7){
-                    if (hourNoDST >= 2)
-                    {
-                        this->setSummertime(1);
-                        summertimeActive = true;
-                    }
-                    else
-                    {
-                        this->setSummertime(0);
-                        summertimeActive = false;
-                    }
-                }
-
-                //There follows within the last week in March one more Sunday => set winter time
-                else if (((this->daysInMonth[3] - dateDay) + dayOfWeek) >= 7)
-                {
-                    this->setSummertime(0);
-                    summertimeActive = false;
-                }
-
-                // last sunday in march already over -> set summer time
-                else
-                {
-                    this->setSummertime(1);
-                    summertimeActive = true;
-                }
-            }
-
-            // Check in first three weeks of march -> winter time
-            else
-            {
-                this->setSummertime(0);
-                summertimeActive = false;
-            }
-        }
-
-        // current month is october
-        else if (dateMonth == 10)
-        {
-
-            // Check in last week of october
-            if ((this->daysInMonth[10] - dateDay) < 7)
-            {
-
-                //Example year 2020: October 31 days; Check on October 26, 2020 (Monday = weekday = 1); 5 days remaining; last Sunday October 25, 2020
-                //Calculation: 31 - 26 = 5; 5 + 1 = 6;
-                //Result: Last day in October is a Saturday. Changeover to winter time already done => set winter time
-
-                //Example year 2021: October 31 days; Check on 26. October 2021 (Tuesday = weekday = 2); 5 days remaining; Last Sunday 31. October 2021
-                //Calculation: 31 - 26 = 5; 5 + 2 = 7;
-                //Result: Last day in October is a Sunday. There follows another Sunday in October => set summer time
-                
-                // If today is Sunday (dayOfWeek == 7) then this is the last Sunday in October.
-                // Switch back to winter time at 02:00 standard time
-                // (which corresponds to 03:00 local summer time).
-                if(dayOfWeek == 7){
-                    if (hourNoDST >= 2)
-                    {
-                        this->setSummertime(0);
-                        summertimeActive = false;
-                    }
-                    else
-                    {
-                        this->setSummertime(1);
-                        summertimeActive = true;
-                    }
-                }
-
-                // There follows within the last week in October one more Sunday => summer time
-                else if (((this->daysInMonth[10] - dateDay) + dayOfWeek) >= 7)
-                {
-                    this->setSummertime(1);
-                    summertimeActive = true;
-                }
-
-                // last sunday in october already over -> winter time
-                else
-                {
-                    this->setSummertime(0);
-                    summertimeActive = false;
-                }
-            }
-
-            // Check in first three weeks of october -> summer time
-            else
-            {
-                this->setSummertime(1);
-                summertimeActive = true;
-            }
-        }
-
-        // Check in summer time
-        else if (dateMonth > 3 && dateMonth < 10)
-        {
-            this->setSummertime(1);
-            summertimeActive = true;
-        }
-
-        // Check in winter time
-        else if (dateMonth < 3 || dateMonth > 10)
-        {
-            this->setSummertime(0);
-            summertimeActive = false;
-        }
-    }
-
-    return summertimeActive;
+    return this->_timezone.isDST(this->getUTCMillis() / 1000);
 }
@@ -3,10 +3,31 @@
 
 #include <Arduino.h>
 #include <WiFiUdp.h>
+#include "timezonerule.h"
 
 #define SEVENZYYEARS 2208988800UL
 #define NTP_PACKET_SIZE 48
 #define NTP_DEFAULT_LOCAL_PORT 1337
+#define NTP_TIMEOUT 1000 // timeout for the answer of the NTP server in ms
+
+// clock discipline
+#define NTP_STEP_THRESHOLD 500          // offsets larger than this (ms) are corrected by a step, smaller ones by slewing
+#define NTP_SLEW_RATE_PPM 500           // max. rate of slewing (ms per 1000 s)
+#define NTP_MAX_DRIFT_PPB 500000L       // limit of the estimated drift of the local oscillator (500 ppm)
+#define NTP_DRIFT_MIN_INTERVAL 240000   // min. interval (ms) between two drift estimations
+#define NTP_POLL_MIN 30000              // min. poll interval in ms
+#define NTP_POLL_MAX 3840000            // max. poll interval in ms (64 min)
+#define NTP_POLL_STABLE_OFFSET 20       // offsets (ms) below this double the poll interval, above four times this halve it
+
+// results of NTPClientPlus::updateNTP() and NTPClientPlus::poll()
+enum NTPResult {
+    NTP_UPDATE_TIMEOUT = -1,    // no answer from server within NTP_TIMEOUT
+    NTP_UPDATE_OK = 0,          // time updated successfully
+    NTP_UPDATE_DIFF = 1,        // too much difference to previous received time (try again)
+    NTP_UPDATE_INVALID = 2,     // received time is not valid (< 1970)
+    NTP_UPDATE_PENDING = 3,     // request sent, waiting for answer
+    NTP_UPDATE_IDLE = 4         // no request running
+};
 
 /**
  * @brief Own NTP Client library for Arduino with code from:
@@ -17,11 +38,20 @@
 class NTPClientPlus{
 
     public:
-        NTPClientPlus(UDP &udp, const char* poolServerName, int utcx, bool _swChange);
+        NTPClientPlus(UDP &udp, const char* poolServerName, const char* timezone);
         void setupNTPClient();
         int updateNTP();
+        bool beginUpdate();
+        int poll();
+        bool isUpdatePending() const;
+        bool isSynced() const;
+        unsigned long getPollInterval() const;
+        long getOffset() const;
+        long getDelay() const;
+        long getDrift() const;
         void end();
         void setUTCOffset(int utcOffset);
+        bool setTimezone(const char* timezone);
         void setPoolServerName(const char* poolServerName);
         unsigned long getSecsSince1900() const;
         unsigned long getEpochTime() const;
@@ -29,6 +59,7 @@ class NTPClientPlus{
         int getHours12() const;
         int getMinutes() const;
         int getSeconds() const;
+        int getMilliseconds() const;
         String getFormattedTime() const;
         String getFormattedDate();
         void calcDate();
@@ -48,25 +79,40 @@ class NTPClientPlus{
         const char*   _poolServerName = "pool.ntp.org"; // Default time server
         IPAddress     _poolServerIP;
         unsigned int  _port           = NTP_DEFAULT_LOCAL_PORT;
-        int           _utcx           = 0;
-        bool          _swChange       = 1;
-        bool          _summertime     = false;
+        mutable TimezoneRule _timezone;         // rule for UTC offset and daylight saving time
 
-        unsigned long _updateInterval = 60000;  // In ms
+        unsigned long _pollInterval   = NTP_POLL_MIN; // In ms
 
-        unsigned long _currentEpoc    = 0;      // In s
-        unsigned long _lastUpdate     = 0;      // In ms
-        unsigned long _secsSince1900  = 0;      // seconds since 1. Januar 1900, 00:00:00
+        unsigned long _requestSent    = 0;      // In ms, time when the pending request was sent
+        int64_t       _requestTimestamp = 0;    // In ms since 1900, local time when the pending request was sent (T1)
+        bool          _updatePending  = false;
         unsigned long _lastSecsSince1900 = 0;
+
+        // local clock: _clockMs (ms since 1. Januar 1900, 00:00:00 UTC) at millis() == _clockMillis,
+        // running with the corrected drift and slewing the remaining offset _slewMs
+        int64_t       _clockMs        = 0;
+        unsigned long _clockMillis    = 0;
+        long          _slewMs         = 0;
+        long          _driftPpb       = 0;      // estimated drift of millis() in ppb (positive = millis() too slow)
+        long          _driftOffsetSum = 0;      // sum of offsets since last drift estimation (ms)
+        unsigned long _driftRefMillis = 0;
+        bool          _synced         = false;
+        int64_t       _lastOffset     = 0;      // In ms
+        long          _lastDelay      = 0;      // In ms
         unsigned int _dateYear         = 0;
         unsigned int _dateMonth        = 0;
         unsigned int _dateDay          = 0;
         unsigned int _dayOfWeek        = 0;
+        unsigned long _dateDays1900    = ULONG_MAX; // day (since 1900) of the calculated date
 
 
         byte          _packetBuffer[NTP_PACKET_SIZE];
         void          sendNTPPacket();
-        void          setSummertime(bool summertime);
+        int           processNTPPacket();
+        int64_t       getUTCMillis() const;
+        void          disciplineClock(int64_t offset);
+        static int64_t readTimestamp(const byte *buffer);
+        static void   writeTimestamp(byte *buffer, int64_t ms);
         
 
         static const unsigned long secondperday = 86400;
@@ -75,9 +121,6 @@ class NTPClientPlus{
         static const unsigned long minuteperhour = 60;
         static const unsigned long millisecondpersecond = 1000;
 
-        // number of days in months
-        unsigned int daysInMonth[13] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-
 
 
 
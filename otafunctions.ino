@@ -21,6 +21,9 @@ void setupOTA(String hostname){
       type = "filesystem";
     }
 
+    // write pending settings, the update restarts the ESP
+    settings.commit();
+
     // NOTE: if updating FS this would be the place to unmount FS using FS.end()
     //Serial.println("Start updating " + type);
   });
@@ -0,0 +1,209 @@
+#include "perfcounter.h"
+
+/**
+ * @brief Construct a new PerfCounter object without sections
+ *
+ */
+PerfCounter::PerfCounter(){
+    numSections = 0;
+}
+
+/**
+ * @brief Register a new section
+ *
+ * @param name name of the section (for output)
+ * @return int8_t id of the section (PERF_NO_SECTION if no space left)
+ */
+int8_t PerfCounter::addSection(const char *name){
+    if(numSections >= PERF_MAX_SECTIONS){
+        return PERF_NO_SECTION;
+    }
+    sections[numSections].name = name;
+    numSections++;
+    reset();
+    return numSections - 1;
+}
+
+/**
+ * @brief Record one measurement
+ *
+ * @param section id of the section
+ * @param cycles duration in CPU cycles
+ */
+void PerfCounter::record(int8_t section, uint32_t cycles){
+    if(!isValid(section)){
+        return;
+    }
+    Section &s = sections[section];
+    uint32_t us = cycles / ESP.getCpuFreqMHz();
+
+    s.count++;
+    s.sum += us;
+    if(us < s.min){
+        s.min = us;
+    }
+    if(us > s.max){
+        s.max = us;
+    }
+
+    uint8_t index = bucketIndex(us);
+    if(s.histogram[index] == UINT16_MAX){
+        // halve all buckets to keep the distribution without overflow
+        for(uint8_t i = 0; i < PERF_HIST_BUCKETS; i++){
+            s.histogram[i] >>= 1;
+        }
+    }
+    s.histogram[index]++;
+}
+
+/**
+ * @brief Reset the statistics of all sections
+ *
+ */
+void PerfCounter::reset(){
+    for(uint8_t i = 0; i < numSections; i++){
+        Section &s = sections[i];
+        s.count = 0;
+        s.min = UINT32_MAX;
+        s.max = 0;
+        s.sum = 0;
+        memset(s.histogram, 0, sizeof(s.histogram));
+    }
+}
+
+/**
+ * @brief Get the number of registered sections
+ *
+ * @return uint8_t number of sections
+ */
+uint8_t PerfCounter::getNumSections(){
+    return numSections;
+}
+
+/**
+ * @brief Get the name of a section
+ *
+ * @param section id of the section
+ * @return const char* name
+ */
+const char* PerfCounter::getName(int8_t section){
+    return isValid(section) ? sections[section].name : "";
+}
+
+/**
+ * @brief Get the number of measurements since the last reset
+ *
+ * @param section id of the section
+ * @return uint32_t number of measurements
+ */
+uint32_t PerfCounter::getCount(int8_t section){
+    return isValid(section) ? sections[section].count : 0;
+}
+
+/**
+ * @brief Get the shortest duration since the last reset
+ *
+ * @param section id of the section
+ * @return uint32_t duration in us (0 if no measurement)
+ */
+uint32_t PerfCounter::getMin(int8_t section){
+    if(!isValid(section) || sections[section].count == 0){
+        return 0;
+    }
+    return sections[section].min;
+}
+
+/**
+ * @brief Get the average duration since the last reset
+ *
+ * @param section id of the section
+ * @return uint32_t duration in us (0 if no measurement)
+ */
+uint32_t PerfCounter::getAvg(int8_t section){
+    if(!isValid(section) || sections[section].count == 0){
+        return 0;
+    }
+    return sections[section].sum / sections[section].count;
+}
+
+/**
+ * @brief Get the longest duration since the last reset
+ *
+ * @param section id of the section
+ * @return uint32_t duration in us
+ */
+uint32_t PerfCounter::getMax(int8_t section){
+    return isValid(section) ? sections[section].max : 0;
+}
+
+/**
+ * @brief Estimate a percentile of the durations from the histogram
+ *
+ * @param section id of the section
+ * @param percent percentile (1-100)
+ * @return uint32_t upper bound of the histogram bucket containing the percentile in us (limited to max)
+ */
+uint32_t PerfCounter::getPercentile(int8_t section, uint8_t percent){
+    if(!isValid(section) || sections[section].count == 0){
+        return 0;
+    }
+    Section &s = sections[section];
+    uint32_t total = 0;
+    for(uint8_t i = 0; i < PERF_HIST_BUCKETS; i++){
+        total += s.histogram[i];
+    }
+    // rank of the percentile (rounded up)
+    uint32_t rank = (total * percent + 99) / 100;
+    uint32_t cumulated = 0;
+    for(uint8_t i = 0; i < PERF_HIST_BUCKETS; i++){
+        cumulated += s.histogram[i];
+        if(cumulated >= rank && cumulated > 0){
+            return min(bucketUpperBound(i), s.max);
+        }
+    }
+    return s.max;
+}
+
+/**
+ * @brief (private) Check the id of a section
+ *
+ * @param section id of the section
+ * @return true if the section exists
+ */
+bool PerfCounter::isValid(int8_t section){
+    return section >= 0 && section < numSections;
+}
+
+/**
+ * @brief (private) Get the histogram bucket of a duration: values below 4 have their own bucket,
+ * above each power of two is split into 4 buckets
+ *
+ * @param us duration in us
+ * @return uint8_t index of the bucket
+ */
+uint8_t PerfCounter::bucketIndex(uint32_t us){
+    if(us < 4){
+        return us;
+    }
+    uint8_t msb = 31 - __builtin_clz(us);
+    uint32_t index = (msb - 1) * 4 + ((us >> (msb - 2)) & 3);
+    return index < PERF_HIST_BUCKETS ? index : PERF_HIST_BUCKETS - 1;
+}
+
+/**
+ * @brief (private) Get the largest duration which belongs to a histogram bucket
+ *
+ * @param index index of the bucket
+ * @return uint32_t duration in us
+ */
+uint32_t PerfCounter::bucketUpperBound(uint8_t index){
+    if(index < 4){
+        return index;
+    }
+    if(index == PERF_HIST_BUCKETS - 1){
+        return UINT32_MAX;
+    }
+    uint8_t msb = index / 4 + 1;
+    uint32_t lower = (uint32_t)(4 + index % 4) << (msb - 2);
+    return lower + (1UL << (msb - 2)) - 1;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file perfcounter.h
+ * @brief Instrumentation of hot code paths with named scoped timers
+ *
+ * A section is registered once with addSection() and measured with PERF_SCOPE(), which records the
+ * time between the macro and the end of the enclosing scope. The durations are measured with the CPU
+ * cycle counter and stored per section as count, min, max, sum and a log-linear histogram
+ * (4 buckets per power of two, relative error < 25%) in a fixed array, so the percentiles can be
+ * estimated without storing samples.
+ *
+ * Set PERF_ENABLED to 0 to remove the instrumentation completely: PERF_SCOPE() compiles to nothing
+ * and the sketch excludes the counter, the endpoint and the log output.
+ *
+ */
+
+#ifndef perfcounter_h
+#define perfcounter_h
+
+#include <Arduino.h>
+
+#ifndef PERF_ENABLED
+#define PERF_ENABLED 1                  // 0 = no instrumentation (release build)
+#endif
+
+#define PERF_MAX_SECTIONS 8
+#define PERF_HIST_BUCKETS 64            // covers 0 us - 115 ms, longer durations are counted in the last bucket
+#define PERF_NO_SECTION -1
+
+class PerfCounter{
+
+    public:
+        PerfCounter();
+        int8_t addSection(const char *name);
+        void record(int8_t section, uint32_t cycles);
+        void reset();
+        uint8_t getNumSections();
+        const char* getName(int8_t section);
+        uint32_t getCount(int8_t section);
+        uint32_t getMin(int8_t section);
+        uint32_t getAvg(int8_t section);
+        uint32_t getMax(int8_t section);
+        uint32_t getPercentile(int8_t section, uint8_t percent);
+
+    private:
+        struct Section {
+            const char *name;
+            uint32_t count;
+            uint32_t min;               // us
+            uint32_t max;               // us
+            uint64_t sum;               // us
+            uint16_t histogram[PERF_HIST_BUCKETS];
+        };
+
+        Section sections[PERF_MAX_SECTIONS];
+        uint8_t numSections = 0;
+
+        bool isValid(int8_t section);
+        static uint8_t bucketIndex(uint32_t us);
+        static uint32_t bucketUpperBound(uint8_t index);
+};
+
+/**
+ * @brief Scoped timer, records the lifetime of the object in the given section.
+ * Defined inline to keep the overhead in the measured code paths at a few cycles.
+ */
+class PerfTimer{
+
+    public:
+        PerfTimer(PerfCounter &counter, int8_t section) : counter(counter), section(section), start(ESP.getCycleCount()) {}
+        ~PerfTimer(){ counter.record(section, ESP.getCycleCount() - start); }
+
+    private:
+        PerfCounter &counter;
+        int8_t section;
+        uint32_t start;
+};
+
+#if PERF_ENABLED
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_(a, b)
+#define PERF_SCOPE(counter, section) PerfTimer PERF_CONCAT(_perfTimer, __LINE__)(counter, section)
+#else
+#define PERF_SCOPE(counter, section)
+#endif
+
+#endif
@@ -24,7 +24,7 @@ Pong::Pong(){
  * @brief Construct a new Pong:: Pong object
  * 
  * @param myledmatrix pointer to LEDMatrix object, need to provide gridAddPixel(x, y, col), gridFlush()
- * @param mylogger pointer to UDPLogger object, need to provide a function logString(message)
+ * @param mylogger pointer to UDPLogger object
  */
 Pong::Pong(LEDMatrix *myledmatrix, UDPLogger *mylogger){
     _ledmatrix = myledmatrix;
@@ -93,7 +93,7 @@ void Pong::ctrlNone(uint8_t playerid){
  */
 void Pong::initGame(uint8_t numBots)
 {
-    (*_logger).logString("Pong: init with " + String(numBots) + " Bots");
+    LOG_INFO(*_logger, "Pong: init with %u Bots", numBots);
     resetLEDs();
     _lastButtonClick = millis();
 
@@ -178,7 +178,7 @@ void Pong::updateBall()
  */
 void Pong::endGame()
 {
-    (*_logger).logString("Pong: Game ended");
+    LOG_INFO(*_logger, "Pong: Game ended");
     _gameState = GAME_STATE_END;
     toggleLed(_ball.x, _ball.y, LED_TYPE_BALL_RED);
 }
@@ -0,0 +1,221 @@
+#include "scheduler.h"
+
+/**
+ * @brief Construct a new Scheduler object without tasks
+ *
+ */
+Scheduler::Scheduler(){
+    numTasks = 0;
+}
+
+/**
+ * @brief Register a new task, it is enabled immediately
+ *
+ * @param name name of the task (for statistics)
+ * @param callback function to be called
+ * @param period period in ms (0 = one-shot task, which is disabled after running, see schedule())
+ * @param delay delay in ms until the first run
+ * @return int8_t id of the task (SCHEDULER_NO_TASK if no space left)
+ */
+int8_t Scheduler::addTask(const char *name, TaskCallback callback, uint32_t period, uint32_t delay){
+    if(numTasks >= SCHEDULER_MAX_TASKS){
+        return SCHEDULER_NO_TASK;
+    }
+    Task &t = tasks[numTasks];
+    t.name = name;
+    t.callback = callback;
+    t.period = period;
+    t.deadline = millis() + delay;
+    t.lastRun = millis();
+    t.enabled = true;
+    t.runs = 0;
+    t.totalRunTime = 0;
+    t.maxRunTime = 0;
+    t.maxLateness = 0;
+    return numTasks++;
+}
+
+/**
+ * @brief Change the period of a task, the next run is calculated from the last run with the new period
+ *
+ * @param task id of the task
+ * @param period new period in ms
+ */
+void Scheduler::setPeriod(int8_t task, uint32_t period){
+    if(!isValid(task)){
+        return;
+    }
+    tasks[task].period = period;
+    tasks[task].deadline = tasks[task].lastRun + period;
+}
+
+/**
+ * @brief Set the next run of a task (also enables it), e.g. to trigger a one-shot task or to retry earlier
+ *
+ * @param task id of the task
+ * @param delay delay in ms from now
+ */
+void Scheduler::schedule(int8_t task, uint32_t delay){
+    if(!isValid(task)){
+        return;
+    }
+    tasks[task].deadline = millis() + delay;
+    tasks[task].enabled = true;
+}
+
+/**
+ * @brief Enable or disable a task
+ *
+ * @param task id of the task
+ * @param enabled true to enable
+ */
+void Scheduler::setEnabled(int8_t task, bool enabled){
+    if(isValid(task)){
+        tasks[task].enabled = enabled;
+    }
+}
+
+/**
+ * @brief Run all due tasks, needs to be called in every loop cycle
+ *
+ * @return uint32_t time in ms until the next deadline
+ */
+uint32_t Scheduler::run(){
+    for(uint8_t i = 0; i < numTasks; i++){
+        Task &t = tasks[i];
+        uint32_t now = millis();
+        // signed difference handles the overflow of millis()
+        if(!t.enabled || (int32_t)(now - t.deadline) < 0){
+            continue;
+        }
+
+        uint32_t lateness = now - t.deadline;
+        t.lastRun = t.deadline;
+        if(t.period == 0){
+            t.enabled = false;
+        }
+        else{
+            t.deadline += t.period;
+            // skip runs which were missed completely instead of running them in a burst
+            if((int32_t)(now - t.deadline) >= 0){
+                t.deadline = now + t.period;
+                t.lastRun = now;
+            }
+        }
+
+        uint32_t start = micros();
+        t.callback();
+        uint32_t runTime = micros() - start;
+
+        t.runs++;
+        t.totalRunTime += runTime;
+        if(runTime > t.maxRunTime){
+            t.maxRunTime = runTime;
+        }
+        if(lateness > t.maxLateness){
+            t.maxLateness = lateness;
+        }
+    }
+
+    // time until next deadline (tasks may have been rescheduled by the callbacks)
+    uint32_t now = millis();
+    uint32_t idle = UINT32_MAX;
+    for(uint8_t i = 0; i < numTasks; i++){
+        if(!tasks[i].enabled){
+            continue;
+        }
+        int32_t remaining = (int32_t)(tasks[i].deadline - now);
+        if(remaining <= 0){
+            return 0;
+        }
+        if((uint32_t)remaining < idle){
+            idle = remaining;
+        }
+    }
+    return idle;
+}
+
+/**
+ * @brief Get the number of registered tasks
+ *
+ * @return uint8_t number of tasks
+ */
+uint8_t Scheduler::getNumTasks(){
+    return numTasks;
+}
+
+/**
+ * @brief Get the name of a task
+ *
+ * @param task id of the task
+ * @return const char* name
+ */
+const char* Scheduler::getName(int8_t task){
+    return isValid(task) ? tasks[task].name : "";
+}
+
+/**
+ * @brief Get the number of runs of a task since the last reset of the statistics
+ *
+ * @param task id of the task
+ * @return uint32_t number of runs
+ */
+uint32_t Scheduler::getRuns(int8_t task){
+    return isValid(task) ? tasks[task].runs : 0;
+}
+
+/**
+ * @brief Get the longest run time of a task since the last reset of the statistics
+ *
+ * @param task id of the task
+ * @return uint32_t run time in us
+ */
+uint32_t Scheduler::getMaxRunTime(int8_t task){
+    return isValid(task) ? tasks[task].maxRunTime : 0;
+}
+
+/**
+ * @brief Get the average run time of a task since the last reset of the statistics
+ *
+ * @param task id of the task
+ * @return uint32_t run time in us
+ */
+uint32_t Scheduler::getAvgRunTime(int8_t task){
+    if(!isValid(task) || tasks[task].runs == 0){
+        return 0;
+    }
+    return tasks[task].totalRunTime / tasks[task].runs;
+}
+
+/**
+ * @brief Get the largest delay between the deadline and the start of a run since the last reset of the statistics
+ *
+ * @param task id of the task
+ * @return uint32_t lateness in ms
+ */
+uint32_t Scheduler::getMaxLateness(int8_t task){
+    return isValid(task) ? tasks[task].maxLateness : 0;
+}
+
+/**
+ * @brief Reset the statistics of all tasks
+ *
+ */
+void Scheduler::resetStats(){
+    for(uint8_t i = 0; i < numTasks; i++){
+        tasks[i].runs = 0;
+        tasks[i].totalRunTime = 0;
+        tasks[i].maxRunTime = 0;
+        tasks[i].maxLateness = 0;
+    }
+}
+
+/**
+ * @brief (private) Check the id of a task
+ *
+ * @param task id of the task
+ * @return true if the task exists
+ */
+bool Scheduler::isValid(int8_t task){
+    return task >= 0 && task < numTasks;
+}
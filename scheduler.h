@@ -0,0 +1,60 @@
+/**
+ * @file scheduler.h
+ * @brief Small cooperative scheduler for periodic and one-shot tasks
+ *
+ * Each task has a deadline (millis), the scheduler runs all due tasks and returns the time until the
+ * next deadline, so the main loop can sleep meanwhile. Periodic tasks keep a fixed rate (the next deadline
+ * is calculated from the previous deadline, not from the end of the run), so the jitter of one task does
+ * not accumulate. The number of tasks is small, so the next deadline is found by a linear search.
+ *
+ */
+
+#ifndef scheduler_h
+#define scheduler_h
+
+#include <Arduino.h>
+
+#define SCHEDULER_MAX_TASKS 12
+#define SCHEDULER_NO_TASK -1
+
+typedef void (*TaskCallback)();
+
+class Scheduler{
+
+    public:
+        Scheduler();
+        int8_t addTask(const char *name, TaskCallback callback, uint32_t period, uint32_t delay);
+        void setPeriod(int8_t task, uint32_t period);
+        void schedule(int8_t task, uint32_t delay);
+        void setEnabled(int8_t task, bool enabled);
+        uint32_t run();
+        uint8_t getNumTasks();
+        const char* getName(int8_t task);
+        uint32_t getRuns(int8_t task);
+        uint32_t getMaxRunTime(int8_t task);
+        uint32_t getAvgRunTime(int8_t task);
+        uint32_t getMaxLateness(int8_t task);
+        void resetStats();
+
+    private:
+        struct Task {
+            const char *name;
+            TaskCallback callback;
+            uint32_t period;            // ms, 0 = one-shot task
+            uint32_t deadline;          // millis() of next run
+            uint32_t lastRun;           // deadline of last run
+            bool enabled;
+            // statistics
+            uint32_t runs;
+            uint32_t totalRunTime;      // us
+            uint32_t maxRunTime;        // us
+            uint32_t maxLateness;       // ms between deadline and start of run
+        };
+
+        Task tasks[SCHEDULER_MAX_TASKS];
+        uint8_t numTasks = 0;
+
+        bool isValid(int8_t task);
+};
+
+#endif
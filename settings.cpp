@@ -0,0 +1,227 @@
+#include "settings.h"
+#include "timezonerule.h"
+#include "wordclocklayouts.h"
+
+// addresses of the old byte address map (SETTINGS_LEGACY_VERSION)
+#define LEGACY_ADR_NM_START_H        1
+#define LEGACY_ADR_NM_END_H          2
+#define LEGACY_ADR_NM_START_M        3
+#define LEGACY_ADR_NM_END_M          4
+#define LEGACY_ADR_BRIGHTNESS        5
+#define LEGACY_ADR_MC_RED            6
+#define LEGACY_ADR_MC_GREEN          7
+#define LEGACY_ADR_MC_BLUE           8
+#define LEGACY_ADR_STATE             9
+#define LEGACY_ADR_NM_ACTIVATED     10
+#define LEGACY_ADR_COLSHIFTSPEED    11
+#define LEGACY_ADR_COLSHIFTACTIVE   12
+#define LEGACY_ADR_NM_BRIGHTNESS    13
+#define LEGACY_ADR_LAYOUT           14
+#define LEGACY_ADR_TZ_EXPIRES       15  // uint32_t
+#define LEGACY_ADR_TZ_RULE          19  // char[TZ_RULE_MAX_LEN]
+
+/**
+ * @brief Construct a new SettingsStore object
+ *
+ */
+SettingsStore::SettingsStore(){
+    memset(&data, 0, sizeof(data));
+}
+
+/**
+ * @brief Initialize the EEPROM and load the settings. If the stored settings are invalid (other version or
+ * wrong CRC), the defaults are used and written immediately. Settings of the old byte address map are migrated.
+ *
+ * @param defaults default settings
+ * @return true if valid settings were loaded
+ */
+bool SettingsStore::begin(const Settings &defaults){
+    EEPROM.begin(sizeof(Header) + sizeof(Settings));
+
+    Header header;
+    EEPROM.get(0, header);
+    EEPROM.get(sizeof(Header), data);
+    if(header.version == SETTINGS_VERSION && header.crc == crc32((const uint8_t*)&data, sizeof(data))){
+        writeCount = header.writeCount;
+        return true;
+    }
+
+    uint8_t storedVersion = EEPROM.read(0);
+    memcpy(&data, &defaults, sizeof(data));
+    if(storedVersion == SETTINGS_LEGACY_VERSION){
+        loadLegacy();
+    }
+    writeCount = 0;
+    changed();
+    commit();
+    return false;
+}
+
+/**
+ * @brief Get the current settings (incl. changes, which are not written yet)
+ *
+ * @return const Settings& settings
+ */
+const Settings& SettingsStore::get(){
+    return data;
+}
+
+/**
+ * @brief Set the cached timezone
+ *
+ * @param rule POSIX TZ string (is truncated to TZ_RULE_MAX_LEN - 1 characters)
+ */
+void SettingsStore::setTimezoneRule(const char *rule){
+    if(strncmp(data.tzRule, rule, TZ_RULE_MAX_LEN - 1) != 0){
+        // clear the whole array, so that the CRC does not depend on old characters after the terminating zero
+        memset(data.tzRule, 0, TZ_RULE_MAX_LEN);
+        strncpy(data.tzRule, rule, TZ_RULE_MAX_LEN - 1);
+        changed();
+    }
+}
+
+/**
+ * @brief Write the settings after the quiet period, needs to be called regularly
+ *
+ */
+void SettingsStore::handle(){
+    if(pending && (millis() - lastChange >= SETTINGS_COMMIT_DELAY || millis() - firstChange >= SETTINGS_MAX_COMMIT_DELAY)){
+        commit();
+    }
+}
+
+/**
+ * @brief Write changed settings immediately (e.g. before a restart)
+ *
+ * @return true if the flash was written, false if there were no changes
+ */
+bool SettingsStore::commit(){
+    if(!pending){
+        return false;
+    }
+    pending = false;
+
+    // skip the write if the changes have been reverted meanwhile
+    Header header;
+    Settings stored;
+    EEPROM.get(0, header);
+    EEPROM.get(sizeof(Header), stored);
+    uint32_t crc = crc32((const uint8_t*)&data, sizeof(data));
+    if(header.version == SETTINGS_VERSION && header.crc == crc && memcmp(&stored, &data, sizeof(data)) == 0){
+        return false;
+    }
+
+    writeCount++;
+    memset(&header, 0, sizeof(header));
+    header.version = SETTINGS_VERSION;
+    header.writeCount = writeCount;
+    header.crc = crc;
+    EEPROM.put(0, header);
+    EEPROM.put(sizeof(Header), data);
+    return EEPROM.commit();
+}
+
+/**
+ * @brief Check if there are changes, which are not written yet
+ *
+ * @return true if a write is pending
+ */
+bool SettingsStore::isPending(){
+    return pending;
+}
+
+/**
+ * @brief Get the number of writes of the settings to the flash (since the first start, persistent)
+ *
+ * @return uint32_t number of writes
+ */
+uint32_t SettingsStore::getWriteCount(){
+    return writeCount;
+}
+
+/**
+ * @brief Get the number of changes of the settings since start
+ *
+ * @return uint32_t number of changes
+ */
+uint32_t SettingsStore::getChanges(){
+    return changes;
+}
+
+/**
+ * @brief (private) Mark the settings as changed
+ *
+ */
+void SettingsStore::changed(){
+    if(!pending){
+        firstChange = millis();
+    }
+    lastChange = millis();
+    pending = true;
+    changes++;
+}
+
+/**
+ * @brief (private) Read the settings from the old byte address map, the values are checked by the sketch.
+ * Layout and timezone were added to the old map later, on clocks with an older firmware these bytes are
+ * erased flash (0xFF), so they are only taken over if they are valid.
+ *
+ */
+void SettingsStore::loadLegacy(){
+    data.nightModeStartHour = EEPROM.read(LEGACY_ADR_NM_START_H);
+    data.nightModeStartMin = EEPROM.read(LEGACY_ADR_NM_START_M);
+    data.nightModeEndHour = EEPROM.read(LEGACY_ADR_NM_END_H);
+    data.nightModeEndMin = EEPROM.read(LEGACY_ADR_NM_END_M);
+    data.nightModeActivated = EEPROM.read(LEGACY_ADR_NM_ACTIVATED);
+    data.nightModeBrightness = EEPROM.read(LEGACY_ADR_NM_BRIGHTNESS);
+    data.brightness = EEPROM.read(LEGACY_ADR_BRIGHTNESS);
+    data.mainColorRed = EEPROM.read(LEGACY_ADR_MC_RED);
+    data.mainColorGreen = EEPROM.read(LEGACY_ADR_MC_GREEN);
+    data.mainColorBlue = EEPROM.read(LEGACY_ADR_MC_BLUE);
+    data.state = EEPROM.read(LEGACY_ADR_STATE);
+    data.colorShiftSpeed = EEPROM.read(LEGACY_ADR_COLSHIFTSPEED);
+    data.colorShiftActive = EEPROM.read(LEGACY_ADR_COLSHIFTACTIVE);
+    uint8_t layout = EEPROM.read(LEGACY_ADR_LAYOUT);
+    if(isLayoutAvailable(layout)){
+        data.layout = layout;
+    }
+
+    // the cached timezone needs to be a complete, printable and valid POSIX TZ string, otherwise it is refreshed
+    char rule[TZ_RULE_MAX_LEN];
+    bool valid = false;
+    for(uint8_t i = 0; i < TZ_RULE_MAX_LEN; i++){
+        rule[i] = EEPROM.read(LEGACY_ADR_TZ_RULE + i);
+        if(rule[i] == '\0'){
+            valid = i > 0;
+            break;
+        }
+        if(rule[i] < 0x20 || rule[i] > 0x7E){
+            break;
+        }
+    }
+    TimezoneRule check;
+    memset(data.tzRule, 0, TZ_RULE_MAX_LEN);
+    data.tzExpires = 0;
+    if(valid && check.parse(rule)){
+        strncpy(data.tzRule, rule, TZ_RULE_MAX_LEN - 1);
+        EEPROM.get(LEGACY_ADR_TZ_EXPIRES, data.tzExpires);
+    }
+}
+
+/**
+ * @brief (private) Calculate the CRC32 (polynomial 0xEDB88320) of a block of data
+ *
+ * @param data data
+ * @param length length of the data
+ * @return uint32_t CRC32
+ */
+uint32_t SettingsStore::crc32(const uint8_t *data, size_t length){
+    uint32_t crc = 0xFFFFFFFF;
+    for(size_t i = 0; i < length; i++){
+        crc ^= data[i];
+        for(uint8_t bit = 0; bit < 8; bit++){
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
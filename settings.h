@@ -0,0 +1,89 @@
+/**
+ * @file settings.h
+ * @brief Typed store for the persistent settings in the emulated EEPROM (flash)
+ *
+ * The settings are kept as one struct with a header (version, write counter, CRC32). Changes are only
+ * made in RAM, the flash sector is written after the settings have not been changed for SETTINGS_COMMIT_DELAY ms,
+ * so a series of changes (e.g. moving a slider) results in one write. If nothing has changed compared to
+ * the stored settings, the write is skipped. The write counter is stored in the header for monitoring the flash wear.
+ *
+ * Usage:
+ *  settings.begin(defaults);
+ *  settings.set(&Settings::brightness, 40);
+ *  uint8_t b = settings.get().brightness;
+ *  settings.handle();      // regularly, writes the settings after the quiet period
+ *
+ */
+
+#ifndef settings_h
+#define settings_h
+
+#include <Arduino.h>
+#include <EEPROM.h>
+
+#define SETTINGS_VERSION 4                  // change this value when the struct Settings or the defaults change
+#define SETTINGS_LEGACY_VERSION 3           // version of the old byte address map, which is migrated on the first start
+#define SETTINGS_COMMIT_DELAY 3000          // quiet period (ms) after the last change until the settings are written
+#define SETTINGS_MAX_COMMIT_DELAY 30000     // max. delay (ms) of a write if the settings are changed continuously
+#define TZ_RULE_MAX_LEN 48                  // max. length of POSIX TZ string incl. terminating zero
+
+struct Settings {
+    uint8_t nightModeStartHour;
+    uint8_t nightModeStartMin;
+    uint8_t nightModeEndHour;
+    uint8_t nightModeEndMin;
+    uint8_t nightModeActivated;
+    uint8_t nightModeBrightness;
+    uint8_t brightness;
+    uint8_t mainColorRed;
+    uint8_t mainColorGreen;
+    uint8_t mainColorBlue;
+    uint8_t state;
+    uint8_t colorShiftSpeed;
+    uint8_t colorShiftActive;
+    uint8_t layout;
+    uint8_t reserved[2];                    // explicit padding (included in the CRC)
+    uint32_t tzExpires;                     // UNIX time when the cached timezone needs to be refreshed
+    char tzRule[TZ_RULE_MAX_LEN];           // cached timezone (POSIX TZ string)
+};
+
+class SettingsStore{
+
+    public:
+        SettingsStore();
+        bool begin(const Settings &defaults);
+        const Settings& get();
+        template<typename T, typename V> void set(T Settings::*field, V value){
+            if(data.*field != (T)value){
+                data.*field = (T)value;
+                changed();
+            }
+        }
+        void setTimezoneRule(const char *rule);
+        void handle();
+        bool commit();
+        bool isPending();
+        uint32_t getWriteCount();
+        uint32_t getChanges();
+
+    private:
+        struct Header {
+            uint8_t version;
+            uint8_t reserved[3];
+            uint32_t writeCount;            // number of writes of the settings since the first start
+            uint32_t crc;                   // CRC32 of the settings
+        };
+
+        Settings data;
+        uint32_t writeCount = 0;
+        uint32_t changes = 0;
+        bool pending = false;
+        unsigned long firstChange = 0;      // millis() of the first change since the last write
+        unsigned long lastChange = 0;       // millis() of the last change
+
+        void changed();
+        void loadLegacy();
+        static uint32_t crc32(const uint8_t *data, size_t length);
+};
+
+#endif
@@ -0,0 +1,385 @@
+#include "settingsjournal.h"
+
+/**
+ * @brief Construct a new SettingsJournal object
+ *
+ * @param myfs pointer to the filesystem (LittleFS, needs to be mounted before begin())
+ */
+SettingsJournal::SettingsJournal(FS *myfs){
+    fs = myfs;
+}
+
+/**
+ * @brief Load the snapshot and replay the journal. An incomplete record at the end of the journal
+ * (power loss during a change) is dropped by a compaction.
+ *
+ * @return true if snapshot and journal were valid
+ */
+bool SettingsJournal::begin(){
+    dataLength = 0;
+    logSize = 0;
+
+    // a compaction was interrupted before the rename, the old snapshot and the journal are still complete
+    if(fs->exists(JOURNAL_TMP_PATH)){
+        fs->remove(JOURNAL_TMP_PATH);
+    }
+
+    bool valid = true;
+    if(fs->exists(JOURNAL_SNAPSHOT_PATH)){
+        valid = loadSnapshot();
+    }
+    if(fs->exists(JOURNAL_LOG_PATH)){
+        File file = fs->open(JOURNAL_LOG_PATH, "r");
+        if(file){
+            uint32_t size = file.size();
+            logSize = readRecords(file, size, NULL);
+            file.close();
+            if(logSize < size){
+                // new records would be appended after the invalid bytes and could not be read anymore
+                valid = false;
+                compact();
+            }
+        }
+    }
+    return valid;
+}
+
+/**
+ * @brief Set a value, the change is appended to the journal before it is applied
+ *
+ * @param key key of the value
+ * @param value value
+ * @param length length of the value (max. JOURNAL_MAX_VALUE_LEN)
+ * @return true if the value was stored (also if it was unchanged)
+ */
+bool SettingsJournal::set(uint16_t key, const void *value, uint8_t length){
+    if(length > JOURNAL_MAX_VALUE_LEN){
+        return false;
+    }
+    int16_t pos = find(key);
+    if(pos >= 0 && data[pos + 2] == length && memcmp(data + pos + 3, value, length) == 0){
+        return true;
+    }
+    if(!fits(key, length) || !append(key, (const uint8_t*)value, length, false)){
+        return false;
+    }
+    store(key, (const uint8_t*)value, length, false);
+    if(logSize > JOURNAL_MAX_LOG_SIZE){
+        compact();
+    }
+    return true;
+}
+
+/**
+ * @brief Get a value
+ *
+ * @param key key of the value
+ * @param value buffer for the value
+ * @param maxLength size of the buffer (the value is truncated if the buffer is too small)
+ * @return int16_t length of the stored value, -1 if the key does not exist
+ */
+int16_t SettingsJournal::get(uint16_t key, void *value, uint8_t maxLength){
+    int16_t pos = find(key);
+    if(pos < 0){
+        return -1;
+    }
+    uint8_t length = data[pos + 2];
+    memcpy(value, data + pos + 3, min(length, maxLength));
+    return length;
+}
+
+/**
+ * @brief Remove a value
+ *
+ * @param key key of the value
+ * @return true if the value was removed (also if it did not exist)
+ */
+bool SettingsJournal::remove(uint16_t key){
+    if(find(key) < 0){
+        return true;
+    }
+    if(!append(key, NULL, 0, true)){
+        return false;
+    }
+    store(key, NULL, 0, true);
+    if(logSize > JOURNAL_MAX_LOG_SIZE){
+        compact();
+    }
+    return true;
+}
+
+/**
+ * @brief Write all values as new snapshot and delete the journal. The snapshot is written to a temporary
+ * file first, which replaces the old snapshot by rename, so there is always one complete snapshot.
+ *
+ * @return true if the snapshot was written
+ */
+bool SettingsJournal::compact(){
+    uint8_t record[RECORD_HEADER_SIZE + JOURNAL_MAX_VALUE_LEN + RECORD_CRC_SIZE];
+    SnapshotHeader header;
+    header.magic[0] = 'W';
+    header.magic[1] = 'J';
+    header.version = JOURNAL_SNAPSHOT_VERSION;
+    header.reserved = 0;
+    header.length = 0;
+    header.crc = 0xFFFF;
+    for(uint16_t pos = 0; pos < dataLength; pos += 3 + data[pos + 2]){
+        uint16_t size = formatRecord(record, data[pos] | (data[pos + 1] << 8), data + pos + 3, data[pos + 2], false);
+        header.length += size;
+        header.crc = crc16(record, size, header.crc);
+    }
+
+    File file = fs->open(JOURNAL_TMP_PATH, "w");
+    if(!file){
+        return false;
+    }
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+    for(uint16_t pos = 0; ok && pos < dataLength; pos += 3 + data[pos + 2]){
+        uint16_t size = formatRecord(record, data[pos] | (data[pos + 1] << 8), data + pos + 3, data[pos + 2], false);
+        ok = file.write(record, size) == size;
+    }
+    file.close();
+
+    // rename replaces the old snapshot atomically (LittleFS)
+    if(!ok || !fs->rename(JOURNAL_TMP_PATH, JOURNAL_SNAPSHOT_PATH)){
+        fs->remove(JOURNAL_TMP_PATH);
+        return false;
+    }
+    // if the power is lost before the journal is deleted, it is replayed on top of the new snapshot,
+    // which results in the same values
+    fs->remove(JOURNAL_LOG_PATH);
+    logSize = 0;
+    compactions++;
+    return true;
+}
+
+/**
+ * @brief Get the number of stored keys
+ *
+ * @return uint16_t number of keys
+ */
+uint16_t SettingsJournal::getNumKeys(){
+    uint16_t num = 0;
+    for(uint16_t pos = 0; pos < dataLength; pos += 3 + data[pos + 2]){
+        num++;
+    }
+    return num;
+}
+
+/**
+ * @brief Get the size of the journal file
+ *
+ * @return uint32_t size in bytes
+ */
+uint32_t SettingsJournal::getLogSize(){
+    return logSize;
+}
+
+/**
+ * @brief Get the number of records appended to the journal since start
+ *
+ * @return uint32_t number of records
+ */
+uint32_t SettingsJournal::getAppends(){
+    return appends;
+}
+
+/**
+ * @brief Get the number of compactions since start
+ *
+ * @return uint32_t number of compactions
+ */
+uint32_t SettingsJournal::getCompactions(){
+    return compactions;
+}
+
+/**
+ * @brief (private) Find the entry of a key in RAM
+ *
+ * @param key key of the value
+ * @return int16_t position of the entry in data, -1 if the key does not exist
+ */
+int16_t SettingsJournal::find(uint16_t key){
+    for(uint16_t pos = 0; pos < dataLength; pos += 3 + data[pos + 2]){
+        if((data[pos] | (data[pos + 1] << 8)) == key){
+            return pos;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief (private) Check if a value fits into the RAM (replacing the old value of the key)
+ *
+ * @param key key of the value
+ * @param length length of the value
+ * @return true if there is enough space
+ */
+bool SettingsJournal::fits(uint16_t key, uint8_t length){
+    int16_t pos = find(key);
+    uint16_t used = dataLength - (pos >= 0 ? 3 + data[pos + 2] : 0);
+    return used + 3 + length <= JOURNAL_DATA_SIZE;
+}
+
+/**
+ * @brief (private) Apply a change in RAM, the space needs to be checked by fits() before
+ *
+ * @param key key of the value
+ * @param value value
+ * @param length length of the value
+ * @param removed true to remove the key
+ */
+void SettingsJournal::store(uint16_t key, const uint8_t *value, uint8_t length, bool removed){
+    int16_t pos = find(key);
+    if(pos >= 0){
+        uint16_t size = 3 + data[pos + 2];
+        memmove(data + pos, data + pos + size, dataLength - pos - size);
+        dataLength -= size;
+    }
+    if(!removed){
+        data[dataLength] = key & 0xFF;
+        data[dataLength + 1] = key >> 8;
+        data[dataLength + 2] = length;
+        memcpy(data + dataLength + 3, value, length);
+        dataLength += 3 + length;
+    }
+}
+
+/**
+ * @brief (private) Append a record to the journal
+ *
+ * @param key key of the value
+ * @param value value
+ * @param length length of the value
+ * @param removed true if the key is removed
+ * @return true if the record was written completely
+ */
+bool SettingsJournal::append(uint16_t key, const uint8_t *value, uint8_t length, bool removed){
+    uint8_t record[RECORD_HEADER_SIZE + JOURNAL_MAX_VALUE_LEN + RECORD_CRC_SIZE];
+    uint16_t size = formatRecord(record, key, value, length, removed);
+    File file = fs->open(JOURNAL_LOG_PATH, "a");
+    if(!file){
+        return false;
+    }
+    size_t written = file.write(record, size);
+    file.close();
+    if(written != size){
+        // remove the incomplete record, otherwise all following records would be ignored at the next start
+        compact();
+        return false;
+    }
+    logSize += size;
+    appends++;
+    return true;
+}
+
+/**
+ * @brief (private) Write a record into a buffer
+ *
+ * @param record buffer (min. RECORD_HEADER_SIZE + length + RECORD_CRC_SIZE bytes)
+ * @param key key of the value
+ * @param value value
+ * @param length length of the value
+ * @param removed true if the key is removed
+ * @return uint16_t size of the record
+ */
+uint16_t SettingsJournal::formatRecord(uint8_t *record, uint16_t key, const uint8_t *value, uint8_t length, bool removed){
+    record[0] = key & 0xFF;
+    record[1] = key >> 8;
+    record[2] = length;
+    record[3] = removed ? FLAG_REMOVED : 0;
+    if(length > 0){
+        memcpy(record + RECORD_HEADER_SIZE, value, length);
+    }
+    uint16_t size = RECORD_HEADER_SIZE + length;
+    uint16_t crc = crc16(record, size, 0xFFFF);
+    record[size] = crc & 0xFF;
+    record[size + 1] = crc >> 8;
+    return size + RECORD_CRC_SIZE;
+}
+
+/**
+ * @brief (private) Read records from the current position of a file and apply them in RAM,
+ * stops at the first invalid record
+ *
+ * @param file opened file
+ * @param length number of bytes to read
+ * @param crc if not NULL, the CRC16 of the valid records is calculated (start value needs to be set)
+ * @return uint32_t number of bytes of the valid records
+ */
+uint32_t SettingsJournal::readRecords(File &file, uint32_t length, uint16_t *crc){
+    uint8_t record[RECORD_HEADER_SIZE + JOURNAL_MAX_VALUE_LEN + RECORD_CRC_SIZE];
+    uint32_t position = 0;
+    while(position + RECORD_HEADER_SIZE + RECORD_CRC_SIZE <= length){
+        if(file.read(record, RECORD_HEADER_SIZE) != RECORD_HEADER_SIZE){
+            break;
+        }
+        uint8_t valueLength = record[2];
+        uint16_t size = RECORD_HEADER_SIZE + valueLength + RECORD_CRC_SIZE;
+        if(valueLength > JOURNAL_MAX_VALUE_LEN || position + size > length){
+            break;
+        }
+        if(file.read(record + RECORD_HEADER_SIZE, valueLength + RECORD_CRC_SIZE) != (size_t)(valueLength + RECORD_CRC_SIZE)){
+            break;
+        }
+        uint16_t recordCrc = record[size - 2] | (record[size - 1] << 8);
+        if(crc16(record, size - RECORD_CRC_SIZE, 0xFFFF) != recordCrc){
+            break;
+        }
+        uint16_t key = record[0] | (record[1] << 8);
+        bool removed = record[3] & FLAG_REMOVED;
+        if(!removed && !fits(key, valueLength)){
+            break;
+        }
+        store(key, record + RECORD_HEADER_SIZE, valueLength, removed);
+        if(crc != NULL){
+            *crc = crc16(record, size, *crc);
+        }
+        position += size;
+    }
+    return position;
+}
+
+/**
+ * @brief (private) Load the snapshot, the values are only kept if the complete snapshot is valid
+ *
+ * @return true if the snapshot is valid
+ */
+bool SettingsJournal::loadSnapshot(){
+    File file = fs->open(JOURNAL_SNAPSHOT_PATH, "r");
+    if(!file){
+        return false;
+    }
+    SnapshotHeader header;
+    bool valid = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header)
+                    && header.magic[0] == 'W' && header.magic[1] == 'J'
+                    && header.version == JOURNAL_SNAPSHOT_VERSION
+                    && header.length == file.size() - sizeof(header);
+    if(valid){
+        uint16_t crc = 0xFFFF;
+        valid = readRecords(file, header.length, &crc) == header.length && crc == header.crc;
+    }
+    file.close();
+    if(!valid){
+        dataLength = 0;
+    }
+    return valid;
+}
+
+/**
+ * @brief (private) Calculate the CRC16 (CCITT, polynomial 0x1021) of a block of data
+ *
+ * @param data data
+ * @param length length of the data
+ * @param crc start value (0xFFFF) or CRC of the previous block
+ * @return uint16_t CRC16
+ */
+uint16_t SettingsJournal::crc16(const uint8_t *data, size_t length, uint16_t crc){
+    for(size_t i = 0; i < length; i++){
+        crc ^= (uint16_t)data[i] << 8;
+        for(uint8_t bit = 0; bit < 8; bit++){
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file settingsjournal.h
+ * @brief Key/value store on LittleFS, changes are appended to a journal instead of rewriting a flash sector
+ *
+ * All values are kept in RAM. Each change is appended as a record (key, length, value, CRC16) to the journal file.
+ * If the journal gets larger than JOURNAL_MAX_LOG_SIZE, all values are written as snapshot to a temporary file,
+ * which replaces the old snapshot by rename (atomic in LittleFS), afterwards the journal is deleted.
+ * At start the snapshot and the journal are read sequentially. A record, which was not written completely
+ * (power loss), has an invalid CRC and is ignored together with all following bytes, so each change is
+ * either completely stored or not at all.
+ *
+ * Usage:
+ *  SettingsJournal journal(&LittleFS);
+ *  journal.begin();
+ *  journal.set(0x0100, color, 3);
+ *  journal.get(0x0100, color, sizeof(color));
+ *
+ */
+
+#ifndef settingsjournal_h
+#define settingsjournal_h
+
+#include <Arduino.h>
+#include <FS.h>
+
+#define JOURNAL_SNAPSHOT_PATH "/settings.snap"
+#define JOURNAL_LOG_PATH "/settings.log"
+#define JOURNAL_TMP_PATH "/settings.tmp"
+#define JOURNAL_DATA_SIZE 1024              // RAM for all values (incl. 3 bytes per key)
+#define JOURNAL_MAX_VALUE_LEN 64            // max. length of one value
+#define JOURNAL_MAX_LOG_SIZE 4096           // size of the journal (bytes) which triggers a compaction
+#define JOURNAL_SNAPSHOT_VERSION 1
+
+class SettingsJournal{
+
+    public:
+        SettingsJournal(FS *myfs);
+        bool begin();
+        bool set(uint16_t key, const void *value, uint8_t length);
+        int16_t get(uint16_t key, void *value, uint8_t maxLength);
+        bool remove(uint16_t key);
+        bool compact();
+        uint16_t getNumKeys();
+        uint32_t getLogSize();
+        uint32_t getAppends();
+        uint32_t getCompactions();
+
+    private:
+        // record in snapshot and journal: key (2 bytes), length (1), flags (1), value (length), CRC16 (2)
+        static const uint8_t RECORD_HEADER_SIZE = 4;
+        static const uint8_t RECORD_CRC_SIZE = 2;
+        static const uint8_t FLAG_REMOVED = 0x01;
+
+        struct SnapshotHeader {
+            char magic[2];                  // 'W', 'J'
+            uint8_t version;
+            uint8_t reserved;
+            uint16_t length;                // length of all records
+            uint16_t crc;                   // CRC16 of all records
+        };
+
+        FS *fs;
+        uint8_t data[JOURNAL_DATA_SIZE];    // entries: key (2 bytes), length (1), value (length)
+        uint16_t dataLength = 0;
+        uint32_t logSize = 0;
+        uint32_t appends = 0;
+        uint32_t compactions = 0;
+
+        int16_t find(uint16_t key);
+        bool fits(uint16_t key, uint8_t length);
+        void store(uint16_t key, const uint8_t *value, uint8_t length, bool removed);
+        bool append(uint16_t key, const uint8_t *value, uint8_t length, bool removed);
+        uint16_t formatRecord(uint8_t *record, uint16_t key, const uint8_t *value, uint8_t length, bool removed);
+        uint32_t readRecords(File &file, uint32_t length, uint16_t *crc);
+        bool loadSnapshot();
+        static uint16_t crc16(const uint8_t *data, size_t length, uint16_t crc);
+};
+
+#endif
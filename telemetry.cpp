@@ -0,0 +1,52 @@
+#include "telemetry.h"
+
+/**
+ * @brief Construct a new Telemetry object
+ *
+ */
+Telemetry::Telemetry(){
+
+}
+
+/**
+ * @brief Start sending telemetry frames
+ *
+ * @param interfaceAddr ip address of the own network interface
+ * @param multicastAddr multicast group
+ * @param port UDP port
+ */
+void Telemetry::begin(IPAddress interfaceAddr, IPAddress multicastAddr, uint16_t port){
+    this->interfaceAddr = interfaceAddr;
+    this->multicastAddr = multicastAddr;
+    this->port = port;
+    running = true;
+}
+
+/**
+ * @brief Send a telemetry frame, header (magic, version) and sequence number are set here
+ *
+ * @param frame frame with the current values
+ */
+void Telemetry::send(TelemetryFrame &frame){
+    if(!running){
+        return;
+    }
+    frame.magic[0] = TELEMETRY_MAGIC0;
+    frame.magic[1] = TELEMETRY_MAGIC1;
+    frame.version = TELEMETRY_VERSION;
+    frame.reserved = 0;
+    frame.sequence = sequence++;
+
+    udp.beginPacketMulticast(multicastAddr, port, interfaceAddr);
+    udp.write((const uint8_t*)&frame, sizeof(frame));
+    udp.endPacket();
+}
+
+/**
+ * @brief Get the number of frames sent since start
+ *
+ * @return uint32_t number of frames
+ */
+uint32_t Telemetry::getFramesSent(){
+    return sequence;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file telemetry.h
+ * @brief Class for sending binary telemetry frames as multicast messages
+ *
+ * The frame is a packed struct in little endian byte order (native order of the ESP8266),
+ * decoded by telemetry_receiver.py. New fields are only appended, the version is increased
+ * if the meaning of existing fields changes.
+ *
+ */
+
+#ifndef telemetry_h
+#define telemetry_h
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+
+#define TELEMETRY_PORT 8124
+#define TELEMETRY_MAGIC0 'W'
+#define TELEMETRY_MAGIC1 'T'
+#define TELEMETRY_VERSION 1
+
+#define TELEMETRY_FLAG_NTP_SYNCED 0x01
+#define TELEMETRY_FLAG_NIGHTMODE 0x02
+#define TELEMETRY_FLAG_LED_OFF 0x04
+#define TELEMETRY_FLAG_LED_DIRECT 0x08
+
+struct __attribute__((packed)) TelemetryFrame {
+    uint8_t magic[2];           // 'W', 'T'
+    uint8_t version;            // TELEMETRY_VERSION
+    uint8_t state;              // current state of the clock
+    uint32_t sequence;          // incremented with each frame (detect lost frames)
+    uint32_t uptime;            // ms
+    uint32_t freeHeap;          // bytes
+    uint32_t maxFreeBlock;      // bytes
+    uint8_t heapFragmentation;  // %
+    int8_t rssi;                // dBm
+    uint8_t flags;              // TELEMETRY_FLAG_xxx
+    uint8_t reserved;
+    int32_t ntpOffset;          // ms, offset measured at the last NTP update
+    int32_t ntpDrift;           // ppb
+    uint16_t ledCurrent;        // mA, estimated
+    uint16_t streamFps;         // frames per second of the UDP LED stream
+    uint32_t loopCount;         // loop cycles since boot or reset of the statistics
+    uint32_t loopAvg;           // us
+    uint32_t loopP99;           // us
+    uint32_t loopMax;           // us
+    uint32_t logDrops;          // dropped log messages since boot
+};
+
+class Telemetry{
+
+    public:
+        Telemetry();
+        void begin(IPAddress interfaceAddr, IPAddress multicastAddr, uint16_t port);
+        void send(TelemetryFrame &frame);
+        uint32_t getFramesSent();
+
+    private:
+        IPAddress multicastAddr;
+        IPAddress interfaceAddr;
+        uint16_t port = TELEMETRY_PORT;
+        WiFiUDP udp;
+        bool running = false;
+        uint32_t sequence = 0;
+};
+
+#endif
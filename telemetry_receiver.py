@@ -0,0 +1,101 @@
+import argparse
+import csv
+import socket
+import struct
+import sys
+from datetime import datetime
+
+# ip address of network interface
+MCAST_IF_IP = '192.168.178.38'
+
+MULTICAST_GROUP = '230.120.10.2'
+TELEMETRY_PORT = 8124
+
+# layout of the telemetry frame (see telemetry.h), little endian
+FRAME_FORMAT = '<2sBBIIIIBbBBiiHHIIIII'
+FRAME_SIZE = struct.calcsize(FRAME_FORMAT)
+FRAME_MAGIC = b'WT'
+FRAME_VERSION = 1
+FIELDS = ['magic', 'version', 'state', 'sequence', 'uptime_ms', 'free_heap', 'max_free_block', 'heap_frag',
+          'rssi', 'flags', 'reserved', 'ntp_offset_ms', 'ntp_drift_ppb', 'led_current_ma', 'stream_fps',
+          'loop_count', 'loop_avg_us', 'loop_p99_us', 'loop_max_us', 'log_drops']
+
+STATE_NAMES = ['Clock', 'DiClock', 'Sprial', 'Tetris', 'Snake', 'PingPong']
+FLAG_NAMES = {0x01: 'ntp', 0x02: 'night', 0x04: 'off', 0x08: 'direct'}
+
+CSV_COLUMNS = ['time', 'ip', 'lost'] + [f for f in FIELDS if f not in ('magic', 'version', 'reserved')]
+
+
+def decode(data):
+    """Decode a telemetry frame into a dict, returns None for unknown packets.
+    Other versions are rejected (the meaning of fields changed), longer frames with appended fields are accepted
+    and the additional fields are ignored."""
+    if len(data) < FRAME_SIZE or data[:2] != FRAME_MAGIC or data[2] != FRAME_VERSION:
+        return None
+    return dict(zip(FIELDS, struct.unpack_from(FRAME_FORMAT, data)))
+
+
+def format_frame(ip, frame, lost):
+    state = STATE_NAMES[frame['state']] if frame['state'] < len(STATE_NAMES) else str(frame['state'])
+    flags = ','.join(name for bit, name in FLAG_NAMES.items() if frame['flags'] & bit)
+    return (f"{ip:15} up {frame['uptime_ms'] / 1000:9.0f}s  {state:8} heap {frame['free_heap']:6} "
+            f"blk {frame['max_free_block']:6} frag {frame['heap_frag']:2}%  rssi {frame['rssi']:4}  "
+            f"ntp {frame['ntp_offset_ms']:5}ms  {frame['led_current_ma']:5}mA  "
+            f"loop avg/p99/max {frame['loop_avg_us']}/{frame['loop_p99_us']}/{frame['loop_max_us']}us  "
+            f"[{flags}] lost {lost}")
+
+
+def start(output, quiet):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind(('', TELEMETRY_PORT))
+    mreq = struct.pack('4s4s', socket.inet_aton(MULTICAST_GROUP), socket.inet_aton(MCAST_IF_IP))
+    sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, mreq)
+
+    writer = None
+    csv_file = None
+    if output:
+        csv_file = open(output, 'a', newline='')
+        writer = csv.DictWriter(csv_file, fieldnames=CSV_COLUMNS, extrasaction='ignore')
+        if csv_file.tell() == 0:
+            writer.writeheader()
+
+    # last sequence number per clock to count lost frames
+    last_sequence = {}
+
+    print(f"Listening for telemetry on {MULTICAST_GROUP}:{TELEMETRY_PORT}", file=sys.stderr)
+    try:
+        while True:
+            data, address = sock.recvfrom(1024)
+            frame = decode(data)
+            if frame is None:
+                continue
+            ip = address[0]
+
+            lost = 0
+            previous = last_sequence.get(ip)
+            # a smaller sequence number means the clock was restarted
+            if previous is not None and frame['sequence'] > previous:
+                lost = frame['sequence'] - previous - 1
+            last_sequence[ip] = frame['sequence']
+
+            if not quiet:
+                print(format_frame(ip, frame, lost))
+            if writer:
+                writer.writerow(dict(frame, time=datetime.now().isoformat(timespec='seconds'), ip=ip, lost=lost))
+                csv_file.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if csv_file:
+            csv_file.close()
+
+
+# Main
+if __name__ == '__main__':
+    # Usage: python3 telemetry_receiver.py [--output telemetry.csv] [--quiet]
+    parser = argparse.ArgumentParser(description='Receive the binary telemetry frames of all wordclocks in the network')
+    parser.add_argument('--output', help='append the frames to this CSV file (one row per frame)')
+    parser.add_argument('--quiet', action='store_true', help='do not print the frames')
+    args = parser.parse_args()
+    start(args.output, args.quiet)
@@ -0,0 +1,100 @@
+/**
+ * @file bench_frames.cpp
+ * @brief Frame benchmark of the complete sketch: runs setup() and then the loop in each ClockState
+ *
+ * The loop runs for BENCH_SECONDS of fake time per state (each loop cycle costs BENCH_LOOP_COST_US of fake time
+ * plus the sleep of the loop). For each state the number of frames sent to the LEDs (show() of the fake
+ * NeoMatrix), the host CPU time of the loop cycles which rendered a frame and the heap allocations are reported.
+ * The CPU time is measured on the host and only comparable between runs on the same machine.
+ *
+ */
+
+#include <Arduino.h>
+#include <Adafruit_NeoMatrix.h>
+#include <chrono>
+#include <new>
+#include "ledmatrix.h"
+
+#define BENCH_SECONDS 60
+#define BENCH_LOOP_COST_US 200
+
+static const char *stateNames[] = {"clock", "diclock", "spiral", "tetris", "snake", "pingpong"};
+
+void setup();
+void loop();
+void stateChange(uint8_t newState, bool persistant);
+extern Adafruit_NeoMatrix matrix;
+
+// ----------------------------------------------------------------------------------
+//                                        ALLOCATION COUNTER
+// ----------------------------------------------------------------------------------
+
+static bool countAllocations = false;
+static uint32_t allocations = 0;
+static uint64_t allocatedBytes = 0;
+
+extern "C" void *__real_malloc(size_t size);
+extern "C" void *__wrap_malloc(size_t size){
+    if(countAllocations){
+        allocations++;
+        allocatedBytes += size;
+    }
+    return __real_malloc(size);
+}
+
+void *operator new(size_t size){
+    void *p = malloc(size ? size : 1);
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size){
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+// ----------------------------------------------------------------------------------
+//                                        BENCHMARK
+// ----------------------------------------------------------------------------------
+
+int main(){
+    setup();
+
+    printf("%-9s %7s %8s %10s %10s %8s %10s\n", "state", "frames", "changed", "avg us", "max us", "allocs", "bytes");
+    for(uint8_t state = 0; state < 6; state++){
+        stateChange(state, false);
+        uint32_t shows = matrix.shows;
+        uint32_t changed = matrix.changedShows;
+        uint32_t frames = 0;
+        double total = 0;
+        double maximum = 0;
+        allocations = 0;
+        allocatedBytes = 0;
+        unsigned long start = millis();
+
+        while(millis() - start < BENCH_SECONDS * 1000UL){
+            uint32_t before = matrix.shows;
+            countAllocations = true;
+            auto t0 = std::chrono::steady_clock::now();
+            loop();
+            auto t1 = std::chrono::steady_clock::now();
+            countAllocations = false;
+            advanceTime(BENCH_LOOP_COST_US);
+            if(matrix.shows != before){
+                double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+                frames++;
+                total += us;
+                maximum = std::max(maximum, us);
+            }
+        }
+
+        printf("%-9s %7u %8u %10.2f %10.2f %8u %10llu\n", stateNames[state], matrix.shows - shows,
+               matrix.changedShows - changed, frames ? total / frames : 0.0, maximum, allocations,
+               (unsigned long long)allocatedBytes);
+    }
+    return 0;
+}
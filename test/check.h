@@ -0,0 +1,34 @@
+/**
+ * @file check.h
+ * @brief Minimal checks for the host tests, a failed check is printed and the test returns 1
+ *
+ */
+
+#ifndef check_h
+#define check_h
+
+#include <stdio.h>
+
+static int checkFailures = 0;
+
+#define CHECK(condition) do { \
+        if(!(condition)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            checkFailures++; \
+        } \
+    } while(0)
+
+#define CHECK_EQUAL(actual, expected) do { \
+        long long a_ = (long long)(actual), e_ = (long long)(expected); \
+        if(a_ != e_) { \
+            printf("%s:%d: check failed: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_); \
+            checkFailures++; \
+        } \
+    } while(0)
+
+inline int checkResult(){
+    printf(checkFailures ? "FAILED (%d checks)\n" : "OK\n", checkFailures);
+    return checkFailures ? 1 : 0;
+}
+
+#endif
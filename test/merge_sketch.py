@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""
+Merge the .ino files of the sketch into one C++ file like the Arduino builder does:
+the main .ino first, then all other .ino files in alphabetical order, with prototypes for all
+functions inserted before the first function definition.
+
+usage: merge_sketch.py <sketch dir> <main .ino> <output .cpp>
+"""
+
+import os
+import re
+import sys
+
+# function definition starting in column 0, the opening brace on the same or the next line
+FUNCTION = re.compile(r'^(?!(?:if|else|for|while|switch|return|do)\b)([A-Za-z_][\w:<>\*&\s]*?[\s\*&])([A-Za-z_]\w*)\s*\(([^;{}()]*)\)\s*(?:\{.*)?$')
+KEYWORDS = ('if', 'for', 'while', 'switch', 'return', 'sizeof')
+
+
+def strip_comment(line):
+    return re.sub(r'//.*$', '', line).rstrip()
+
+
+def main():
+    sketchdir, mainfile, output = sys.argv[1:4]
+    files = [mainfile] + sorted(f for f in os.listdir(sketchdir) if f.endswith('.ino') and f != mainfile)
+
+    lines = []          # (file, line number, text)
+    for name in files:
+        with open(os.path.join(sketchdir, name), encoding='utf-8') as f:
+            for number, text in enumerate(f.read().split('\n'), 1):
+                lines.append((name, number, text))
+
+    prototypes = []
+    first = None
+    inComment = False
+    for i, (name, number, text) in enumerate(lines):
+        code = strip_comment(text)
+        if inComment:
+            inComment = '*/' not in code
+            continue
+        if code.lstrip().startswith('/*'):
+            inComment = '*/' not in code
+            continue
+        match = FUNCTION.match(code)
+        if not match or match.group(2) in KEYWORDS or '=' in match.group(3):
+            continue
+        # the opening brace needs to follow the signature (same line or next non-empty line)
+        if not code.endswith('{'):
+            following = next((strip_comment(t) for _, _, t in lines[i + 1:] if strip_comment(t).strip()), '')
+            if not following.strip().startswith('{'):
+                continue
+        prototypes.append('%s%s(%s);' % (match.group(1), match.group(2), match.group(3)))
+        if first is None:
+            first = i
+
+    with open(output, 'w', encoding='utf-8') as out:
+        out.write('#include <Arduino.h>\n')
+        current = None
+        for i, (name, number, text) in enumerate(lines):
+            if i == first:
+                out.write('#line %d "%s"\n' % (number, os.path.join(sketchdir, name)))
+                out.write('\n'.join(prototypes) + '\n')
+                current = None
+            if name != current or i == first:
+                out.write('#line %d "%s"\n' % (number, os.path.join(sketchdir, name)))
+                current = name
+            out.write(text + '\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,22 @@
+#ifndef adafruit_gfx_shim_h
+#define adafruit_gfx_shim_h
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print {
+    public:
+        Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+        virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+        virtual void fillScreen(uint16_t color) {
+            for(int16_t y = 0; y < _height; y++) for(int16_t x = 0; x < _width; x++) drawPixel(x, y, color);
+        }
+        void setTextWrap(bool wrap) { (void)wrap; }
+        int16_t width() const { return _width; }
+        int16_t height() const { return _height; }
+        size_t write(uint8_t c) override { (void)c; return 1; }
+
+    protected:
+        int16_t _width, _height;
+};
+
+#endif
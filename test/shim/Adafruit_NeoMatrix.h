@@ -0,0 +1,55 @@
+/**
+ * @file Adafruit_NeoMatrix.h
+ * @brief Host replacement of the NeoMatrix, records the pixels and counts the frames sent to the LEDs
+ *
+ */
+
+#ifndef adafruit_neomatrix_shim_h
+#define adafruit_neomatrix_shim_h
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_NeoPixel.h>
+#include <vector>
+
+#define NEO_MATRIX_TOP 0x00
+#define NEO_MATRIX_BOTTOM 0x01
+#define NEO_MATRIX_LEFT 0x00
+#define NEO_MATRIX_RIGHT 0x02
+#define NEO_MATRIX_ROWS 0x00
+#define NEO_MATRIX_COLUMNS 0x04
+#define NEO_MATRIX_PROGRESSIVE 0x00
+#define NEO_MATRIX_ZIGZAG 0x08
+
+class Adafruit_NeoMatrix : public Adafruit_GFX {
+    public:
+        Adafruit_NeoMatrix(int w, int h, uint8_t pin, uint8_t matrixType, uint16_t ledType)
+            : Adafruit_GFX(w, h), pixels(w * h, 0), shown(w * h, 0) {
+            (void)pin; (void)matrixType; (void)ledType;
+        }
+        void begin() {}
+        void setBrightness(uint8_t b) { brightness = b; }
+        uint8_t getBrightness() const { return brightness; }
+        void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+            if(x < 0 || y < 0 || x >= _width || y >= _height) return;
+            pixels[y * _width + x] = color;
+            pixelWrites++;
+        }
+        void show() {
+            shows++;
+            if(shown != pixels) changedShows++;
+            shown = pixels;
+        }
+        static uint16_t Color(uint8_t r, uint8_t g, uint8_t b) { return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3); }
+
+        uint16_t getPixel(int16_t x, int16_t y) const { return shown[y * _width + x]; }
+        uint32_t shows = 0;             // number of show() calls
+        uint32_t changedShows = 0;      // number of show() calls with a different frame than before
+        uint32_t pixelWrites = 0;       // number of drawPixel() calls
+
+    private:
+        std::vector<uint16_t> pixels;
+        std::vector<uint16_t> shown;
+        uint8_t brightness = 255;
+};
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef adafruit_neopixel_shim_h
+#define adafruit_neopixel_shim_h
+
+#include <Arduino.h>
+
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_RGB ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_KHZ800 0x0000
+#define NEO_KHZ400 0x0100
+
+#endif
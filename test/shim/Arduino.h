@@ -0,0 +1,310 @@
+/**
+ * @file Arduino.h
+ * @brief Host replacement of the Arduino core for the tests (only the parts used by the wordclock)
+ *
+ * millis() and micros() are driven by a fake clock, which is advanced by delay() and by the tests (advanceTime()).
+ *
+ */
+
+#ifndef arduino_shim_h
+#define arduino_shim_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <limits.h>
+#include <string>
+#include <functional>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define PI 3.1415926535897932384626433832795
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#include "pgmspace.h"
+
+// ----------------------------------------------------------------------------------
+//                                        TIME
+// ----------------------------------------------------------------------------------
+
+void advanceTime(unsigned long us);
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// ----------------------------------------------------------------------------------
+//                                        IO
+// ----------------------------------------------------------------------------------
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+int analogRead(uint8_t pin);
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+inline uint16_t word(uint8_t high, uint8_t low) { return (high << 8) | low; }
+
+// strlcpy() is missing in older glibc versions
+size_t shim_strlcpy(char *dst, const char *src, size_t size);
+#define strlcpy shim_strlcpy
+
+// ----------------------------------------------------------------------------------
+//                                        STRING
+// ----------------------------------------------------------------------------------
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(PSTR(s)))
+
+class String {
+    public:
+        String() {}
+        String(const char *s) : str(s ? s : "") {}
+        String(const __FlashStringHelper *s) : str(reinterpret_cast<const char *>(s)) {}
+        String(const std::string &s) : str(s) {}
+        String(char c) : str(1, c) {}
+        String(int v, unsigned char base = 10) { fromLong(v, base); }
+        String(unsigned int v, unsigned char base = 10) { fromULong(v, base); }
+        String(long v, unsigned char base = 10) { fromLong(v, base); }
+        String(unsigned long v, unsigned char base = 10) { fromULong(v, base); }
+        String(unsigned char v, unsigned char base = 10) { fromULong(v, base); }
+        String(float v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+        String(double v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+
+        const char *c_str() const { return str.c_str(); }
+        unsigned int length() const { return str.length(); }
+        bool isEmpty() const { return str.empty(); }
+        bool reserve(unsigned int size) { str.reserve(size); return true; }
+        char charAt(unsigned int i) const { return i < str.length() ? str[i] : 0; }
+        char operator[](unsigned int i) const { return charAt(i); }
+        char &operator[](unsigned int i) { return str[i]; }
+        char *begin() { return &str[0]; }
+        char *end() { return &str[0] + str.length(); }
+        void setCharAt(unsigned int i, char c) { if(i < str.length()) str[i] = c; }
+        void toCharArray(char *buffer, unsigned int size) const {
+            if(!size) return;
+            size_t n = std::min((size_t)size - 1, str.length());
+            memcpy(buffer, str.data(), n);
+            buffer[n] = 0;
+        }
+
+        String &operator=(const char *s) { str = s ? s : ""; return *this; }
+        String &operator+=(const String &s) { str += s.str; return *this; }
+        String &operator+=(const char *s) { str += s; return *this; }
+        String &operator+=(char c) { str += c; return *this; }
+        String &operator+=(int v) { return *this += String(v); }
+        String &operator+=(unsigned int v) { return *this += String(v); }
+        String &operator+=(long v) { return *this += String(v); }
+        String &operator+=(unsigned long v) { return *this += String(v); }
+        bool concat(const String &s) { str += s.str; return true; }
+        bool concat(const char *s) { str += s; return true; }
+        bool concat(char c) { str += c; return true; }
+        bool concat(const char *s, unsigned int length) { str.append(s, length); return true; }
+
+        bool operator==(const String &s) const { return str == s.str; }
+        bool operator==(const char *s) const { return str == s; }
+        bool operator!=(const String &s) const { return str != s.str; }
+        bool operator!=(const char *s) const { return str != s; }
+        bool operator<(const String &s) const { return str < s.str; }
+        bool equals(const String &s) const { return str == s.str; }
+        bool equals(const char *s) const { return str == s; }
+        bool equalsIgnoreCase(const String &s) const { return strcasecmp(str.c_str(), s.c_str()) == 0; }
+        int compareTo(const String &s) const { return str.compare(s.str); }
+        bool startsWith(const String &s) const { return str.compare(0, s.str.length(), s.str) == 0; }
+        bool endsWith(const String &s) const {
+            return str.length() >= s.str.length() && str.compare(str.length() - s.str.length(), s.str.length(), s.str) == 0;
+        }
+
+        int indexOf(char c, unsigned int from = 0) const { return find(str.find(c, from)); }
+        int indexOf(const String &s, unsigned int from = 0) const { return find(str.find(s.str, from)); }
+        int lastIndexOf(char c) const { return find(str.rfind(c)); }
+        int lastIndexOf(const String &s) const { return find(str.rfind(s.str)); }
+        String substring(unsigned int from) const { return from < str.length() ? String(str.substr(from)) : String(); }
+        String substring(unsigned int from, unsigned int to) const {
+            if(from > to) std::swap(from, to);
+            return from < str.length() ? String(str.substr(from, to - from)) : String();
+        }
+        void replace(const String &find, const String &replace) {
+            if(find.str.empty()) return;
+            for(size_t pos = str.find(find.str); pos != std::string::npos; pos = str.find(find.str, pos + replace.str.length())) {
+                str.replace(pos, find.str.length(), replace.str);
+            }
+        }
+        void remove(unsigned int index) { if(index < str.length()) str.erase(index); }
+        void remove(unsigned int index, unsigned int count) { if(index < str.length()) str.erase(index, count); }
+        void toLowerCase() { for(char &c : str) c = tolower(c); }
+        void toUpperCase() { for(char &c : str) c = toupper(c); }
+        void trim() {
+            size_t start = str.find_first_not_of(" \t\r\n");
+            size_t end = str.find_last_not_of(" \t\r\n");
+            str = start == std::string::npos ? std::string() : str.substr(start, end - start + 1);
+        }
+        long toInt() const { return atol(str.c_str()); }
+        float toFloat() const { return atof(str.c_str()); }
+
+        friend String operator+(const String &a, const String &b) { String s(a); s += b; return s; }
+        friend String operator+(const String &a, const char *b) { String s(a); s += b; return s; }
+        friend String operator+(const char *a, const String &b) { String s(a); s += b; return s; }
+        friend String operator+(const String &a, char b) { String s(a); s += b; return s; }
+        friend String operator+(const String &a, int b) { String s(a); s += b; return s; }
+        friend String operator+(const String &a, unsigned int b) { String s(a); s += b; return s; }
+        friend String operator+(const String &a, long b) { String s(a); s += b; return s; }
+        friend String operator+(const String &a, unsigned long b) { String s(a); s += b; return s; }
+
+    private:
+        std::string str;
+
+        static int find(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+        void fromLong(long v, unsigned char base) {
+            if(v < 0 && base == 10) { fromULong(-(unsigned long)v, base); str.insert(0, 1, '-'); }
+            else fromULong((unsigned long)v, base);
+        }
+        void fromULong(unsigned long v, unsigned char base) {
+            char buffer[66];
+            int i = sizeof(buffer) - 1;
+            buffer[i] = '\0';
+            do { buffer[--i] = "0123456789abcdefghijklmnopqrstuvwxyz"[v % base]; v /= base; } while(v);
+            str = buffer + i;
+        }
+        void fromDouble(double v, unsigned char decimals) {
+            char buffer[48];
+            snprintf(buffer, sizeof(buffer), "%.*f", decimals, v);
+            str = buffer;
+        }
+};
+
+// ----------------------------------------------------------------------------------
+//                                        NETWORK ADDRESS
+// ----------------------------------------------------------------------------------
+
+class IPAddress {
+    public:
+        IPAddress() : bytes{0, 0, 0, 0} {}
+        IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+        uint8_t operator[](int i) const { return bytes[i]; }
+        uint8_t &operator[](int i) { return bytes[i]; }
+        bool operator==(const IPAddress &o) const { return memcmp(bytes, o.bytes, 4) == 0; }
+        bool isSet() const { return bytes[0] || bytes[1] || bytes[2] || bytes[3]; }
+        String toString() const {
+            char buffer[16];
+            snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+            return String(buffer);
+        }
+        bool fromString(const char *s) {
+            unsigned a, b, c, d;
+            if(sscanf(s, "%u.%u.%u.%u", &a, &b, &c, &d) != 4) return false;
+            bytes[0] = a; bytes[1] = b; bytes[2] = c; bytes[3] = d;
+            return true;
+        }
+
+    private:
+        uint8_t bytes[4];
+};
+
+// ----------------------------------------------------------------------------------
+//                                        PRINT / STREAM
+// ----------------------------------------------------------------------------------
+
+class Print {
+    public:
+        virtual ~Print() {}
+        virtual size_t write(uint8_t c) = 0;
+        virtual size_t write(const uint8_t *buffer, size_t size) {
+            size_t n = 0;
+            while(size--) n += write(*buffer++);
+            return n;
+        }
+        size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+        size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+        size_t print(const String &s) { return write(s.c_str()); }
+        size_t print(const char *s) { return write(s); }
+        size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+        size_t print(char c) { return write((uint8_t)c); }
+        size_t print(const IPAddress &ip) { return print(ip.toString()); }
+        size_t print(int v, int base = 10) { return print(String(v, base)); }
+        size_t print(unsigned int v, int base = 10) { return print(String(v, base)); }
+        size_t print(long v, int base = 10) { return print(String(v, base)); }
+        size_t print(unsigned long v, int base = 10) { return print(String(v, base)); }
+        size_t print(double v, int decimals = 2) { return print(String(v, decimals)); }
+        template<typename T> size_t println(const T &v) { size_t n = print(v); return n + print("\r\n"); }
+        template<typename T> size_t println(const T &v, int format) { size_t n = print(v, format); return n + print("\r\n"); }
+        size_t println() { return print("\r\n"); }
+        size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+            char buffer[256];
+            va_list args;
+            va_start(args, format);
+            int length = vsnprintf(buffer, sizeof(buffer), format, args);
+            va_end(args);
+            return write((const uint8_t *)buffer, std::min((size_t)length, sizeof(buffer) - 1));
+        }
+        virtual void flush() {}
+};
+
+class Stream : public Print {
+    public:
+        virtual int available() = 0;
+        virtual int read() = 0;
+        virtual int peek() { return -1; }
+        void setTimeout(unsigned long timeout) { this->timeout = timeout; }
+        size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *)buffer, length); }
+        virtual size_t readBytes(uint8_t *buffer, size_t length) {
+            size_t n = 0;
+            while(n < length && available() > 0) buffer[n++] = (uint8_t)read();
+            return n;
+        }
+
+    protected:
+        unsigned long timeout = 1000;
+};
+
+class HardwareSerial : public Stream {
+    public:
+        void begin(unsigned long baud) { (void)baud; }
+        size_t write(uint8_t c) override;
+        size_t write(const uint8_t *buffer, size_t size) override;
+        using Print::write;
+        int available() override { return 0; }
+        int read() override { return -1; }
+        bool quiet = getenv("WORDCLOCK_SERIAL") == nullptr;    // set WORDCLOCK_SERIAL=1 to see the output
+};
+
+extern HardwareSerial Serial;
+
+// ----------------------------------------------------------------------------------
+//                                        ESP
+// ----------------------------------------------------------------------------------
+
+class EspClass {
+    public:
+        uint32_t getFreeHeap() { return 40000; }
+        uint8_t getHeapFragmentation() { return 5; }
+        uint32_t getMaxFreeBlockSize() { return 38000; }
+        uint8_t getCpuFreqMHz() { return 80; }
+        uint32_t getCycleCount() { return micros() * 80; }
+        String getResetReason() { return String("External System"); }
+        void restart() { restarts++; }
+        uint32_t restarts = 0;
+};
+
+extern EspClass ESP;
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef arduinoota_shim_h
+#define arduinoota_shim_h
+
+#include <Arduino.h>
+
+#define U_FLASH 0
+#define U_FS 100
+
+typedef enum { OTA_AUTH_ERROR, OTA_BEGIN_ERROR, OTA_CONNECT_ERROR, OTA_RECEIVE_ERROR, OTA_END_ERROR } ota_error_t;
+
+class ArduinoOTAClass {
+    public:
+        void setHostname(const char *hostname) { (void)hostname; }
+        void setPort(uint16_t port) { (void)port; }
+        void setPassword(const char *password) { (void)password; }
+        void setPasswordHash(const char *hash) { (void)hash; }
+        void onStart(std::function<void()> fn) { startHandler = fn; }
+        void onEnd(std::function<void()> fn) { endHandler = fn; }
+        void onProgress(std::function<void(unsigned int, unsigned int)> fn) { progressHandler = fn; }
+        void onError(std::function<void(ota_error_t)> fn) { errorHandler = fn; }
+        void begin() {}
+        void handle() {}
+        int getCommand() { return U_FLASH; }
+
+        std::function<void()> startHandler;
+        std::function<void()> endHandler;
+        std::function<void(unsigned int, unsigned int)> progressHandler;
+        std::function<void(ota_error_t)> errorHandler;
+};
+
+extern ArduinoOTAClass ArduinoOTA;
+
+#endif
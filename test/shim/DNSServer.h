@@ -0,0 +1,13 @@
+#ifndef dnsserver_shim_h
+#define dnsserver_shim_h
+
+#include <Arduino.h>
+
+class DNSServer {
+    public:
+        bool start(uint16_t port, const String &domain, const IPAddress &ip) { (void)port; (void)domain; (void)ip; return true; }
+        void processNextRequest() {}
+        void stop() {}
+};
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * @file EEPROM.h
+ * @brief Host replacement of the emulated EEPROM, commit() copies the RAM buffer to the fake flash sector
+ *
+ */
+
+#ifndef eeprom_shim_h
+#define eeprom_shim_h
+
+#include <Arduino.h>
+
+#define EEPROM_SHIM_SECTOR_SIZE 4096
+
+class EEPROMClass {
+    public:
+        EEPROMClass() { memset(flash, 0xFF, sizeof(flash)); }
+        void begin(size_t size) { this->size = std::min(size, sizeof(flash)); memcpy(buffer, flash, this->size); }
+        uint8_t read(int address) { return buffer[address]; }
+        void write(int address, uint8_t value) { buffer[address] = value; }
+        template<typename T> T &get(int address, T &t) { memcpy(&t, buffer + address, sizeof(T)); return t; }
+        template<typename T> const T &put(int address, const T &t) { memcpy(buffer + address, &t, sizeof(T)); return t; }
+        bool commit() { commits++; memcpy(flash, buffer, size); return true; }
+        size_t length() { return size; }
+
+        uint8_t flash[EEPROM_SHIM_SECTOR_SIZE];     // content of the flash sector, survives a "restart"
+        uint32_t commits = 0;                       // number of sector writes
+
+    private:
+        uint8_t buffer[EEPROM_SHIM_SECTOR_SIZE];
+        size_t size = 0;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file ESP8266WebServer.h
+ * @brief Host replacement of the ESP8266 web server
+ *
+ * There is no socket, a test calls request() with method, URI, arguments and headers. The handler
+ * registered for the URI is called and the response (status, content type, body incl. chunks) is recorded.
+ *
+ */
+
+#ifndef esp8266webserver_shim_h
+#define esp8266webserver_shim_h
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <FS.h>
+#include <vector>
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+enum HTTPUploadStatus { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED };
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+struct HTTPUpload {
+    HTTPUploadStatus status;
+    String filename;
+    String name;
+    String type;
+    size_t totalSize;
+    size_t currentSize;
+    uint8_t buf[2048];
+};
+
+namespace mime {
+    String getContentType(const String &path);
+}
+
+struct FakeResponse {
+    int code = 0;
+    String contentType;
+    std::string body;
+    std::vector<std::pair<String, String>> headers;
+    bool chunked = false;
+    uint32_t chunks = 0;                    // number of sendContent() calls
+};
+
+class ESP8266WebServer {
+    public:
+        typedef std::function<void(void)> THandlerFunction;
+
+        ESP8266WebServer(int port = 80) { (void)port; }
+        void begin() {}
+        void handleClient() { if(onHandleClient) onHandleClient(); }
+        void on(const String &uri, THandlerFunction handler) { on(uri, HTTP_ANY, handler); }
+        void on(const String &uri, HTTPMethod method, THandlerFunction handler, THandlerFunction upload = nullptr) {
+            (void)upload;
+            routes.push_back({uri, method, handler});
+        }
+        void onNotFound(THandlerFunction handler) { notFound = handler; }
+        void collectHeaders(const char *headerKeys[], size_t count) { (void)headerKeys; (void)count; }
+
+        const String &uri() const { return currentUri; }
+        HTTPMethod method() const { return currentMethod; }
+        int args() const { return currentArgs.size(); }
+        const String &arg(int i) const { return i < args() ? currentArgs[i].second : empty; }
+        const String &argName(int i) const { return i < args() ? currentArgs[i].first : empty; }
+        const String &arg(const String &name) const {
+            for(auto &a : currentArgs) if(a.first == name) return a.second;
+            return empty;
+        }
+        bool hasArg(const String &name) const {
+            for(auto &a : currentArgs) if(a.first == name) return true;
+            return false;
+        }
+        const String &header(const String &name) const {
+            for(auto &h : currentHeaders) if(h.first.equalsIgnoreCase(name)) return h.second;
+            return empty;
+        }
+        bool hasHeader(const String &name) const {
+            for(auto &h : currentHeaders) if(h.first.equalsIgnoreCase(name)) return true;
+            return false;
+        }
+        String urlDecode(const String &text) const { return text; }
+        HTTPUpload &upload() { return currentUpload; }
+        WiFiClient client() { return currentClient; }
+
+        void sendHeader(const String &name, const String &value, bool first = false) {
+            (void)first;
+            response.headers.push_back({name, value});
+        }
+        void setContentLength(size_t length) { contentLength = length; }
+        void send(int code, const char *contentType = nullptr, const String &content = String()) {
+            response.code = code;
+            response.contentType = contentType ? contentType : "";
+            response.chunked = contentLength == CONTENT_LENGTH_UNKNOWN;
+            response.body.append(content.c_str(), content.length());
+            responses++;
+        }
+        void send(int code, const String &contentType, const String &content) { send(code, contentType.c_str(), content); }
+        void sendContent(const char *content, size_t length) {
+            // an empty chunk terminates the chunked response
+            if(length) response.body.append(content, length);
+            response.chunks++;
+        }
+        void sendContent(const char *content) { sendContent(content, strlen(content)); }
+        void sendContent(const String &content) { sendContent(content.c_str(), content.length()); }
+        template<typename T> size_t streamFile(T &file, const String &contentType) {
+            send(200, contentType.c_str());
+            uint8_t buffer[256];
+            size_t total = 0;
+            for(size_t n; (n = file.read(buffer, sizeof(buffer))) > 0; total += n) response.body.append((const char *)buffer, n);
+            return total;
+        }
+
+        // call the handler of a request, returns the recorded response
+        const FakeResponse &request(HTTPMethod method, const String &uri,
+                                    std::vector<std::pair<String, String>> args = {},
+                                    std::vector<std::pair<String, String>> headers = {});
+        FakeResponse response;
+        uint32_t responses = 0;
+        WiFiClient currentClient;
+        THandlerFunction onHandleClient;    // called by handleClient(), e.g. to simulate slow request handlers
+
+    private:
+        struct Route {
+            String uri;
+            HTTPMethod method;
+            THandlerFunction handler;
+        };
+        std::vector<Route> routes;
+        THandlerFunction notFound;
+        String currentUri;
+        HTTPMethod currentMethod = HTTP_GET;
+        std::vector<std::pair<String, String>> currentArgs;
+        std::vector<std::pair<String, String>> currentHeaders;
+        HTTPUpload currentUpload;
+        size_t contentLength = CONTENT_LENGTH_NOT_SET;
+        String empty;
+};
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file ESP8266WiFi.h
+ * @brief Host replacement of the ESP8266 WiFi (always connected) and of WiFiClient
+ *
+ * A WiFiClient shares its connection with all copies (like the real one). Outgoing connections are
+ * answered by WiFiClient::onConnect, which can be set by a test to emulate a server.
+ *
+ */
+
+#ifndef esp8266wifi_shim_h
+#define esp8266wifi_shim_h
+
+#include <Arduino.h>
+#include <memory>
+#include <deque>
+#include <vector>
+#include <string>
+
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+enum WiFiMode_t { WIFI_OFF, WIFI_STA, WIFI_AP, WIFI_AP_STA };
+
+class ESP8266WiFiClass {
+    public:
+        void mode(WiFiMode_t mode) { (void)mode; }
+        bool hostname(const char *name) { (void)name; return true; }
+        int begin(const char *ssid, const char *pass) { (void)ssid; (void)pass; return WL_CONNECTED; }
+        int status() { return connectionStatus; }
+        IPAddress localIP() { return IPAddress(192, 168, 0, 42); }
+        IPAddress softAPIP() { return IPAddress(192, 168, 10, 2); }
+        bool softAPConfig(IPAddress ip, IPAddress gateway, IPAddress subnet) { (void)ip; (void)gateway; (void)subnet; return true; }
+        bool softAP(const char *ssid, const char *pass) { (void)ssid; (void)pass; return true; }
+        bool setAutoReconnect(bool on) { (void)on; return true; }
+        void persistent(bool on) { (void)on; }
+        int32_t RSSI() { return -60; }
+        // fake DNS: each name gets an address 10.0.0.x, which is mapped back to the name by WiFiClient::connect()
+        int hostByName(const char *name, IPAddress &ip, uint32_t timeout = 10000) {
+            (void)timeout;
+            dnsRequests++;
+            size_t i = 0;
+            while(i < names.size() && names[i] != name) i++;
+            if(i == names.size()) names.push_back(name);
+            ip = IPAddress(10, 0, 0, i + 1);
+            return 1;
+        }
+        std::string nameOf(const IPAddress &ip) {
+            size_t i = ip[3] - 1;
+            return (ip[0] == 10 && i < names.size()) ? names[i] : std::string(ip.toString().c_str());
+        }
+        int connectionStatus = WL_CONNECTED;
+        uint32_t dnsRequests = 0;
+        std::vector<std::string> names;
+};
+
+extern ESP8266WiFiClass WiFi;
+
+// state of one TCP connection, shared by all copies of a WiFiClient
+struct FakeConnection {
+    bool open = true;
+    std::deque<uint8_t> rx;                 // data for the client
+    std::string tx;                         // data written by the client
+    size_t writeLimit = (size_t)-1;         // max. bytes accepted by write() (emulates a full send buffer)
+};
+
+class WiFiClient : public Stream {
+    public:
+        WiFiClient() {}
+        WiFiClient(std::shared_ptr<FakeConnection> connection) : conn(connection) {}
+
+        int connect(const char *host, uint16_t port) {
+            conn.reset();
+            if(onConnect) conn = onConnect(host, port);
+            return conn != nullptr;
+        }
+        int connect(IPAddress ip, uint16_t port) { return connect(WiFi.nameOf(ip).c_str(), port); }
+        uint8_t connected() { return conn && (conn->open || !conn->rx.empty()); }
+        explicit operator bool() { return connected(); }
+        void stop() { if(conn) conn->open = false; conn.reset(); }
+        void setNoDelay(bool on) { (void)on; }
+        int available() override { return conn ? conn->rx.size() : 0; }
+        int read() override {
+            if(!available()) return -1;
+            uint8_t c = conn->rx.front();
+            conn->rx.pop_front();
+            return c;
+        }
+        int read(uint8_t *buffer, size_t length) { return readBytes(buffer, length); }
+        int peek() override { return available() ? conn->rx.front() : -1; }
+        size_t write(uint8_t c) override { return write(&c, 1); }
+        size_t write(const uint8_t *buffer, size_t size) override {
+            if(!conn || !conn->open) return 0;
+            size_t n = std::min(size, conn->writeLimit);
+            conn->tx.append((const char *)buffer, n);
+            return n;
+        }
+        using Print::write;
+        std::shared_ptr<FakeConnection> getConnection() { return conn; }
+
+        // answers outgoing connections (nullptr = connection refused)
+        static std::function<std::shared_ptr<FakeConnection>(const char *host, uint16_t port)> onConnect;
+
+    private:
+        std::shared_ptr<FakeConnection> conn;
+};
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file FS.h
+ * @brief Host replacement of the ESP8266 filesystem API with an in-memory filesystem
+ *
+ * Every written byte is stored immediately (a pessimistic model of LittleFS), rename replaces the
+ * destination atomically. A write budget (FS::writeBudget) emulates a power loss at any byte:
+ * when the budget is used up the next write, remove or rename throws FakePowerLoss.
+ *
+ */
+
+#ifndef fs_shim_h
+#define fs_shim_h
+
+#include <Arduino.h>
+#include <map>
+#include <set>
+#include <memory>
+#include <vector>
+
+struct FakePowerLoss {};
+
+struct FSInfo {
+    size_t totalBytes;
+    size_t usedBytes;
+    size_t blockSize;
+    size_t pageSize;
+    size_t maxOpenFiles;
+    size_t maxPathLength;
+};
+
+class FS;
+
+class File : public Stream {
+    public:
+        File() {}
+        File(FS *fs, const std::string &path, std::shared_ptr<std::vector<uint8_t>> data, size_t position)
+            : fs(fs), path(path), data(data), pos(position) {}
+        File(const File &other) : Stream(), fs(other.fs), path(other.path), data(other.data), pos(other.pos) {}
+        File &operator=(const File &other) {
+            fs = other.fs; path = other.path; data = other.data; pos = other.pos;
+            return *this;
+        }
+
+        explicit operator bool() const { return data != nullptr; }
+        size_t size() const { return data ? data->size() : 0; }
+        size_t position() const { return pos; }
+        bool seek(uint32_t pos) { if(!data || pos > data->size()) return false; this->pos = pos; return true; }
+        int available() override { return data ? data->size() - pos : 0; }
+        int read() override { return available() ? (*data)[pos++] : -1; }
+        size_t read(uint8_t *buffer, size_t length) {
+            size_t n = std::min(length, (size_t)available());
+            if(n) memcpy(buffer, data->data() + pos, n);
+            pos += n;
+            return n;
+        }
+        int peek() override { return available() ? (*data)[pos] : -1; }
+        size_t write(uint8_t c) override { return write(&c, 1); }
+        size_t write(const uint8_t *buffer, size_t size) override;
+        using Print::write;
+        const char *name() const { return path.c_str(); }
+        bool isDirectory() const { return false; }
+        void close() { data.reset(); }
+
+    private:
+        FS *fs = nullptr;
+        std::string path;
+        std::shared_ptr<std::vector<uint8_t>> data;
+        size_t pos = 0;
+};
+
+class Dir {
+    public:
+        Dir() {}
+        Dir(std::vector<std::pair<std::string, std::shared_ptr<std::vector<uint8_t>>>> entries) : entries(entries) {}
+        bool next() { return ++index < (int)entries.size(); }
+        String fileName() const { return String(entries[index].first); }
+        size_t fileSize() const { return entries[index].second ? entries[index].second->size() : 0; }
+        bool isDirectory() const { return entries[index].second == nullptr; }
+        bool isFile() const { return !isDirectory(); }
+
+    private:
+        std::vector<std::pair<std::string, std::shared_ptr<std::vector<uint8_t>>>> entries;     // directories without data
+        int index = -1;
+};
+
+class FS {
+    public:
+        bool begin() { return true; }
+        void end() {}
+        bool format() { files.clear(); dirs.clear(); return true; }
+        bool info(FSInfo &info) {
+            memset(&info, 0, sizeof(info));
+            info.totalBytes = 2 * 1024 * 1024;
+            info.blockSize = 8192;
+            info.pageSize = 256;
+            for(auto &file : files) info.usedBytes += (file.second->size() + info.blockSize - 1) / info.blockSize * info.blockSize;
+            return true;
+        }
+        bool exists(const String &path) { std::string p = normalize(path); return files.count(p) || dirs.count(p); }
+        File open(const String &path, const char *mode);
+        Dir openDir(const String &path);
+        bool remove(const String &path);
+        bool rename(const String &from, const String &to);
+        bool mkdir(const String &path) { dirs.insert(normalize(path)); return true; }
+        bool rmdir(const String &path) { return dirs.erase(normalize(path)) > 0; }
+
+        void consumeBudget();
+        long writeBudget = -1;              // bytes/operations until a power loss, < 0 = unlimited
+        unsigned long bytesWritten = 0;
+
+    private:
+        std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files;
+        std::set<std::string> dirs;
+
+        static std::string normalize(const String &path);
+};
+
+#endif
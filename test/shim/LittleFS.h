@@ -0,0 +1,8 @@
+#ifndef littlefs_shim_h
+#define littlefs_shim_h
+
+#include <FS.h>
+
+extern FS LittleFS;
+
+#endif
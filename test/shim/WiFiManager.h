@@ -0,0 +1,16 @@
+#ifndef wifimanager_shim_h
+#define wifimanager_shim_h
+
+#include <ESP8266WiFi.h>
+
+class WiFiManager {
+    public:
+        void setHostname(const String &hostname) { (void)hostname; }
+        void setConfigPortalTimeout(unsigned long seconds) { (void)seconds; }
+        void setAPStaticIPConfig(IPAddress ip, IPAddress gateway, IPAddress subnet) { (void)ip; (void)gateway; (void)subnet; }
+        bool autoConnect(const char *ssid, const char *pass = nullptr) { (void)ssid; (void)pass; return true; }
+        void resetSettings() { resets++; }
+        uint32_t resets = 0;
+};
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * @file WiFiUdp.h
+ * @brief Host replacement of WiFiUDP
+ *
+ * Packets to port 123 are answered by a fake NTP server with the time of fakeUTCMillis(),
+ * all other packets are counted and dropped. Tests can queue received packets with receive(), or send them to
+ * the socket bound to a port with deliver().
+ *
+ */
+
+#ifndef wifiudp_shim_h
+#define wifiudp_shim_h
+
+#include <Arduino.h>
+#include <deque>
+#include <map>
+#include <vector>
+
+int64_t fakeUTCMillis();
+
+class UDP {
+    public:
+        virtual ~UDP() {}
+        virtual uint8_t begin(uint16_t port) = 0;
+        virtual void stop() = 0;
+        virtual int beginPacket(const char *host, uint16_t port) = 0;
+        virtual int beginPacket(IPAddress ip, uint16_t port) = 0;
+        virtual size_t write(const uint8_t *buffer, size_t size) = 0;
+        virtual int endPacket() = 0;
+        virtual int parsePacket() = 0;
+        virtual int read(unsigned char *buffer, size_t length) = 0;
+        virtual void flush() = 0;
+};
+
+class WiFiUDP : public UDP {
+    public:
+        ~WiFiUDP() { stop(); }
+        uint8_t begin(uint16_t port) override;
+        uint8_t beginMulticast(IPAddress interfaceAddr, IPAddress multicast, uint16_t port) {
+            (void)interfaceAddr; (void)multicast; (void)port;
+            return 1;
+        }
+        void stop() override;
+        int beginPacket(const char *host, uint16_t port) override { (void)host; txPort = port; tx.clear(); return 1; }
+        int beginPacket(IPAddress ip, uint16_t port) override { (void)ip; txPort = port; tx.clear(); return 1; }
+        int beginPacketMulticast(IPAddress multicast, uint16_t port, IPAddress interfaceAddr) {
+            (void)multicast; (void)interfaceAddr;
+            txPort = port;
+            tx.clear();
+            return 1;
+        }
+        size_t write(const uint8_t *buffer, size_t size) override { tx.insert(tx.end(), buffer, buffer + size); return size; }
+        size_t write(uint8_t c) { return write(&c, 1); }
+        size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+        int endPacket() override;
+        int parsePacket() override {
+            current.clear();
+            position = 0;
+            if(rx.empty()) return 0;
+            current = rx.front();
+            rx.pop_front();
+            return current.size();
+        }
+        int available() { return current.size() - position; }
+        int read() { return available() ? current[position++] : -1; }
+        int read(unsigned char *buffer, size_t length) override {
+            size_t n = std::min(length, (size_t)available());
+            memcpy(buffer, current.data() + position, n);
+            position += n;
+            return n;
+        }
+        int read(char *buffer, size_t length) { return read((unsigned char *)buffer, length); }
+        void flush() override { position = current.size(); }
+        IPAddress remoteIP() { return IPAddress(192, 168, 0, 1); }
+        uint16_t remotePort() { return 123; }
+
+        void receive(const uint8_t *buffer, size_t size) { rx.emplace_back(buffer, buffer + size); }
+        static bool deliver(uint16_t port, const uint8_t *buffer, size_t size);
+        static uint32_t packetsSent;
+
+    private:
+        std::deque<std::vector<uint8_t>> rx;
+        std::vector<uint8_t> current;
+        size_t position = 0;
+        std::vector<uint8_t> tx;
+        uint16_t txPort = 0;
+        uint16_t localPort = 0;
+        static std::map<uint16_t, WiFiUDP *> &bound();
+};
+
+#endif
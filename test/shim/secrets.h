@@ -0,0 +1,2 @@
+// the tests use the example credentials
+#include "../../secrets_example.h"
@@ -0,0 +1,282 @@
+/**
+ * @file shim.cpp
+ * @brief Globals and implementation of the host replacements of the Arduino core and the ESP8266 libraries
+ *
+ */
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include <ESP8266WebServer.h>
+#include <ArduinoOTA.h>
+#include <EEPROM.h>
+#include <LittleFS.h>
+
+#define FAKE_EPOCH_START 1792231200ULL      // UTC time at millis() = 0: 2026-10-17 10:00:00
+#define NTP_EPOCH_OFFSET 2208988800ULL      // seconds from 1900 to 1970
+
+HardwareSerial Serial;
+EspClass ESP;
+ESP8266WiFiClass WiFi;
+FS LittleFS;
+EEPROMClass EEPROM;
+ArduinoOTAClass ArduinoOTA;
+
+std::function<std::shared_ptr<FakeConnection>(const char *host, uint16_t port)> WiFiClient::onConnect;
+uint32_t WiFiUDP::packetsSent = 0;
+
+// ----------------------------------------------------------------------------------
+//                                        TIME
+// ----------------------------------------------------------------------------------
+
+static uint64_t fakeMicros = 0;
+
+void advanceTime(unsigned long us){
+    fakeMicros += us;
+}
+
+unsigned long millis(){
+    return (unsigned long)(fakeMicros / 1000);
+}
+
+unsigned long micros(){
+    return (unsigned long)fakeMicros;
+}
+
+void delay(unsigned long ms){
+    fakeMicros += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us){
+    fakeMicros += us;
+}
+
+void yield(){
+}
+
+int64_t fakeUTCMillis(){
+    return FAKE_EPOCH_START * 1000 + fakeMicros / 1000;
+}
+
+// ----------------------------------------------------------------------------------
+//                                        IO
+// ----------------------------------------------------------------------------------
+
+static uint8_t pinState[32];
+static uint32_t randomState = 1;
+
+void pinMode(uint8_t pin, uint8_t mode){
+    if(mode == INPUT_PULLUP) pinState[pin & 31] = HIGH;
+}
+
+int digitalRead(uint8_t pin){
+    return pinState[pin & 31];
+}
+
+void digitalWrite(uint8_t pin, uint8_t value){
+    pinState[pin & 31] = value;
+}
+
+int analogRead(uint8_t pin){
+    (void)pin;
+    return random(1024);
+}
+
+long random(long max){
+    // deterministic LCG, so the animations are reproducible
+    randomState = randomState * 1103515245 + 12345;
+    return max > 0 ? (long)((randomState >> 8) % (uint32_t)max) : 0;
+}
+
+long random(long min, long max){
+    return min >= max ? min : min + random(max - min);
+}
+
+void randomSeed(unsigned long seed){
+    randomState = seed ? seed : 1;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax){
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+size_t shim_strlcpy(char *dst, const char *src, size_t size){
+    size_t length = strlen(src);
+    if(size){
+        size_t n = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return length;
+}
+
+size_t HardwareSerial::write(uint8_t c){
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size){
+    if(!quiet) fwrite(buffer, 1, size, stdout);
+    return size;
+}
+
+// ----------------------------------------------------------------------------------
+//                                        NETWORK
+// ----------------------------------------------------------------------------------
+
+static void writeNTPTimestamp(uint8_t *buffer, int64_t utcMillis){
+    uint32_t seconds = (uint32_t)(utcMillis / 1000 + NTP_EPOCH_OFFSET);
+    uint32_t fraction = (uint32_t)(((utcMillis % 1000) << 32) / 1000);
+    for(int i = 0; i < 4; i++){
+        buffer[i] = seconds >> (24 - 8 * i);
+        buffer[4 + i] = fraction >> (24 - 8 * i);
+    }
+}
+
+// sockets bound to a port, never destructed as global sockets unregister at exit
+std::map<uint16_t, WiFiUDP *> &WiFiUDP::bound(){
+    static std::map<uint16_t, WiFiUDP *> *sockets = new std::map<uint16_t, WiFiUDP *>();
+    return *sockets;
+}
+
+uint8_t WiFiUDP::begin(uint16_t port){
+    stop();
+    localPort = port;
+    bound()[port] = this;
+    return 1;
+}
+
+void WiFiUDP::stop(){
+    rx.clear();
+    auto socket = bound().find(localPort);
+    if(socket != bound().end() && socket->second == this) bound().erase(socket);
+    localPort = 0;
+}
+
+bool WiFiUDP::deliver(uint16_t port, const uint8_t *buffer, size_t size){
+    auto socket = bound().find(port);
+    if(socket == bound().end()) return false;
+    socket->second->receive(buffer, size);
+    return true;
+}
+
+int WiFiUDP::endPacket(){
+    packetsSent++;
+    if(txPort == 123 && tx.size() >= 48){
+        // fake NTP server: stratum 2, originate timestamp = transmit timestamp of the request
+        uint8_t answer[48] = {0x24, 2, 6, 0xEC};
+        memcpy(answer + 24, tx.data() + 40, 8);
+        writeNTPTimestamp(answer + 32, fakeUTCMillis());
+        writeNTPTimestamp(answer + 40, fakeUTCMillis());
+        receive(answer, sizeof(answer));
+    }
+    tx.clear();
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------
+//                                        FILESYSTEM
+// ----------------------------------------------------------------------------------
+
+size_t File::write(const uint8_t *buffer, size_t size){
+    if(!data) return 0;
+    for(size_t i = 0; i < size; i++){
+        fs->consumeBudget();
+        if(pos < data->size()) (*data)[pos] = buffer[i];
+        else data->push_back(buffer[i]);
+        pos++;
+        fs->bytesWritten++;
+    }
+    return size;
+}
+
+void FS::consumeBudget(){
+    if(writeBudget == 0) throw FakePowerLoss();
+    if(writeBudget > 0) writeBudget--;
+}
+
+std::string FS::normalize(const String &path){
+    std::string p = path.c_str();
+    if(p.empty() || p[0] != '/') p.insert(0, 1, '/');
+    while(p.size() > 1 && p.back() == '/') p.pop_back();
+    return p;
+}
+
+File FS::open(const String &path, const char *mode){
+    std::string p = normalize(path);
+    if(mode[0] == 'r'){
+        auto file = files.find(p);
+        if(file == files.end()) return File();
+        return File(this, p, file->second, 0);
+    }
+    consumeBudget();
+    auto &data = files[p];
+    if(!data || mode[0] == 'w') data = std::make_shared<std::vector<uint8_t>>();
+    // LittleFS creates the parent directories implicitly
+    for(size_t slash = p.find('/', 1); slash != std::string::npos; slash = p.find('/', slash + 1)) dirs.insert(p.substr(0, slash));
+    return File(this, p, data, mode[0] == 'a' ? data->size() : 0);
+}
+
+Dir FS::openDir(const String &path){
+    std::string prefix = normalize(path);
+    if(prefix != "/") prefix += '/';
+    std::vector<std::pair<std::string, std::shared_ptr<std::vector<uint8_t>>>> entries;
+    std::set<std::string> seen;
+    for(auto &dir : dirs){
+        if(dir.compare(0, prefix.size(), prefix) != 0) continue;
+        std::string name = dir.substr(prefix.size());
+        if(!name.empty() && name.find('/') == std::string::npos && seen.insert(name).second) entries.push_back({name, nullptr});
+    }
+    for(auto &file : files){
+        if(file.first.compare(0, prefix.size(), prefix) != 0) continue;
+        std::string name = file.first.substr(prefix.size());
+        if(name.find('/') == std::string::npos) entries.push_back({name, file.second});
+    }
+    return Dir(entries);
+}
+
+bool FS::remove(const String &path){
+    consumeBudget();
+    return files.erase(normalize(path)) > 0;
+}
+
+bool FS::rename(const String &from, const String &to){
+    consumeBudget();
+    auto file = files.find(normalize(from));
+    if(file == files.end()) return false;
+    auto data = file->second;
+    files.erase(file);
+    files[normalize(to)] = data;
+    return true;
+}
+
+// ----------------------------------------------------------------------------------
+//                                        WEBSERVER
+// ----------------------------------------------------------------------------------
+
+String mime::getContentType(const String &path){
+    if(path.endsWith(".html")) return "text/html";
+    if(path.endsWith(".css")) return "text/css";
+    if(path.endsWith(".js")) return "application/javascript";
+    if(path.endsWith(".json")) return "application/json";
+    if(path.endsWith(".png")) return "image/png";
+    return "application/octet-stream";
+}
+
+const FakeResponse &ESP8266WebServer::request(HTTPMethod method, const String &uri,
+                                              std::vector<std::pair<String, String>> args,
+                                              std::vector<std::pair<String, String>> headers){
+    currentMethod = method;
+    currentUri = uri;
+    currentArgs = args;
+    currentHeaders = headers;
+    contentLength = CONTENT_LENGTH_NOT_SET;
+    response = FakeResponse();
+    for(auto &route : routes){
+        if(route.uri == uri && (route.method == HTTP_ANY || route.method == method)){
+            route.handler();
+            return response;
+        }
+    }
+    if(notFound) notFound();
+    return response;
+}
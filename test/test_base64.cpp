@@ -0,0 +1,241 @@
+/**
+ * @file test_base64.cpp
+ * @brief Round-trip fuzz test of the table driven Base64 encoder and decoders against the former implementation,
+ * with a benchmark of the decoding of a frame of /leddirect
+ *
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "Base64.h"
+#include "check.h"
+
+#define FUZZ_RUNS 20000
+#define FUZZ_MAX_LENGTH 700
+#define BENCHMARK_RUNS 20000
+#define FRAME_BYTES (11 * 11 * 4)
+#define GUARD 0x5A
+
+// ----------------------------------------------------------------------------------
+//                                        FORMER IMPLEMENTATION
+// ----------------------------------------------------------------------------------
+
+namespace former {
+
+static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static void fromA3ToA4(unsigned char *A4, unsigned char *A3){
+    A4[0] = (A3[0] & 0xfc) >> 2;
+    A4[1] = ((A3[0] & 0x03) << 4) + ((A3[1] & 0xf0) >> 4);
+    A4[2] = ((A3[1] & 0x0f) << 2) + ((A3[2] & 0xc0) >> 6);
+    A4[3] = (A3[2] & 0x3f);
+}
+
+static void fromA4ToA3(unsigned char *A3, unsigned char *A4){
+    A3[0] = (A4[0] << 2) + ((A4[1] & 0x30) >> 4);
+    A3[1] = ((A4[1] & 0xf) << 4) + ((A4[2] & 0x3c) >> 2);
+    A3[2] = ((A4[2] & 0x3) << 6) + A4[3];
+}
+
+static unsigned char lookupTable(char c){
+    if(c >= 'A' && c <= 'Z') return c - 'A';
+    if(c >= 'a' && c <= 'z') return c - 71;
+    if(c >= '0' && c <= '9') return c + 4;
+    if(c == '+') return 62;
+    if(c == '/') return 63;
+    return -1;
+}
+
+int encode(char *output, const char *input, int inputLength){
+    int i = 0, encodedLength = 0;
+    unsigned char A3[3], A4[4];
+    while(inputLength--){
+        A3[i++] = *(input++);
+        if(i == 3){
+            fromA3ToA4(A4, A3);
+            for(i = 0; i < 4; i++) output[encodedLength++] = alphabet[A4[i]];
+            i = 0;
+        }
+    }
+    if(i){
+        for(int j = i; j < 3; j++) A3[j] = '\0';
+        fromA3ToA4(A4, A3);
+        for(int j = 0; j < i + 1; j++) output[encodedLength++] = alphabet[A4[j]];
+        while(i++ < 3) output[encodedLength++] = '=';
+    }
+    output[encodedLength] = '\0';
+    return encodedLength;
+}
+
+int decode(char *output, const char *input, int inputLength){
+    int i = 0, decodedLength = 0;
+    unsigned char A3[3], A4[4];
+    while(inputLength--){
+        if(*input == '=') break;
+        A4[i++] = *(input++);
+        if(i == 4){
+            for(i = 0; i < 4; i++) A4[i] = lookupTable(A4[i]);
+            fromA4ToA3(A3, A4);
+            for(i = 0; i < 3; i++) output[decodedLength++] = A3[i];
+            i = 0;
+        }
+    }
+    if(i){
+        for(int j = i; j < 4; j++) A4[j] = '\0';
+        for(int j = 0; j < 4; j++) A4[j] = lookupTable(A4[j]);
+        fromA4ToA3(A3, A4);
+        for(int j = 0; j < i - 1; j++) output[decodedLength++] = A3[j];
+    }
+    output[decodedLength] = '\0';
+    return decodedLength;
+}
+
+}
+
+// ----------------------------------------------------------------------------------
+//                                        TESTS
+// ----------------------------------------------------------------------------------
+
+static std::vector<uint8_t> randomData(int length){
+    std::vector<uint8_t> data(length);
+    for(uint8_t &byte : data) byte = random(256);
+    return data;
+}
+
+// decode with Base64Decoder in chunks of random size, false on error or if the output overruns
+static bool decodeChunked(const std::string &text, std::vector<uint8_t> &output){
+    Base64Decoder decoder;
+    output.assign(Base64Decoder::maxDecodedLength(text.size()) + 2 + 16, GUARD);
+    int length = 0;
+    size_t pos = 0;
+    while(pos < text.size()){
+        int chunk = std::min((int)(text.size() - pos), (int)random(1, 64));
+        int decoded = decoder.update(output.data() + length, text.data() + pos, chunk);
+        if(decoded < 0) return false;
+        CHECK(decoded <= Base64Decoder::maxDecodedLength(chunk));
+        length += decoded;
+        pos += chunk;
+    }
+    int decoded = decoder.final(output.data() + length);
+    if(decoded < 0) return false;
+    length += decoded;
+    for(size_t i = length; i < output.size(); i++){
+        if(output[i] != GUARD) return false;
+    }
+    output.resize(length);
+    return true;
+}
+
+void testRoundTrip(){
+    int failures = 0;
+    for(int run = 0; run < FUZZ_RUNS; run++){
+        std::vector<uint8_t> data = randomData(random(FUZZ_MAX_LENGTH));
+        int length = data.size();
+
+        std::vector<char> encoded(Base64.encodedLength(length) + 1);
+        std::vector<char> reference(Base64.encodedLength(length) + 1);
+        int encodedLength = Base64.encode(encoded.data(), (char *)data.data(), length);
+        former::encode(reference.data(), (const char *)data.data(), length);
+        bool ok = encodedLength == Base64.encodedLength(length) && std::string(encoded.data()) == reference.data();
+
+        std::vector<char> decoded(length + 3);
+        int decodedLength = Base64.decode(decoded.data(), encoded.data(), encodedLength);
+        ok = ok && decodedLength == length && memcmp(decoded.data(), data.data(), length) == 0;
+        ok = ok && Base64.decodedLength(encoded.data(), encodedLength) == length;
+        std::vector<char> formerDecoded(length + 3);
+        ok = ok && former::decode(formerDecoded.data(), encoded.data(), encodedLength) == length
+                && memcmp(formerDecoded.data(), data.data(), length) == 0;
+
+        std::vector<uint8_t> chunked;
+        ok = ok && decodeChunked(encoded.data(), chunked) && chunked == data;
+        // also accepted without padding
+        std::string unpadded(encoded.data());
+        while(!unpadded.empty() && unpadded.back() == '=') unpadded.pop_back();
+        ok = ok && decodeChunked(unpadded, chunked) && chunked == data;
+
+        if(!ok && failures++ < 3) printf("round trip of %d bytes failed\n", length);
+    }
+    printf("%d round trips of up to %d bytes\n", FUZZ_RUNS, FUZZ_MAX_LENGTH);
+    CHECK_EQUAL(failures, 0);
+}
+
+void testInvalid(){
+    int failures = 0;
+    for(int run = 0; run < FUZZ_RUNS; run++){
+        std::vector<uint8_t> data = randomData(random(1, 100));
+        std::vector<char> encoded(Base64.encodedLength(data.size()) + 1);
+        std::string text(encoded.data(), Base64.encode(encoded.data(), (char *)data.data(), data.size()));
+
+        size_t pos = random(text.size());
+        std::string unpadded = text.substr(0, text.find('='));
+        std::vector<uint8_t> output;
+        bool rejected;
+        switch(random(3)){
+            case 0: {
+                // character outside of the alphabet
+                static const char invalid[] = " *-_.\n\"\x80\xff";
+                text[pos] = invalid[random(sizeof(invalid) - 1)];
+                rejected = !decodeChunked(text, output);
+                break;
+            }
+            case 1:
+                // data after the padding
+                rejected = text.find('=') == std::string::npos || !decodeChunked(text + "QQ==", output);
+                break;
+            default:
+                // single character in the last quantum
+                rejected = unpadded.size() % 4 == 0 ? !decodeChunked(unpadded + "Q", output) : true;
+                break;
+        }
+        if(!rejected && failures++ < 3) printf("invalid data accepted: %s\n", text.c_str());
+    }
+    CHECK_EQUAL(failures, 0);
+
+    // the error is kept until reset()
+    Base64Decoder decoder;
+    uint8_t output[8];
+    CHECK_EQUAL(decoder.update(output, "QU*J", 4), -1);
+    CHECK(decoder.isError());
+    CHECK_EQUAL(decoder.update(output, "QUJD", 4), -1);
+    decoder.reset();
+    CHECK_EQUAL(decoder.update(output, "QUJD", 4), 3);
+    CHECK_EQUAL(decoder.final(output), 0);
+    CHECK(memcmp(output, "ABC", 3) == 0);
+}
+
+template <typename Decode>
+double measure(Decode decode){
+    auto start = std::chrono::steady_clock::now();
+    for(int run = 0; run < BENCHMARK_RUNS; run++) decode();
+    std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / BENCHMARK_RUNS;
+}
+
+void testBenchmark(){
+    std::vector<uint8_t> frame = randomData(FRAME_BYTES);
+    char encoded[FRAME_BYTES * 4 / 3 + 4];
+    int encodedLength = Base64.encode(encoded, (char *)frame.data(), FRAME_BYTES);
+    static char output[FRAME_BYTES + 4];
+    volatile uint8_t sink = 0;
+
+    double timeFormer = measure([&]{ former::decode(output, encoded, encodedLength); sink += output[7]; });
+    double timeTable = measure([&]{ Base64.decode(output, encoded, encodedLength); sink += output[7]; });
+    double timeStream = measure([&]{
+        Base64Decoder decoder;
+        int length = decoder.update((uint8_t *)output, encoded, encodedLength);
+        decoder.final((uint8_t *)output + length);
+        sink += output[7];
+    });
+    printf("decoding of a frame (%d characters): former %.0f ns, table %.0f ns, incremental %.0f ns\n", encodedLength,
+           timeFormer, timeTable, timeStream);
+    CHECK(memcmp(output, frame.data(), FRAME_BYTES) == 0);
+}
+
+int main(){
+    testRoundTrip();
+    testInvalid();
+    testBenchmark();
+    return checkResult();
+}
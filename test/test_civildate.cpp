@@ -0,0 +1,91 @@
+/**
+ * @file test_civildate.cpp
+ * @brief Test of the closed form date calculation of TimezoneRule for every day from 1970 to 2100 against gmtime() of
+ * the C library, with a benchmark against the former loops of NTPClientPlus::calcDate()
+ *
+ */
+
+#include <chrono>
+#include <ctime>
+#include "timezonerule.h"
+#include "check.h"
+
+#define DAYS_1900_TO_1970 25567UL
+#define BENCHMARK_DAYS 200
+
+static bool isLeapYear(unsigned int year){
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+// former calculation: the year by counting the days since 1900, the day of week by counting the weekdays
+void formerCalcDate(unsigned long days1900, unsigned int *year, unsigned int *month, unsigned int *day,
+                    unsigned int *dayOfWeek){
+    unsigned int daysInYear = 0;
+    *year = 1900;
+    for(unsigned long i = 0; i < days1900; i++){
+        if(++daysInYear >= (isLeapYear(*year) ? 366u : 365u)){
+            (*year)++;
+            daysInYear = 0;
+        }
+    }
+    unsigned int daysInMonth[13] = {0, 31, isLeapYear(*year) ? 29u : 28u, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    *month = 1;
+    while(daysInYear >= daysInMonth[*month]){
+        daysInYear -= daysInMonth[(*month)++];
+    }
+    *day = daysInYear + 1;
+    *dayOfWeek = 1;
+    for(unsigned long i = 0; i < days1900; i++){
+        *dayOfWeek = *dayOfWeek < 7 ? *dayOfWeek + 1 : 1;
+    }
+}
+
+int main(){
+    unsigned long first = DAYS_1900_TO_1970;
+    unsigned long last = TimezoneRule::daysFromCivil(2100, 12, 31);
+    int differences = 0;
+    for(unsigned long days1900 = first; days1900 <= last; days1900++){
+        time_t t = (time_t)(days1900 - DAYS_1900_TO_1970) * 86400;
+        struct tm reference;
+        gmtime_r(&t, &reference);
+
+        unsigned int year, month, day;
+        TimezoneRule::civilFromDays(days1900, &year, &month, &day);
+        // day of week as calculated by NTPClientPlus::calcDate(): Monday = 1 ... Sunday = 7
+        unsigned int dayOfWeek = days1900 % 7 + 1;
+        if((int)year != reference.tm_year + 1900 || (int)month != reference.tm_mon + 1 || (int)day != reference.tm_mday
+           || (int)dayOfWeek != (reference.tm_wday + 6) % 7 + 1
+           || TimezoneRule::daysFromCivil(year, month, day) != (long)days1900){
+            if(differences++ < 3) printf("day %lu: %04u-%02u-%02u (%u) differs\n", days1900, year, month, day, dayOfWeek);
+        }
+    }
+    printf("%lu days from 1970-01-01 to 2100-12-31 checked\n", last - first + 1);
+    CHECK_EQUAL(differences, 0);
+    CHECK_EQUAL(last - first + 1, 47847);
+
+    // the former loops for days spread over 1970 ... 2100
+    unsigned long step = (last - first) / BENCHMARK_DAYS;
+    unsigned long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned long days1900 = first; days1900 <= last; days1900 += step){
+        unsigned int year, month, day, dayOfWeek;
+        formerCalcDate(days1900, &year, &month, &day, &dayOfWeek);
+        checksum += year + month + day + dayOfWeek;
+    }
+    std::chrono::duration<double, std::nano> former = std::chrono::steady_clock::now() - start;
+
+    unsigned long checksumClosed = 0;
+    start = std::chrono::steady_clock::now();
+    for(unsigned long days1900 = first; days1900 <= last; days1900 += step){
+        unsigned int year, month, day;
+        TimezoneRule::civilFromDays(days1900, &year, &month, &day);
+        checksumClosed += year + month + day + days1900 % 7 + 1;
+    }
+    std::chrono::duration<double, std::nano> closed = std::chrono::steady_clock::now() - start;
+
+    int runs = (last - first) / step + 1;
+    printf("date calculation: former loops %.0f ns, closed form %.0f ns per date\n", former.count() / runs,
+           closed.count() / runs);
+    CHECK_EQUAL(checksumClosed, checksum);
+    return checkResult();
+}
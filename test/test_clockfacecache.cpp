@@ -0,0 +1,97 @@
+/**
+ * @file test_clockfacecache.cpp
+ * @brief Test of the clock face cache with the complete sketch: the cached faces of all layouts equal the faces of the
+ * word tables for all 1440 minutes, with a report of the RAM footprint and of the per-update cost
+ *
+ * The former String based rendering (timeToString() + showStringOnClock()) no longer exists, the word tables replaced
+ * it and are compared against its sentences in test_wordtables. The cost is measured on the host, so only the ratio of
+ * both ways is of interest.
+ *
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include "ledmatrix.h"
+#include "wordclocklayouts.h"
+#include "check.h"
+
+void setup();
+bool setLayout(uint8_t layout);
+bool buildClockFaceCache();
+void freeClockFaceCache();
+uint32_t getClockFaceCacheSize();
+void showTimeFromCache(uint8_t hours, uint8_t minutes, uint32_t color);
+void showTimeOnClock(uint8_t hours, uint8_t minutes, uint32_t color);
+void drawMinuteIndicator(uint8_t minutes, uint32_t color);
+extern LEDMatrix ledmatrix;
+extern uint16_t numClockFaces;
+
+#define COLOR 0x00FF00
+#define BENCHMARK_RUNS 20
+
+struct Face {
+    uint8_t mask[GRID_MASK_BYTES];
+    uint8_t indicator;
+
+    bool operator==(const Face &other) const {
+        return memcmp(mask, other.mask, GRID_MASK_BYTES) == 0 && indicator == other.indicator;
+    }
+};
+
+Face currentFace(){
+    Face face;
+    ledmatrix.gridGetMask(face.mask);
+    face.indicator = ledmatrix.getMinIndicatorPattern();
+    return face;
+}
+
+Face wordFace(int minute){
+    ledmatrix.gridFlush();
+    showTimeOnClock(minute / 60, minute % 60, COLOR);
+    drawMinuteIndicator(minute % 60, COLOR);
+    return currentFace();
+}
+
+Face cacheFace(int minute){
+    showTimeFromCache(minute / 60, minute % 60, COLOR);
+    return currentFace();
+}
+
+// nanoseconds per update of the clock face, averaged over all minutes of the day
+template <typename Draw>
+double measure(Draw draw){
+    auto start = std::chrono::steady_clock::now();
+    for(int run = 0; run < BENCHMARK_RUNS; run++){
+        for(int minute = 0; minute < 24 * 60; minute++) draw(minute);
+    }
+    std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+    return duration.count() / (BENCHMARK_RUNS * 24 * 60);
+}
+
+int main(){
+    setup();
+    ledmatrix.setDynamicColorShiftPhase(-1);
+    for(int layout = 0; layout < NUM_LAYOUTS; layout++){
+        CHECK(setLayout(layout));
+        CHECK(buildClockFaceCache());
+        // each face is stored once, the faces of 12 h repeat (apart from e.g. midnight and noon)
+        CHECK(numClockFaces > 0 && numClockFaces <= 720);
+        CHECK_EQUAL(getClockFaceCacheSize(), 24 * 60 * sizeof(uint16_t) + numClockFaces * GRID_MASK_BYTES);
+
+        int differences = 0;
+        for(int minute = 0; minute < 24 * 60; minute++){
+            if(!(cacheFace(minute) == wordFace(minute)) && differences++ < 3){
+                printf("%s %02d:%02d: cached face differs\n", getLayoutName(layout), minute / 60, minute % 60);
+            }
+        }
+        CHECK_EQUAL(differences, 0);
+
+        double timeWords = measure([](int minute){ wordFace(minute); });
+        double timeCache = measure([](int minute){ cacheFace(minute); });
+        printf("%-9s %3u faces, %5u bytes RAM, update %6.0f ns words, %6.0f ns cache\n", getLayoutName(layout),
+               numClockFaces, getClockFaceCacheSize(), timeWords, timeCache);
+    }
+    freeClockFaceCache();
+    CHECK_EQUAL(getClockFaceCacheSize(), 0);
+    return checkResult();
+}
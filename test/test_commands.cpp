@@ -0,0 +1,195 @@
+/**
+ * @file test_commands.cpp
+ * @brief Test of the command registry of /cmd with the complete sketch: lookup of all registered commands, atomic
+ * requests with several commands, flash writes and round trips of a settings save, with a benchmark of the lookup
+ * against the former if/else chain
+ *
+ * The former handleCommand() compared server.argName(0) with each command name as String in turn and handled only
+ * the first argument, so each command needed its own request. The chain is reproduced here for comparison.
+ *
+ */
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include <EEPROM.h>
+#include <chrono>
+#include <vector>
+#include "commandregistry.h"
+#include "settings.h"
+#include "check.h"
+
+#define BENCHMARK_RUNS 200000
+
+void setup();
+void loop();
+extern ESP8266WebServer server;
+extern CommandRegistry commands;
+extern SettingsStore settings;
+
+typedef std::vector<std::pair<String, String>> Args;
+
+void runLoop(unsigned long ms){
+    unsigned long start = millis();
+    while(millis() - start < ms) loop();
+}
+
+// ----------------------------------------------------------------------------------
+//                                        FORMER DISPATCH
+// ----------------------------------------------------------------------------------
+
+// index of the branch taken by the former if/else chain, -1 if no branch matches
+int formerDispatch(const String &name){
+    if(name == "led") return 0;
+    else if(name == "mode") return 1;
+    else if(name == "ledoff") return 2;
+    else if(name == "nightmodeactivated") return 3;
+    else if(name == "setting") return 4;
+    else if(name == "resetwifi") return 5;
+    else if(name == "stateautochange") return 6;
+    else if(name == "tetris") return 7;
+    else if(name == "snake") return 8;
+    else if(name == "pong") return 9;
+    return -1;
+}
+
+// ----------------------------------------------------------------------------------
+//                                        TESTS
+// ----------------------------------------------------------------------------------
+
+void testRegistry(){
+    CHECK(commands.getNumCommands() > 0);
+    for(uint8_t i = 0; i < commands.getNumCommands(); i++){
+        CHECK(commands.find(commands.getName(i)) != NULL);
+        if(i > 0) CHECK(strcmp(commands.getName(i - 1), commands.getName(i)) < 0);
+    }
+    CHECK(commands.find("") == NULL);
+    CHECK(commands.find("brightness") == NULL);
+    CHECK(commands.find("leds") == NULL);
+    CHECK(commands.find("a") == NULL);
+    CHECK(commands.find("zzz") == NULL);
+    // a name can only be registered once
+    CHECK(!commands.addCommand("led", commands.find("led")));
+}
+
+void testAtomic(){
+    Settings before = settings.get();
+    uint32_t commits = EEPROM.commits;
+
+    // a valid setting with an invalid language: nothing is changed
+    const FakeResponse &invalid = server.request(HTTP_GET, "/cmd", {{"setting", "21-30-6-45-120-5-30"}, {"lang", "klingon"}});
+    CHECK_EQUAL(invalid.code, 400);
+    CHECK(invalid.body.find("lang") != std::string::npos);
+    CHECK_EQUAL(server.request(HTTP_GET, "/cmd", {{"setting", "21-30-6-45-120-5-30"}, {"unknown", "1"}}).code, 400);
+    CHECK_EQUAL(server.request(HTTP_GET, "/cmd", {{"setting", "21-30-6-45-300-5-30"}}).code, 400);
+    CHECK_EQUAL(server.request(HTTP_GET, "/cmd", {{"setting", "21-30-6-45"}}).code, 400);
+    // more numbers than expected, characters after the last number or empty numbers
+    const char *const invalidSettings[] = {"1-2-3-4-5-6-7-8", "21-30-6-45-120-5-30x", "21-30-6-45-120-5-30-",
+                                           "21-30-6-45--120-5-30", ""};
+    for(const char *value : invalidSettings){
+        CHECK_EQUAL(server.request(HTTP_GET, "/cmd", {{"setting", value}}).code, 400);
+    }
+    const char *const invalidColors[] = {"1-2-3xyz", "1-2-3-4", "1-2-3 ", "1-2", "1-2-"};
+    for(const char *value : invalidColors){
+        CHECK_EQUAL(server.request(HTTP_GET, "/cmd", {{"led", value}}).code, 400);
+    }
+    Args tooMany;
+    for(int i = 0; i < 32; i++) tooMany.push_back({"ledoff", "0"});
+    CHECK_EQUAL(server.request(HTTP_GET, "/cmd", tooMany).code, 400);
+    runLoop(SETTINGS_COMMIT_DELAY + 1000);
+    CHECK(memcmp(&settings.get(), &before, sizeof(Settings)) == 0);
+    CHECK_EQUAL(EEPROM.commits, commits);
+
+    CHECK_EQUAL(server.request(HTTP_GET, "/cmd", {{"led", "10-200-30"}}).code, 204);
+    runLoop(SETTINGS_COMMIT_DELAY + 1000);
+}
+
+// typical save of the settings dialog: night mode times and brightnesses, language and the two switches
+Args settingsSave(bool variant){
+    String layout = settings.get().layout == 0 ? "english" : "german";
+    if(variant) layout = settings.get().layout == 0 ? "german" : "english";
+    return {{"setting", variant ? "23-15-6-30-90-3-20" : "21-30-6-45-120-5-30"}, {"lang", layout},
+            {"nightmodeactivated", variant ? "1" : "0"}, {"colorshift", variant ? "0" : "1"}};
+}
+
+void testSettingsSave(){
+    // all commands in one request
+    Args save = settingsSave(false);
+    uint32_t commits = EEPROM.commits;
+    uint32_t responses = server.responses;
+    CHECK_EQUAL(server.request(HTTP_GET, "/cmd", save).code, 204);
+    runLoop(SETTINGS_COMMIT_DELAY + 1000);
+    uint32_t roundTrips = server.responses - responses;
+    uint32_t flashWrites = EEPROM.commits - commits;
+    CHECK_EQUAL(roundTrips, 1);
+    CHECK_EQUAL(flashWrites, 1);
+    CHECK_EQUAL(settings.get().nightModeStartHour, 21);
+    CHECK_EQUAL(settings.get().brightness, 120);
+    CHECK_EQUAL(settings.get().nightModeBrightness, 30);
+    CHECK_EQUAL(settings.get().nightModeActivated, 0);
+    CHECK_EQUAL(settings.get().colorShiftActive, 1);
+
+    // one request per command like the former dispatch needed: still one flash write within the quiet period
+    Args separate = settingsSave(true);
+    commits = EEPROM.commits;
+    responses = server.responses;
+    for(auto &command : separate){
+        CHECK_EQUAL(server.request(HTTP_GET, "/cmd", {command}).code, 204);
+        runLoop(100);
+    }
+    runLoop(SETTINGS_COMMIT_DELAY + 1000);
+    CHECK_EQUAL(server.responses - responses, separate.size());
+    CHECK_EQUAL(EEPROM.commits - commits, 1);
+    CHECK_EQUAL(settings.get().brightness, 90);
+
+    // the former dispatch handled one command per request and called EEPROM.commit() in each command of a setting
+    printf("settings save with %zu commands: %u round trip and %u flash write (former: %zu round trips and "
+           "%zu flash writes)\n", save.size(), roundTrips, flashWrites, save.size(), save.size());
+
+    // an unchanged save is not written again
+    commits = EEPROM.commits;
+    CHECK_EQUAL(server.request(HTTP_GET, "/cmd", separate).code, 204);
+    runLoop(SETTINGS_COMMIT_DELAY + 1000);
+    CHECK_EQUAL(EEPROM.commits, commits);
+}
+
+void testBenchmark(){
+    std::vector<String> names;
+    for(uint8_t i = 0; i < commands.getNumCommands(); i++) names.push_back(commands.getName(i));
+    names.push_back("unknown");
+    volatile uintptr_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for(int run = 0; run < BENCHMARK_RUNS; run++){
+        sink += (uintptr_t)commands.find(names[run % names.size()].c_str());
+    }
+    std::chrono::duration<double, std::nano> registry = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for(int run = 0; run < BENCHMARK_RUNS; run++){
+        sink += formerDispatch(names[run % names.size()]);
+    }
+    std::chrono::duration<double, std::nano> former = std::chrono::steady_clock::now() - start;
+
+    // complete request through the web server: check and apply of all commands
+    Args save = settingsSave(false);
+    int requests = BENCHMARK_RUNS / 100;
+    start = std::chrono::steady_clock::now();
+    for(int run = 0; run < requests; run++){
+        CHECK_EQUAL(server.request(HTTP_GET, "/cmd", save).code, 204);
+    }
+    std::chrono::duration<double, std::nano> request = std::chrono::steady_clock::now() - start;
+
+    printf("lookup of a command among %u: former if/else chain %.1f ns, registry %.1f ns; "
+           "/cmd with %zu commands %.0f ns\n", commands.getNumCommands(), former.count() / BENCHMARK_RUNS,
+           registry.count() / BENCHMARK_RUNS, save.size(), request.count() / requests);
+}
+
+int main(){
+    setup();
+    runLoop(2000);
+    testRegistry();
+    testAtomic();
+    testSettingsSave();
+    testBenchmark();
+    return checkResult();
+}
@@ -0,0 +1,107 @@
+/**
+ * @file test_events.cpp
+ * @brief Test of the event stream with the complete sketch: bytes and requests per hour of an idle dashboard with one
+ * and five connected clients, compared with polling /data, and the delta sent on a change of the state
+ *
+ */
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include <memory>
+#include <vector>
+#include "eventstream.h"
+#include "check.h"
+
+#define HOUR_MS 3600000UL
+#define POLL_PERIOD 5000            // period of a dashboard polling /data for comparison
+
+void setup();
+void loop();
+void stateChange(uint8_t newState, bool persistant);
+extern ESP8266WebServer server;
+extern EventStream events;
+
+std::shared_ptr<FakeConnection> connectClient(){
+    std::shared_ptr<FakeConnection> connection = std::make_shared<FakeConnection>();
+    server.currentClient = WiFiClient(connection);
+    server.request(HTTP_GET, "/events");
+    server.currentClient = WiFiClient();
+    return connection;
+}
+
+void runLoop(unsigned long ms){
+    unsigned long start = millis();
+    while(millis() - start < ms) loop();
+}
+
+size_t countOf(const std::string &text, const char *pattern){
+    size_t count = 0;
+    for(size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) count++;
+    return count;
+}
+
+void testIdleHour(std::vector<std::shared_ptr<FakeConnection>> &clients, size_t numClients, size_t pollBytes){
+    while(clients.size() < numClients){
+        clients.push_back(connectClient());
+        // the complete state is sent to the new client
+        CHECK_EQUAL(countOf(clients.back()->tx, "event: state"), 1);
+    }
+    CHECK_EQUAL(events.getNumClients(), numClients);
+    runLoop(1000);
+
+    std::vector<size_t> bytes;
+    for(auto &client : clients) bytes.push_back(client->tx.size());
+    uint32_t responses = server.responses;
+    uint32_t eventsSent = events.getEventsSent();
+    runLoop(HOUR_MS);
+
+    size_t bytesPerClient = clients[0]->tx.size() - bytes[0];
+    printf("%zu client(s), idle hour: %u requests, %u events, %zu bytes per client (polling /data every %d s: "
+           "%lu requests, %zu bytes per client)\n", numClients, server.responses - responses,
+           events.getEventsSent() - eventsSent, bytesPerClient, POLL_PERIOD / 1000, HOUR_MS / POLL_PERIOD,
+           pollBytes * (HOUR_MS / POLL_PERIOD));
+    CHECK_EQUAL(server.responses - responses, 0);
+    CHECK_EQUAL(events.getEventsSent() - eventsSent, 0);
+    for(size_t i = 0; i < clients.size(); i++){
+        // only the keep-alive comments
+        CHECK_EQUAL(clients[i]->tx.size() - bytes[i], HOUR_MS / EVENTSTREAM_KEEPALIVE * 3);
+    }
+}
+
+int main(){
+    setup();
+    stateChange(0, false);
+    runLoop(2000);
+    size_t pollBytes = server.request(HTTP_GET, "/data", {{"key", "mode"}}).body.size();
+    CHECK(pollBytes > 0);
+
+    std::vector<std::shared_ptr<FakeConnection>> clients;
+    testIdleHour(clients, 1, pollBytes);
+    testIdleHour(clients, 5, pollBytes);
+
+    // no free slot for a sixth client
+    std::shared_ptr<FakeConnection> rejected = std::make_shared<FakeConnection>();
+    server.currentClient = WiFiClient(rejected);
+    CHECK_EQUAL(server.request(HTTP_GET, "/events").code, 503);
+    server.currentClient = WiFiClient();
+
+    // a change of the state: one event with only the changed values to each client
+    std::vector<size_t> bytes;
+    for(auto &client : clients) bytes.push_back(client->tx.size());
+    CHECK_EQUAL(server.request(HTTP_GET, "/cmd", {{"mode", "spiral"}}).code, 204);
+    runLoop(1000);
+    for(size_t i = 0; i < clients.size(); i++){
+        std::string delta = clients[i]->tx.substr(bytes[i]);
+        CHECK_EQUAL(countOf(delta, "event: state"), 1);
+        CHECK(delta.find("\"modeid\"") != std::string::npos);
+        CHECK(delta.find("\"brightness\"") == std::string::npos);
+        if(i == 0) printf("change of the mode: %zu bytes per client\n", delta.size());
+    }
+
+    // closed connections are released
+    clients[1]->open = false;
+    clients[3]->open = false;
+    runLoop(EVENTSTREAM_KEEPALIVE);
+    CHECK_EQUAL(events.getNumClients(), 3);
+    return checkResult();
+}
@@ -0,0 +1,186 @@
+/**
+ * @file test_filelist.cpp
+ * @brief Test of the file list of the file manager with the complete sketch: order by name and by size, and a
+ * benchmark of heap and time for a list of 100 files
+ *
+ * malloc() and free() are wrapped (see Makefile) to track the heap used by the sketch. The host heap does not
+ * fragment like the one of the ESP8266, so the largest block is reported: it has to fit into the largest free block
+ * there, which is what limits handleList() on a fragmented heap.
+ *
+ */
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include <LittleFS.h>
+#include <chrono>
+#include <new>
+#include <vector>
+#include "check.h"
+
+#define BENCH_FILES 100
+#define BENCH_FOLDER_FILES 20       // files of the benchmark in a folder, the others in the root
+#define BENCH_REQUESTS 100
+// FS_NAME_LEN and sizeof(DirEntry) of LittleFS.ino
+#define FS_NAME_LEN 32
+#define DIR_ENTRY_SIZE 40
+
+void setup();
+extern ESP8266WebServer server;
+
+// ----------------------------------------------------------------------------------
+//                                        HEAP TRACKING
+// ----------------------------------------------------------------------------------
+
+// Only blocks of malloc() are tracked. operator new is used by the fake filesystem (snapshot of a directory) and
+// the String of the host, which have no counterpart on the heap of the ESP8266 (file names up to 11 characters fit
+// into the String there without allocation).
+#define MAX_TRACKED_BLOCKS 64
+
+static bool trackHeap = false;
+static void *trackedBlocks[MAX_TRACKED_BLOCKS];
+static size_t trackedSizes[MAX_TRACKED_BLOCKS];
+static size_t heapInUse = 0;
+static size_t heapPeak = 0;
+static uint32_t heapBlocks = 0;
+static uint32_t heapPeakBlocks = 0;
+static size_t largestBlock = 0;
+static uint32_t allocations = 0;
+
+extern "C" void *__real_malloc(size_t size);
+extern "C" void __real_free(void *p);
+
+extern "C" void *__wrap_malloc(size_t size){
+    void *p = __real_malloc(size);
+    if(!trackHeap || !p) return p;
+    for(int i = 0; i < MAX_TRACKED_BLOCKS; i++){
+        if(trackedBlocks[i]) continue;
+        trackedBlocks[i] = p;
+        trackedSizes[i] = size;
+        allocations++;
+        heapBlocks++;
+        heapInUse += size;
+        largestBlock = std::max(largestBlock, size);
+        if(heapInUse > heapPeak){
+            heapPeak = heapInUse;
+            heapPeakBlocks = heapBlocks;
+        }
+        break;
+    }
+    return p;
+}
+
+extern "C" void __wrap_free(void *p){
+    for(int i = 0; p && i < MAX_TRACKED_BLOCKS; i++){
+        if(trackedBlocks[i] != p) continue;
+        trackedBlocks[i] = NULL;
+        heapBlocks--;
+        heapInUse -= trackedSizes[i];
+        break;
+    }
+    __real_free(p);
+}
+
+void *operator new(size_t size){
+    void *p = __real_malloc(size ? size : 1);
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size){
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept { __real_free(p); }
+void operator delete[](void *p) noexcept { __real_free(p); }
+void operator delete(void *p, size_t) noexcept { __real_free(p); }
+void operator delete[](void *p, size_t) noexcept { __real_free(p); }
+
+// ----------------------------------------------------------------------------------
+//                                        TEST
+// ----------------------------------------------------------------------------------
+
+void createFile(const char *path, size_t size){
+    File file = LittleFS.open(path, "w");
+    std::string data(size, 'x');
+    file.write((const uint8_t *)data.data(), data.size());
+    file.close();
+}
+
+// folder and name of all entries of the list, e.g. "/d/x.txt"
+std::string listFiles(const char *sort){
+    const FakeResponse &response = server.request(HTTP_GET, "/", {{"sort", sort}});
+    std::string list;
+    const std::string &body = response.body;
+    for(size_t pos = body.find("\"folder\":\""); pos != std::string::npos; pos = body.find("\"folder\":\"", pos + 1)){
+        size_t folder = pos + 10;
+        size_t name = body.find("\"name\":\"", folder) + 8;
+        list += " " + body.substr(folder, body.find('"', folder) - folder) + "/" + body.substr(name, body.find('"', name) - name);
+    }
+    return list;
+}
+
+// 100 files: peak heap, largest block and time of a request
+void benchmarkList(){
+    LittleFS.format();
+    char path[32];
+    for(int i = 0; i < BENCH_FILES; i++){
+        if(i < BENCH_FOLDER_FILES) snprintf(path, sizeof(path), "/logs/log%03d.txt", i);
+        else snprintf(path, sizeof(path), "/file%03d.txt", i);
+        createFile(path, (i * 37) % 500);
+    }
+
+    for(const char *sort : {"0", "1"}){
+        heapInUse = heapPeak = 0;
+        heapBlocks = heapPeakBlocks = 0;
+        largestBlock = 0;
+        allocations = 0;
+        std::vector<std::pair<String, String>> args = {{"sort", sort}};
+        trackHeap = true;
+        auto start = std::chrono::steady_clock::now();
+        for(int run = 0; run < BENCH_REQUESTS; run++){
+            server.request(HTTP_GET, "/", args);
+        }
+        std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+        trackHeap = false;
+
+        size_t entries = 0;
+        for(size_t pos = server.response.body.find("\"name\""); pos != std::string::npos;
+            pos = server.response.body.find("\"name\"", pos + 1)) entries++;
+        printf("list of %d files (sort=%s): peak heap %zu bytes in %u blocks, largest block %zu bytes, "
+               "%u allocations and %.1f us per request, %zu bytes of JSON in %u chunks\n", BENCH_FILES, sort,
+               heapPeak, heapPeakBlocks, largestBlock, allocations / BENCH_REQUESTS,
+               duration.count() / BENCH_REQUESTS, server.response.body.size(), server.response.chunks);
+        CHECK_EQUAL(entries, BENCH_FILES);
+        // the single block of handleList(): folder names (root and /logs) and one entry per file
+        CHECK_EQUAL(largestBlock, 2 * FS_NAME_LEN + BENCH_FILES * DIR_ENTRY_SIZE);
+        CHECK_EQUAL(heapPeak, largestBlock);
+        // nothing is left on the heap after the request
+        CHECK_EQUAL(heapInUse, 0);
+    }
+}
+
+int main(){
+    setup();
+    LittleFS.format();
+    // created in an order which differs from the expected ones
+    createFile("/b.txt", 10);
+    createFile("/C.txt", 10);
+    createFile("/A.txt", 10);
+    createFile("/big.txt", 100);
+    createFile("/d/Y.txt", 10);
+    createFile("/d/x.txt", 10);
+    createFile("/d/z.txt", 50);
+
+    std::string byName = listFiles("0");
+    printf("by name:%s\n", byName.c_str());
+    CHECK(byName == " /A.txt /b.txt /big.txt /C.txt d/x.txt d/Y.txt d/z.txt");
+
+    // files of the same size are ordered by name
+    std::string bySize = listFiles("1");
+    printf("by size:%s\n", bySize.c_str());
+    CHECK(bySize == " /big.txt /A.txt /b.txt /C.txt d/z.txt d/x.txt d/Y.txt");
+
+    benchmarkList();
+
+    return checkResult();
+}
@@ -0,0 +1,149 @@
+/**
+ * @file test_journal.cpp
+ * @brief Test of SettingsJournal: power loss at every byte offset of a workload with several compactions
+ *
+ * After each power loss (and a second one during the recovery) the journal needs to contain either the values
+ * before the interrupted change or the values including it, and needs to work normally afterwards.
+ *
+ */
+
+#include <LittleFS.h>
+#include <map>
+#include <vector>
+#include <limits.h>
+#include "settingsjournal.h"
+#include "check.h"
+
+#define NUM_CHANGES 800
+
+// change of a value (length < 0: remove the key)
+struct Change {
+    uint16_t key;
+    int length;
+    uint8_t value;
+};
+
+typedef std::map<uint16_t, std::vector<uint8_t>> Model;
+
+std::vector<Change> makeChanges(int count){
+    std::vector<Change> changes;
+    srand(1);
+    for(int i = 0; i < count; i++){
+        Change c;
+        c.key = 0x100 + rand() % 12;
+        c.length = (rand() % 15 == 0) ? -1 : 1 + rand() % 20;
+        c.value = (uint8_t)i;
+        changes.push_back(c);
+    }
+    return changes;
+}
+
+void applyChange(Model &model, const Change &c){
+    if(c.length < 0) model.erase(c.key);
+    else model[c.key] = std::vector<uint8_t>(c.length, c.value);
+}
+
+Model modelAfter(const std::vector<Change> &changes, size_t count){
+    Model model;
+    for(size_t i = 0; i < count; i++) applyChange(model, changes[i]);
+    return model;
+}
+
+bool matches(SettingsJournal &journal, const Model &model){
+    if(journal.getNumKeys() != model.size()) return false;
+    for(auto &entry : model){
+        uint8_t buffer[JOURNAL_MAX_VALUE_LEN];
+        int16_t length = journal.get(entry.first, buffer, sizeof(buffer));
+        if(length != (int)entry.second.size() || memcmp(buffer, entry.second.data(), length) != 0) return false;
+    }
+    return true;
+}
+
+// done: number of completed changes (also valid if a power loss interrupts the run)
+bool run(SettingsJournal &journal, const std::vector<Change> &changes, size_t start, size_t &done){
+    for(done = start; done < changes.size(); done++){
+        const Change &c = changes[done];
+        std::vector<uint8_t> value(c.length < 0 ? 0 : c.length, c.value);
+        bool ok = c.length < 0 ? journal.remove(c.key) : journal.set(c.key, value.data(), c.length);
+        if(!ok) return false;
+    }
+    return true;
+}
+
+int main(){
+    std::vector<Change> changes = makeChanges(NUM_CHANGES);
+    Model expected = modelAfter(changes, changes.size());
+
+    // reference run without power loss, the budget counts the written bytes and file operations
+    FS reference;
+    reference.writeBudget = LONG_MAX;
+    SettingsJournal journal(&reference);
+    journal.begin();
+    size_t done = 0;
+    CHECK(run(journal, changes, 0, done));
+    CHECK(matches(journal, expected));
+    CHECK(journal.getCompactions() >= 3);
+    long total = LONG_MAX - reference.writeBudget;
+    printf("%u changes: %u appends, %u compactions, %ld bytes and file operations\n", NUM_CHANGES,
+           journal.getAppends(), journal.getCompactions(), total);
+    {
+        SettingsJournal reloaded(&reference);
+        CHECK(reloaded.begin());
+        CHECK(matches(reloaded, expected));
+    }
+
+    // power loss after each byte (or file operation) of the workload
+    int inconsistent = 0;
+    int kept = 0;
+    for(long cut = 0; cut <= total; cut++){
+        FS fs;
+        bool crashed = false;
+        {
+            SettingsJournal before(&fs);
+            before.begin();
+            fs.writeBudget = cut;
+            try {
+                run(before, changes, 0, done);
+            } catch(FakePowerLoss &) {
+                crashed = true;
+            }
+        }
+        Model old = modelAfter(changes, done);
+        Model updated = modelAfter(changes, std::min(done + 1, changes.size()));
+
+        // second power loss during the recovery (compaction of an incomplete journal)
+        fs.writeBudget = cut % 53;
+        try {
+            SettingsJournal recovery(&fs);
+            recovery.begin();
+        } catch(FakePowerLoss &) {
+        }
+        fs.writeBudget = -1;
+
+        SettingsJournal after(&fs);
+        after.begin();
+        bool isOld = matches(after, old);
+        bool isUpdated = crashed && matches(after, updated);
+        if(!isOld && !isUpdated){
+            if(inconsistent++ < 5) printf("power loss at %ld: inconsistent values after %zu changes\n", cut, done);
+            continue;
+        }
+        if(!isOld) kept++;
+
+        // continue the workload after the recovery
+        size_t start = isOld ? done : done + 1;
+        if(!run(after, changes, std::min(start, changes.size()), done) || !matches(after, expected)){
+            if(inconsistent++ < 5) printf("power loss at %ld: wrong values after resuming\n", cut);
+            continue;
+        }
+        SettingsJournal restarted(&fs);
+        restarted.begin();
+        if(!matches(restarted, expected)){
+            if(inconsistent++ < 5) printf("power loss at %ld: wrong values after restart\n", cut);
+        }
+    }
+    printf("power loss at every offset (0..%ld): %d inconsistent, interrupted change kept in %d cases\n", total, inconsistent, kept);
+    CHECK_EQUAL(inconsistent, 0);
+
+    return checkResult();
+}
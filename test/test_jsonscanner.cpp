@@ -0,0 +1,289 @@
+/**
+ * @file test_jsonscanner.cpp
+ * @brief Fuzz test of JsonScanner with generated and mutated JSON texts, with a benchmark against the former
+ * String based getJsonParameterValue()
+ *
+ * Generated objects with random keys, escapes, scalars and nested values must give exactly the expected values (also
+ * when fed in random chunks), mutated texts must never write behind the value buffers.
+ *
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <map>
+#include <new>
+#include "jsonscanner.h"
+#include "check.h"
+
+#define FUZZ_OBJECTS 20000
+#define FUZZ_MUTATIONS 50000
+#define BENCHMARK_RUNS 20000
+#define GUARD 0x5A
+
+// ----------------------------------------------------------------------------------
+//                                        ALLOCATION COUNTER
+// ----------------------------------------------------------------------------------
+
+// the default operator delete of libstdc++ releases with free()
+static uint32_t allocations = 0;
+
+void *operator new(size_t size){
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+
+// ----------------------------------------------------------------------------------
+//                                        FIELD TABLE
+// ----------------------------------------------------------------------------------
+
+static const char *keys[] = {"status", "timezone", "offset", "lat", "lon", "message", "query", "isp", "a", "utc_offset"};
+#define NUM_FIELDS 5
+static const uint8_t sizes[NUM_FIELDS] = {12, 40, 12, 4, 16};
+
+// value buffers with guard bytes behind each buffer
+struct Table {
+    char buffers[NUM_FIELDS][48];
+    JsonField fields[NUM_FIELDS];
+
+    Table(){
+        for(int i = 0; i < NUM_FIELDS; i++){
+            memset(buffers[i], GUARD, sizeof(buffers[i]));
+            fields[i] = {keys[i], buffers[i], sizes[i], false};
+        }
+    }
+
+    bool guardsIntact() const {
+        for(int i = 0; i < NUM_FIELDS; i++){
+            for(size_t k = sizes[i]; k < sizeof(buffers[i]); k++){
+                if((uint8_t)buffers[i][k] != GUARD) return false;
+            }
+            if(strnlen(buffers[i], sizes[i]) >= sizes[i]) return false;
+        }
+        return true;
+    }
+};
+
+// ----------------------------------------------------------------------------------
+//                                        GENERATOR
+// ----------------------------------------------------------------------------------
+
+static std::string whitespace(){
+    static const char *spaces[] = {"", "", "", " ", "\n  ", "\t", "\r\n"};
+    return spaces[random(7)];
+}
+
+// string value as JSON text and its unescaped value
+static void randomString(std::string &json, std::string &value){
+    json = "\"";
+    value.clear();
+    int length = random(60);
+    for(int i = 0; i < length; i++){
+        switch(random(12)){
+            case 0: json += "\\\""; value += '"'; break;
+            case 1: json += "\\\\"; value += '\\'; break;
+            case 2: json += "\\n"; value += '\n'; break;
+            case 3: json += "\\/"; value += '/'; break;
+            case 4: json += "\\u00e4"; value += '?'; break;
+            case 5: json += random(2) ? "{" : "]"; value += json.back(); break;
+            default: { char c = 'a' + random(26); json += c; value += c; } break;
+        }
+    }
+    json += "\"";
+}
+
+static std::string randomScalar(){
+    static const char *scalars[] = {"true", "false", "null", "0", "-12", "3.25", "1e-7", "52.5186", "-7200", "3600"};
+    return scalars[random(10)];
+}
+
+static std::string randomNested(int depth){
+    bool object = random(2);
+    std::string json = object ? "{" : "[";
+    int count = random(4);
+    for(int i = 0; i < count; i++){
+        if(i) json += ",";
+        std::string text, value;
+        if(object){
+            randomString(text, value);
+            json += text + ":";
+        }
+        int kind = random(depth < 3 ? 3 : 2);
+        if(kind == 0){
+            randomString(text, value);
+            json += text;
+        }
+        else if(kind == 1){
+            json += randomScalar();
+        }
+        else{
+            json += randomNested(depth + 1);
+        }
+    }
+    return json + (object ? "}" : "]");
+}
+
+// object with some of the keys in random order and the values expected in the field table
+static std::string randomObject(std::map<std::string, std::string> &expected){
+    std::string json = whitespace() + "{";
+    bool used[10] = {false};
+    int count = random(10);
+    for(int i = 0; i < count; i++){
+        int key = random(10);
+        if(used[key]) continue;
+        used[key] = true;
+        if(json.back() != '{') json += ",";
+        json += whitespace() + "\"" + keys[key] + "\"" + whitespace() + ":" + whitespace();
+        std::string text, value;
+        int kind = random(3);
+        if(kind == 0) randomString(text, value);
+        else if(kind == 1) text = value = randomScalar();
+        else text = randomNested(0);
+        json += text + whitespace();
+        // nested values are skipped, the field stays empty
+        if(key < NUM_FIELDS && kind != 2) expected[keys[key]] = value.substr(0, sizes[key] - 1);
+    }
+    return json + "}";
+}
+
+// ----------------------------------------------------------------------------------
+//                                        TESTS
+// ----------------------------------------------------------------------------------
+
+bool matches(const Table &table, const std::map<std::string, std::string> &expected){
+    for(int i = 0; i < NUM_FIELDS; i++){
+        auto value = expected.find(keys[i]);
+        if(value == expected.end()){
+            if(table.fields[i].found) return false;
+        }
+        else if(!table.fields[i].found || value->second != table.fields[i].value){
+            return false;
+        }
+    }
+    return true;
+}
+
+void testGenerated(){
+    int failures = 0;
+    for(int n = 0; n < FUZZ_OBJECTS; n++){
+        std::map<std::string, std::string> expected;
+        std::string json = randomObject(expected);
+
+        Table table;
+        JsonScanner scanner(table.fields, NUM_FIELDS);
+        bool complete = scanner.parse(json.c_str());
+        bool ok = complete && matches(table, expected) && table.guardsIntact();
+
+        // the same text in random chunks, as it arrives from a socket
+        Table chunked;
+        JsonScanner chunkScanner(chunked.fields, NUM_FIELDS);
+        size_t pos = 0;
+        while(pos < json.size()){
+            size_t chunk = std::min(json.size() - pos, (size_t)random(1, 32));
+            for(size_t i = 0; i < chunk; i++) chunkScanner.feed(json[pos + i]);
+            pos += chunk;
+        }
+        ok = ok && chunkScanner.isDone() && matches(chunked, expected) && chunked.guardsIntact();
+
+        if(!ok && failures++ < 3) printf("generated object not scanned correctly: %s\n", json.c_str());
+    }
+    printf("%d generated objects scanned\n", FUZZ_OBJECTS);
+    CHECK_EQUAL(failures, 0);
+}
+
+void testMutated(){
+    int failures = 0;
+    int errors = 0;
+    for(int n = 0; n < FUZZ_MUTATIONS; n++){
+        std::map<std::string, std::string> expected;
+        std::string json = randomObject(expected);
+        int mutations = random(1, 4);
+        for(int i = 0; i < mutations && !json.empty(); i++){
+            size_t pos = random(json.size());
+            switch(random(4)){
+                case 0: json[pos] = (char)random(1, 256); break;
+                case 1: json.erase(pos, 1); break;
+                case 2: json.insert(pos, 1, "{}[]\",:\\u"[random(9)]); break;
+                default: json.resize(pos); break;
+            }
+        }
+
+        Table table;
+        JsonScanner scanner(table.fields, NUM_FIELDS);
+        bool complete = scanner.parse(json.c_str());
+        if(!complete) errors++;
+        if(!table.guardsIntact() && failures++ < 3) printf("buffer overrun with: %s\n", json.c_str());
+    }
+    printf("%d mutated objects scanned, %d rejected or incomplete\n", FUZZ_MUTATIONS, errors);
+    CHECK_EQUAL(failures, 0);
+    CHECK(errors > 0);
+}
+
+// former extraction of a value: copies of the payload and of the needles on each call
+String getJsonParameterValue(String json, String parameter, bool isString){
+    String value = "";
+    if(isString){
+        int index = json.indexOf("\"" + parameter + "\":\"");
+        if(index != -1){
+            int start = index + parameter.length() + 4;
+            int end = json.indexOf("\"", start);
+            value = json.substring(start, end);
+        }
+    }
+    else{
+        int index = json.indexOf("\"" + parameter + "\":");
+        if(index != -1){
+            int start = index + parameter.length() + 3;
+            int end = json.indexOf(",", start);
+            value = json.substring(start, end);
+        }
+    }
+    return value;
+}
+
+void testBenchmark(){
+    const char *answer = "{\"status\":\"success\",\"country\":\"Germany\",\"countryCode\":\"DE\",\"region\":\"BE\","
+                         "\"regionName\":\"Land Berlin\",\"city\":\"Berlin\",\"zip\":\"10117\",\"lat\":52.5186,"
+                         "\"lon\":13.4081,\"timezone\":\"Europe/Berlin\",\"offset\":7200,\"isp\":\"Example ISP\","
+                         "\"query\":\"203.0.113.7\"}";
+    String payload(answer);
+
+    allocations = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < BENCHMARK_RUNS; i++){
+        String timezone = getJsonParameterValue(payload, "timezone", true);
+        String offset = getJsonParameterValue(payload, "offset", false);
+        String lat = getJsonParameterValue(payload, "lat", false);
+        String lon = getJsonParameterValue(payload, "lon", false);
+        CHECK(timezone == "Europe/Berlin" && offset == "7200");
+    }
+    std::chrono::duration<double, std::nano> former = std::chrono::steady_clock::now() - start;
+    uint32_t formerAllocations = allocations;
+
+    char status[12], timezone[40], offset[12], lat[16], lon[16];
+    JsonField fields[] = {{"status", status, sizeof(status)}, {"timezone", timezone, sizeof(timezone)},
+                          {"offset", offset, sizeof(offset)}, {"lat", lat, sizeof(lat)}, {"lon", lon, sizeof(lon)}};
+    JsonScanner scanner(fields, 5);
+    allocations = 0;
+    start = std::chrono::steady_clock::now();
+    for(int i = 0; i < BENCHMARK_RUNS; i++){
+        CHECK(scanner.parse(answer));
+    }
+    std::chrono::duration<double, std::nano> scanned = std::chrono::steady_clock::now() - start;
+    CHECK(strcmp(timezone, "Europe/Berlin") == 0 && strcmp(offset, "7200") == 0 && strcmp(lat, "52.5186") == 0);
+    CHECK_EQUAL(scanner.countFound(), 5);
+
+    printf("answer of the timezone API: getJsonParameterValue() %.0f ns and %.1f allocations, "
+           "JsonScanner %.0f ns and %.1f allocations\n", former.count() / BENCHMARK_RUNS,
+           (double)formerAllocations / BENCHMARK_RUNS, scanned.count() / BENCHMARK_RUNS,
+           (double)allocations / BENCHMARK_RUNS);
+    CHECK_EQUAL(allocations, 0);
+}
+
+int main(){
+    testGenerated();
+    testMutated();
+    testBenchmark();
+    return checkResult();
+}
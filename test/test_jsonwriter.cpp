@@ -0,0 +1,114 @@
+/**
+ * @file test_jsonwriter.cpp
+ * @brief Test of JsonWriter: separators, escaping and numbers, chunks of a response larger than the buffer, and
+ * writing into a buffer of the caller
+ *
+ */
+
+#include <ESP8266WebServer.h>
+#include "jsonwriter.h"
+#include "check.h"
+
+ESP8266WebServer server(80);
+
+void testElements(){
+    server.response = FakeResponse();
+    JsonWriter json(&server);
+    json.begin(200);
+    json.beginObject();
+    json.field("text", "quote \" backslash \\ tab \t newline \n");
+    json.field("empty", "");
+    json.field("bool", true);
+    json.field("int", -42);
+    json.field("unsigned", 4000000000UL);
+    json.key("list");
+    json.beginArray();
+    json.value(1);
+    json.beginObject();
+    json.endObject();
+    json.beginArray();
+    json.endArray();
+    json.raw("{\"a\":null}");
+    json.value(false);
+    json.endArray();
+    json.key("nested");
+    json.beginObject();
+    json.field("x", 0U);
+    json.endObject();
+    json.endObject();
+    json.end();
+
+    const char *expected = "{\"text\":\"quote \\\" backslash \\\\ tab \\u0009 newline \\u000a\",\"empty\":\"\",\"bool\":true,"
+                           "\"int\":-42,\"unsigned\":4000000000,\"list\":[1,{},[],{\"a\":null},false],\"nested\":{\"x\":0}}";
+    CHECK_EQUAL(server.response.code, 200);
+    CHECK(server.response.contentType == "application/json");
+    CHECK(server.response.chunked);
+    CHECK(server.response.body == expected);
+    if(server.response.body != expected) printf("%s\n", server.response.body.c_str());
+    CHECK_EQUAL(json.getBytesWritten(), strlen(expected));
+    // one chunk with the JSON and the empty chunk at the end
+    CHECK_EQUAL(server.response.chunks, 2);
+}
+
+void testChunks(){
+    server.response = FakeResponse();
+    JsonWriter json(&server);
+    json.begin(200);
+    json.beginArray();
+    std::string expected = "[";
+    for(int i = 0; i < 100; i++){
+        json.beginObject();
+        json.field("name", "file.txt");
+        json.field("size", i);
+        json.endObject();
+        expected += (i ? ",{\"name\":\"file.txt\",\"size\":" : "{\"name\":\"file.txt\",\"size\":") + std::to_string(i) + "}";
+    }
+    json.endArray();
+    json.end();
+    expected += "]";
+
+    printf("%zu bytes of JSON in %u chunks\n", expected.size(), server.response.chunks);
+    CHECK(server.response.body == expected);
+    CHECK_EQUAL(json.getBytesWritten(), expected.size());
+    CHECK_EQUAL(server.response.chunks, (expected.size() + JSONWRITER_BUFFER_SIZE - 1) / JSONWRITER_BUFFER_SIZE + 1);
+}
+
+// buffer of the caller: escaped like the response, larger than the internal buffer and truncated if too small
+void testTarget(){
+    char target[600];
+    JsonWriter json(target, sizeof(target));
+    json.beginObject();
+    json.field("mode", "a \"quoted\" name");
+    json.field("modeid", "3");
+    json.endObject();
+    json.end();
+    CHECK(strcmp(target, "{\"mode\":\"a \\\"quoted\\\" name\",\"modeid\":\"3\"}") == 0);
+
+    std::string expected = "[";
+    JsonWriter list(target, sizeof(target));
+    list.beginArray();
+    for(int i = 0; i < 100; i++){
+        list.value(i);
+        expected += (i ? "," : "") + std::to_string(i);
+    }
+    list.endArray();
+    list.end();
+    expected += "]";
+    CHECK(expected.size() > JSONWRITER_BUFFER_SIZE);
+    CHECK(target == expected);
+
+    char small[8];
+    JsonWriter truncated(small, sizeof(small));
+    truncated.beginArray();
+    for(int i = 0; i < 100; i++) truncated.value(i);
+    truncated.endArray();
+    truncated.end();
+    CHECK(strcmp(small, "[0,1,2,") == 0);
+}
+
+int main(){
+    testElements();
+    testChunks();
+    testTarget();
+    return checkResult();
+}
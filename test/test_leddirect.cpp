@@ -0,0 +1,94 @@
+/**
+ * @file test_leddirect.cpp
+ * @brief Test of /leddirect with the complete sketch: valid frames are shown, invalid data leaves the matrix unchanged
+ *
+ */
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include <Adafruit_NeoMatrix.h>
+#include <vector>
+#include "ledmatrix.h"
+#include "check.h"
+
+void setup();
+extern ESP8266WebServer server;
+extern Adafruit_NeoMatrix matrix;
+
+std::string base64(const std::vector<uint8_t> &data){
+    static const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for(size_t i = 0; i < data.size(); i += 3){
+        uint32_t n = data[i] << 16;
+        if(i + 1 < data.size()) n |= data[i + 1] << 8;
+        if(i + 2 < data.size()) n |= data[i + 2];
+        out += alphabet[(n >> 18) & 63];
+        out += alphabet[(n >> 12) & 63];
+        out += i + 1 < data.size() ? alphabet[(n >> 6) & 63] : '=';
+        out += i + 2 < data.size() ? alphabet[n & 63] : '=';
+    }
+    return out;
+}
+
+// frame with 4 bytes per pixel (red, green, blue, unused)
+std::vector<uint8_t> frame(uint16_t numPixels, uint8_t r, uint8_t g, uint8_t b){
+    std::vector<uint8_t> data;
+    for(uint16_t i = 0; i < numPixels; i++){
+        data.insert(data.end(), {r, g, b, 0});
+    }
+    return data;
+}
+
+std::vector<uint16_t> shownFrame(){
+    std::vector<uint16_t> pixels;
+    for(int y = 0; y < HEIGHT; y++){
+        for(int x = 0; x < WIDTH; x++) pixels.push_back(matrix.getPixel(x, y));
+    }
+    return pixels;
+}
+
+int postBase64(const std::string &data){
+    return server.request(HTTP_POST, "/leddirect", {{"data", String(data.c_str())}}).code;
+}
+
+int main(){
+    setup();
+
+    // valid frame
+    CHECK_EQUAL(postBase64(base64(frame(WIDTH * HEIGHT, 200, 100, 50))), 200);
+    std::vector<uint16_t> shown = shownFrame();
+    CHECK(shown[0] != 0 && shown[WIDTH * HEIGHT - 1] == shown[0]);
+
+    // invalid character at the end of another frame: rejected, no pixel of the frame is set
+    std::string invalid = base64(frame(WIDTH * HEIGHT, 0, 0, 255));
+    invalid[invalid.size() - 5] = '*';
+    CHECK_EQUAL(postBase64(invalid), 400);
+    CHECK(shownFrame() == shown);
+
+    // incomplete pixel and more pixels than the matrix has: rejected
+    std::vector<uint8_t> incomplete = frame(2, 0, 0, 255);
+    incomplete.pop_back();
+    CHECK_EQUAL(postBase64(base64(incomplete)), 400);
+    CHECK_EQUAL(postBase64(base64(frame(WIDTH * HEIGHT + 1, 0, 0, 255))), 400);
+    CHECK(shownFrame() == shown);
+
+    // empty frame: shows the matrix as it is, no pixel of the rejected frames may appear
+    CHECK_EQUAL(postBase64(""), 200);
+    CHECK(shownFrame() == shown);
+
+    // part of a frame: only the first pixels change
+    CHECK_EQUAL(postBase64(base64(frame(3, 0, 0, 255))), 200);
+    std::vector<uint16_t> partial = shownFrame();
+    CHECK(partial[0] != shown[0] && partial[2] == partial[0]);
+    CHECK(partial[3] == shown[3]);
+
+    // raw binary frame
+    std::string raw(WIDTH * HEIGHT * 3, '\x40');
+    CHECK_EQUAL(server.request(HTTP_POST, "/leddirect", {{"plain", String(raw.c_str())}},
+                               {{"Content-Type", "application/octet-stream"}}).code, 200);
+    CHECK(shownFrame()[3] != shown[3]);
+    CHECK_EQUAL(server.request(HTTP_POST, "/leddirect", {{"plain", String(raw.substr(1).c_str())}},
+                               {{"Content-Type", "application/octet-stream"}}).code, 400);
+
+    return checkResult();
+}
@@ -0,0 +1,246 @@
+/**
+ * @file test_ledmatrix.cpp
+ * @brief Test of LEDMatrix: the fixed-point blending against the former float formula, the running total of the
+ * estimated current and the current limiter, and the dirty tracking (a converged clock face sends no frames to the LEDs)
+ *
+ */
+
+#include <Arduino.h>
+#include <Adafruit_NeoMatrix.h>
+#include <chrono>
+#include "ledmatrix.h"
+#include "ntp_client_plus.h"
+#include "udplogger.h"
+#include "check.h"
+
+void setup();
+void loop();
+void stateChange(uint8_t newState, bool persistant);
+extern Adafruit_NeoMatrix matrix;
+extern LEDMatrix ledmatrix;
+extern NTPClientPlus ntp;
+extern UDPLogger logger;
+
+#define FACTOR_STEPS 512            // factors k / 512: all Q8 factors and the values halfway between them
+#define TIMING_FRAMES 20000
+
+// former float implementation of LEDMatrix::interpolateColor24bit()
+uint32_t interpolateColor24bitFloat(uint32_t color1, uint32_t color2, float factor){
+    uint8_t resultRed = color1 >> 16 & 0xff;
+    uint8_t resultGreen = color1 >> 8 & 0xff;
+    uint8_t resultBlue = color1 & 0xff;
+    resultRed = (uint8_t)(resultRed + (int16_t)(factor * ((int16_t)(color2 >> 16 & 0xff) - (int16_t)resultRed)));
+    resultGreen = (uint8_t)(resultGreen + (int16_t)(factor * ((int16_t)(color2 >> 8 & 0xff) - (int16_t)resultGreen)));
+    resultBlue = (uint8_t)(resultBlue + (int16_t)(factor * ((int16_t)(color2 & 0xff) - (int16_t)resultBlue)));
+    return LEDMatrix::Color24bit(resultRed, resultGreen, resultBlue);
+}
+
+int channelDifference(uint32_t color1, uint32_t color2, int shift){
+    return abs((int)(color1 >> shift & 0xff) - (int)(color2 >> shift & 0xff));
+}
+
+// fixed-point blending: all start/end values and factors within 1 LSB of the float formula, identical for Q8 factors
+void testInterpolation(){
+    uint32_t differences = 0;
+    int maxDifference = 0;
+    for(int k = 0; k <= FACTOR_STEPS; k++){
+        float factor = (float)k / FACTOR_STEPS;
+        bool exactQ8 = (k % (FACTOR_STEPS / BLEND_FACTOR_ONE) == 0);
+        for(int start = 0; start < 256; start++){
+            for(int end = 0; end < 256; end++){
+                // red and blue blend from start to end, green from end to start
+                uint32_t color1 = LEDMatrix::Color24bit(start, end, start);
+                uint32_t color2 = LEDMatrix::Color24bit(end, start, end);
+                uint32_t expected = interpolateColor24bitFloat(color1, color2, factor);
+                uint32_t result = LEDMatrix::interpolateColor24bit(color1, color2, factor);
+                if(result == expected) continue;
+                differences++;
+                CHECK(!exactQ8);
+                for(int shift = 0; shift <= 16; shift += 8){
+                    maxDifference = max(maxDifference, channelDifference(result, expected, shift));
+                }
+            }
+        }
+    }
+    printf("Q8 blending: %u of %u colors differ from the float formula, max. %d LSB\n", differences,
+           (FACTOR_STEPS + 1) * 256 * 256, maxDifference);
+    CHECK(maxDifference <= 1);
+
+    // timing of the blending of complete frames with the smoothing factor of the clock
+    uint32_t current[WIDTH * HEIGHT];
+    uint32_t target[WIDTH * HEIGHT];
+    for(int i = 0; i < WIDTH * HEIGHT; i++){
+        current[i] = LEDMatrix::Color24bit(i * 2, 255 - i * 2, i);
+        target[i] = LEDMatrix::Color24bit(255 - i, i * 2, 128);
+    }
+    uint32_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int f = 0; f < TIMING_FRAMES; f++){
+        for(int i = 0; i < WIDTH * HEIGHT; i++){
+            checksum += interpolateColor24bitFloat(current[i], target[(i + f) % (WIDTH * HEIGHT)], 0.2);
+        }
+    }
+    auto middle = std::chrono::steady_clock::now();
+    uint16_t factorQ8 = (uint16_t)(0.2 * BLEND_FACTOR_ONE + 0.5);
+    for(int f = 0; f < TIMING_FRAMES; f++){
+        for(int i = 0; i < WIDTH * HEIGHT; i++){
+            checksum += LEDMatrix::interpolateColor24bitQ8(current[i], target[(i + f) % (WIDTH * HEIGHT)], factorQ8);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double pixels = (double)TIMING_FRAMES * WIDTH * HEIGHT;
+    printf("blending on the host: float %.1f ns, Q8 %.1f ns per pixel (checksum %u)\n",
+           std::chrono::duration<double, std::nano>(middle - start).count() / pixels,
+           std::chrono::duration<double, std::nano>(end - middle).count() / pixels, checksum);
+}
+
+// set random colors to all pixels, returns the exact current (mA) at full brightness
+double setRandomColors(LEDMatrix &leds, uint8_t red, uint8_t green, uint8_t blue){
+    double current = 0;
+    for(int y = 0; y < HEIGHT; y++){
+        for(int x = 0; x < WIDTH; x++){
+            uint8_t r = rand() % 256, g = rand() % 256, b = rand() % 256;
+            leds.gridAddPixel(x, y, LEDMatrix::Color24bit(r, g, b));
+            current += (r * red + g * green + b * blue) / 255.0;
+        }
+    }
+    return current;
+}
+
+// running total of the current: equal to a complete recalculation after every blended frame, limiter scales brightness
+void testCurrent(){
+    Adafruit_NeoMatrix neomatrix(WIDTH, HEIGHT + 1, 0, 0, 0);
+    LEDMatrix leds(&neomatrix, 200, &logger);
+    const uint8_t red = 12, green = 18, blue = 16;
+    leds.setCurrentModel(red, green, blue);
+    CHECK_EQUAL(leds.getEstimatedCurrent(), 0);
+
+    srand(3);
+    uint32_t mismatches = 0;
+    auto compareWithRecalculation = [&](){
+        uint16_t running = leds.getEstimatedCurrent();
+        // setCurrentModel() recalculates the total over all pixels
+        leds.setCurrentModel(red, green, blue);
+        if(leds.getEstimatedCurrent() != running) mismatches++;
+    };
+    for(int change = 0; change < 20; change++){
+        // smooth blending to random colors
+        double expected = setRandomColors(leds, red, green, blue);
+        for(int frame = 0; frame < 30; frame++){
+            leds.drawOnMatrixSmooth(0.2);
+            compareWithRecalculation();
+        }
+        // the smooth blending stops a few LSB before the target, an instant frame reaches it exactly
+        expected = setRandomColors(leds, red, green, blue) * 200 / 255;
+        leds.drawOnMatrixInstant();
+        compareWithRecalculation();
+        // the table lookups are truncated, at most 0.01 mA per channel and pixel lower than exact
+        CHECK(leds.getEstimatedCurrent() <= expected);
+        CHECK(leds.getEstimatedCurrent() + WIDTH * HEIGHT * 3 / CURRENT_UNITS_PER_MA + 1 >= expected);
+    }
+    CHECK_EQUAL(mismatches, 0);
+    leds.gridFlush();
+    leds.drawOnMatrixInstant();
+    CHECK_EQUAL(leds.getEstimatedCurrent(), 0);
+
+    // all leds white: brightness scaled down to the limit within the same frame
+    const uint16_t limit = 2000;
+    leds.setCurrentLimit(limit);
+    for(int y = 0; y < HEIGHT; y++){
+        for(int x = 0; x < WIDTH; x++) leds.gridAddPixel(x, y, LEDMatrix::Color24bit(255, 255, 255));
+    }
+    leds.setMinIndicator(15, LEDMatrix::Color24bit(255, 255, 255));
+    uint32_t shows = neomatrix.shows;
+    leds.drawOnMatrixInstant();
+    uint16_t current = leds.getEstimatedCurrent();
+    uint8_t limited = neomatrix.getBrightness();
+    printf("all leds white at brightness 200: %u mA, limit %u mA -> brightness %u\n", current, limit, limited);
+    CHECK(current > limit);
+    CHECK(abs((int)limited - (int)(200 * limit / current)) <= 1);
+    CHECK(current * limited / 200 <= limit);
+    CHECK_EQUAL(neomatrix.shows - shows, 1);
+
+    // below the limit again: the brightness is restored
+    leds.gridFlush();
+    leds.drawOnMatrixInstant();
+    CHECK_EQUAL(neomatrix.getBrightness(), 200);
+}
+
+void runLoop(unsigned long ms){
+    unsigned long start = millis();
+    while(millis() - start < ms){
+        loop();
+        advanceTime(200);
+    }
+}
+
+void runUntilSecond(int second){
+    while(ntp.getSeconds() != second){
+        loop();
+        advanceTime(200);
+    }
+}
+
+// single LEDMatrix: blending until converged, only changed pixels are written
+void testConvergence(){
+    Adafruit_NeoMatrix neomatrix(WIDTH, HEIGHT + 1, 0, 0, 0);
+    LEDMatrix leds(&neomatrix, 255, &logger);
+    leds.gridAddPixel(3, 4, LEDMatrix::Color24bit(255, 128, 0));
+    leds.gridAddPixel(7, 9, LEDMatrix::Color24bit(0, 0, 255));
+    int frames = 0;
+    while(frames < 200){
+        uint32_t shows = neomatrix.shows;
+        leds.drawOnMatrixSmooth(0.2);
+        if(neomatrix.shows == shows) break;
+        frames++;
+    }
+    printf("blending with factor 0.2 converged after %d frames\n", frames);
+    CHECK(frames > 1 && frames < 200);
+
+    uint32_t shows = neomatrix.shows;
+    uint32_t writes = neomatrix.pixelWrites;
+    uint32_t skipped = leds.getFramesSkipped();
+    for(int i = 0; i < 100; i++) leds.drawOnMatrixSmooth(0.2);
+    CHECK_EQUAL(neomatrix.shows, shows);
+    CHECK_EQUAL(neomatrix.pixelWrites, writes);
+    CHECK_EQUAL(leds.getFramesSkipped() - skipped, 100);
+
+    // one changed pixel: one write and one frame
+    leds.gridAddPixel(0, 0, LEDMatrix::Color24bit(10, 10, 10));
+    leds.drawOnMatrixInstant();
+    CHECK_EQUAL(neomatrix.pixelWrites - writes, 1);
+    CHECK_EQUAL(neomatrix.shows - shows, 1);
+}
+
+// complete sketch in the clock state: no frames between the changes of the time
+void testClockFace(){
+    setup();
+    stateChange(0, false);
+    runLoop(20000);
+
+    runUntilSecond(5);
+    uint32_t shows = matrix.shows;
+    uint32_t skipped = ledmatrix.getFramesSkipped();
+    runUntilSecond(0);
+    printf("converged clock face: %u frames sent, %u skipped within 55 s\n", matrix.shows - shows,
+           ledmatrix.getFramesSkipped() - skipped);
+    CHECK_EQUAL(matrix.shows - shows, 0);
+    CHECK(ledmatrix.getFramesSkipped() - skipped > 500);
+
+    // the change of the minute is blended in and converges again
+    shows = matrix.shows;
+    runUntilSecond(5);
+    printf("change of the minute: %u frames sent\n", matrix.shows - shows);
+    CHECK(matrix.shows - shows > 0);
+    shows = matrix.shows;
+    runUntilSecond(0);
+    CHECK_EQUAL(matrix.shows - shows, 0);
+}
+
+int main(){
+    testInterpolation();
+    testCurrent();
+    testConvergence();
+    testClockFace();
+    return checkResult();
+}
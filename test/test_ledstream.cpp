@@ -0,0 +1,115 @@
+/**
+ * @file test_ledstream.cpp
+ * @brief Test of the UDP LED stream with the complete sketch: replay of a 60 fps DDP stream with duplicated and
+ * reordered packets, latency until the frame is shown and fallback to the clock after the stream ends
+ *
+ * The packets are built like ledstream_sender.py does (one packet with push flag per frame).
+ *
+ */
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <Adafruit_NeoMatrix.h>
+#include <vector>
+#include "ledmatrix.h"
+#include "ledstream.h"
+#include "check.h"
+
+#define STREAM_FPS 60
+#define STREAM_SECONDS 10
+#define DUPLICATE_EVERY 50          // every 50th packet is sent twice
+#define SWAP_EVERY 100              // every 100th packet is overtaken by the following one
+
+void setup();
+void loop();
+extern Adafruit_NeoMatrix matrix;
+extern LEDStream ledstream;
+
+std::vector<uint8_t> ddpPacket(uint32_t frame){
+    uint8_t sequence = frame % 15 + 1;
+    std::vector<uint8_t> packet = {DDP_FLAGS_VERSION_1 | DDP_FLAGS_PUSH, sequence, DDP_TYPE_RGB8, DDP_ID_DISPLAY, 0, 0, 0, 0,
+                                   (WIDTH * HEIGHT * 3) >> 8, (WIDTH * HEIGHT * 3) & 0xFF};
+    // uniform color which changes with every frame
+    for(int i = 0; i < WIDTH * HEIGHT; i++){
+        packet.insert(packet.end(), {(uint8_t)(frame * 8), (uint8_t)(255 - frame * 8), 128});
+    }
+    return packet;
+}
+
+void send(const std::vector<uint8_t> &packet){
+    CHECK(WiFiUDP::deliver(LEDSTREAM_PORT, packet.data(), packet.size()));
+}
+
+bool isUniform(){
+    for(int y = 0; y < HEIGHT; y++){
+        for(int x = 0; x < WIDTH; x++){
+            if(matrix.getPixel(x, y) != matrix.getPixel(0, 0)) return false;
+        }
+    }
+    return matrix.getPixel(0, 0) != 0;
+}
+
+int main(){
+    setup();
+    uint32_t framesBefore = ledstream.getFramesReceived();
+    uint32_t showsBefore = matrix.shows;
+
+    // replay the stream, each packet is sent at its time of the 60 fps raster
+    uint32_t numFrames = STREAM_FPS * STREAM_SECONDS;
+    unsigned long start = millis();
+    unsigned long maxLatency = 0;
+    uint16_t maxFps = 0;
+    uint32_t expectedDrops = 0;
+    uint32_t overtaken = 0;
+    for(uint32_t frame = 0; frame < numFrames; frame++){
+        while(millis() - start < frame * 1000 / STREAM_FPS) loop();
+
+        uint32_t shows = matrix.shows;
+        unsigned long sent = millis();
+        if(frame % SWAP_EVERY == SWAP_EVERY - 1 && frame + 1 < numFrames){
+            // the next frame arrives first, this one is too old then
+            send(ddpPacket(frame + 1));
+            send(ddpPacket(frame));
+            expectedDrops++;
+            overtaken++;
+            frame++;
+        }
+        else{
+            send(ddpPacket(frame));
+            if(frame % DUPLICATE_EVERY == DUPLICATE_EVERY - 1){
+                send(ddpPacket(frame));
+                expectedDrops++;
+            }
+        }
+        while(matrix.shows == shows) loop();
+        maxLatency = std::max(maxLatency, millis() - sent);
+        maxFps = std::max(maxFps, ledstream.getFramesPerSecond());
+    }
+    uint32_t frames = ledstream.getFramesReceived() - framesBefore;
+    printf("%u frames in %lu ms: %u received, %u dropped, %u invalid, %u fps, %lu ms max. latency, %u frames shown\n",
+           numFrames, millis() - start, frames, ledstream.getPacketsDropped(), ledstream.getPacketsInvalid(), maxFps,
+           maxLatency, matrix.shows - showsBefore);
+    CHECK_EQUAL(frames, numFrames - overtaken);
+    CHECK_EQUAL(ledstream.getPacketsDropped(), expectedDrops);
+    CHECK_EQUAL(ledstream.getPacketsInvalid(), 0);
+    CHECK(maxFps >= STREAM_FPS - 2 && maxFps <= STREAM_FPS + 1);
+    CHECK(maxLatency <= 10);
+    CHECK(isUniform());
+
+    // invalid packet: counted, the shown frame stays
+    std::vector<uint8_t> query = ddpPacket(0);
+    query[0] |= DDP_FLAGS_QUERY;
+    send(query);
+    uint16_t shown = matrix.getPixel(0, 0);
+    for(int i = 0; i < 10; i++) loop();
+    CHECK_EQUAL(ledstream.getPacketsInvalid(), 1);
+    CHECK_EQUAL(matrix.getPixel(0, 0), shown);
+
+    // the clock takes over again after TIMEOUT_LEDDIRECT
+    unsigned long end = millis();
+    while(millis() - end < 4000) loop();
+    CHECK(isUniform());
+    while(millis() - end < 7000) loop();
+    CHECK(!isUniform());
+    return checkResult();
+}
@@ -0,0 +1,211 @@
+/**
+ * @file test_ntp.cpp
+ * @brief Test of the asynchronous NTP update against a fake server with latency: the longest stall of a loop cycle
+ * with the blocking updateNTP() and with beginUpdate() / poll(), and the discipline of a skewed local clock
+ *
+ */
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <deque>
+#include "ntp_client_plus.h"
+#include "check.h"
+
+#define NTP_EPOCH_OFFSET 2208988800ULL
+#define LOOP_CYCLE_US 5000
+#define SKEW_PPM 120                // the local clock (millis()) runs 120 ppm slower than the server
+#define DISCIPLINE_HOURS 12
+
+// NTP server which answers after a latency, or never if silent, its clock can run faster than millis()
+class FakeNTPServer : public UDP {
+    public:
+        unsigned long latency = 0;
+        bool silent = false;
+        int requests = 0;
+        long skewPpm = 0;
+
+        uint8_t begin(uint16_t port) override { (void)port; return 1; }
+        void stop() override {}
+        int beginPacket(const char *host, uint16_t port) override { (void)host; (void)port; return 1; }
+        int beginPacket(IPAddress ip, uint16_t port) override { (void)ip; (void)port; return 1; }
+        size_t write(const uint8_t *buffer, size_t size) override {
+            memcpy(request, buffer, std::min(size, sizeof(request)));
+            return size;
+        }
+        int endPacket() override {
+            requests++;
+            if(silent) return 1;
+            Answer answer = {millis() + latency, {0x24, 2, 6, 0xEC}};
+            memcpy(answer.data + 24, request + 40, 8);
+            answers.push_back(answer);
+            return 1;
+        }
+        int parsePacket() override {
+            if(answers.empty() || (long)(millis() - answers.front().due) < 0) return 0;
+            current = answers.front();
+            answers.pop_front();
+            // receive and transmit timestamp of the server
+            writeTimestamp(current.data + 32, serverMillis() - latency / 2);
+            writeTimestamp(current.data + 40, serverMillis() - latency / 2);
+            return NTP_PACKET_SIZE;
+        }
+        int read(unsigned char *buffer, size_t length) override {
+            memcpy(buffer, current.data, std::min(length, (size_t)NTP_PACKET_SIZE));
+            return NTP_PACKET_SIZE;
+        }
+        void flush() override {}
+        int64_t serverMillis() { return fakeUTCMillis() + (int64_t)millis() * skewPpm / 1000000; }
+
+    private:
+        struct Answer {
+            unsigned long due;
+            uint8_t data[NTP_PACKET_SIZE];
+        };
+        std::deque<Answer> answers;
+        Answer current;
+        uint8_t request[NTP_PACKET_SIZE];
+
+        static void writeTimestamp(uint8_t *buffer, int64_t utcMillis){
+            uint32_t seconds = (uint32_t)(utcMillis / 1000 + NTP_EPOCH_OFFSET);
+            uint32_t fraction = (uint32_t)(((utcMillis % 1000) << 32) / 1000);
+            for(int i = 0; i < 4; i++){
+                buffer[i] = seconds >> (24 - 8 * i);
+                buffer[4 + i] = fraction >> (24 - 8 * i);
+            }
+        }
+};
+
+// blocking update: the loop cycle lasts until the answer or the timeout
+unsigned long blockingStall(FakeNTPServer &server, int &result){
+    NTPClientPlus ntp(server, "pool.ntp.org", "UTC0");
+    unsigned long start = millis();
+    result = ntp.updateNTP();
+    return millis() - start;
+}
+
+// asynchronous update: the loop only checks for the answer, the longest cycle is measured
+unsigned long asyncStall(FakeNTPServer &server, int &result, unsigned long &duration){
+    NTPClientPlus ntp(server, "pool.ntp.org", "UTC0");
+    unsigned long start = millis();
+    unsigned long maxStall = 0;
+    unsigned long cycleStart = millis();
+    CHECK(ntp.beginUpdate());
+    CHECK(!ntp.beginUpdate());
+    maxStall = millis() - cycleStart;
+    do{
+        advanceTime(LOOP_CYCLE_US);
+        cycleStart = millis();
+        result = ntp.poll();
+        maxStall = std::max(maxStall, millis() - cycleStart);
+    }while(result == NTP_UPDATE_PENDING);
+    duration = millis() - start;
+    CHECK(!ntp.isUpdatePending());
+    CHECK_EQUAL(ntp.poll(), NTP_UPDATE_IDLE);
+    return maxStall;
+}
+
+void testLatency(unsigned long latency, bool silent, int expected){
+    FakeNTPServer server;
+    server.latency = latency;
+    server.silent = silent;
+
+    int result;
+    unsigned long before = blockingStall(server, result);
+    CHECK_EQUAL(result, expected);
+    unsigned long duration;
+    unsigned long after = asyncStall(server, result, duration);
+    CHECK_EQUAL(result, expected);
+    CHECK_EQUAL(server.requests, 2);
+
+    printf("server %-14s longest loop stall: updateNTP() %4lu ms, poll() %lu ms (answer after %lu ms)\n",
+           silent ? "silent:" : (std::to_string(latency) + " ms latency:").c_str(), before, after, duration);
+    CHECK(before >= (silent ? NTP_TIMEOUT : latency));
+    CHECK_EQUAL(after, 0);
+    CHECK(duration >= (silent ? NTP_TIMEOUT : latency) && duration <= (silent ? NTP_TIMEOUT : latency) + 10);
+}
+
+// an answer to an older request is ignored, the pending request still gets its own answer
+void testStaleAnswer(){
+    FakeNTPServer server;
+    server.latency = 1500;
+    NTPClientPlus ntp(server, "pool.ntp.org", "UTC0");
+    CHECK(ntp.beginUpdate());
+    int result;
+    while((result = ntp.poll()) == NTP_UPDATE_PENDING) advanceTime(LOOP_CYCLE_US);
+    CHECK_EQUAL(result, NTP_UPDATE_TIMEOUT);
+
+    // the late answer of the first request arrives while the second one is pending
+    server.latency = 800;
+    advanceTime(100000);
+    unsigned long start = millis();
+    CHECK(ntp.beginUpdate());
+    while((result = ntp.poll()) == NTP_UPDATE_PENDING) advanceTime(LOOP_CYCLE_US);
+    CHECK_EQUAL(result, NTP_UPDATE_OK);
+    CHECK(millis() - start >= 800);
+    CHECK(ntp.isSynced());
+}
+
+// local clock with ms resolution
+int64_t localMillis(NTPClientPlus &ntp){
+    return (int64_t)ntp.getEpochTime() * 1000 + ntp.getMilliseconds();
+}
+
+// skewed local clock: the drift estimation converges, offsets are slewed without steps and the poll interval grows
+void testDiscipline(){
+    FakeNTPServer server;
+    server.latency = 30;
+    server.skewPpm = SKEW_PPM;
+    NTPClientPlus ntp(server, "pool.ntp.org", "UTC0");
+
+    int updates = 0;
+    long maxOffset = 0;
+    long maxJump = 0;
+    unsigned long lastPollInterval = 0;
+    int pollIncreases = 0;
+    unsigned long start = millis();
+    while(millis() - start < DISCIPLINE_HOURS * 3600000UL){
+        CHECK(ntp.beginUpdate());
+        int result;
+        while((result = ntp.poll()) == NTP_UPDATE_PENDING){
+            int64_t before = localMillis(ntp);
+            advanceTime(LOOP_CYCLE_US);
+            int64_t now = localMillis(ntp);
+            // the update is processed within poll(), the clock advances steadily across it
+            if(ntp.isSynced()) maxJump = std::max(maxJump, (long)std::abs(now - before - LOOP_CYCLE_US / 1000));
+        }
+        CHECK_EQUAL(result, NTP_UPDATE_OK);
+        // the first update sets the clock, all others are corrected by slewing
+        if(updates++ > 0) maxOffset = std::max(maxOffset, std::labs(ntp.getOffset()));
+        if(ntp.getPollInterval() > lastPollInterval) pollIncreases++;
+        lastPollInterval = ntp.getPollInterval();
+
+        // the clock between the updates: no jumps, at most the slew rate plus the rounding of a ms
+        unsigned long waitStart = millis();
+        while(millis() - waitStart < ntp.getPollInterval()){
+            int64_t before = localMillis(ntp);
+            advanceTime(1000000);
+            maxJump = std::max(maxJump, (long)std::abs(localMillis(ntp) - before - 1000));
+        }
+    }
+
+    long error = (long)(server.serverMillis() - localMillis(ntp));
+    printf("skew %d ppm, %d h: %d updates, drift %ld ppb, max. offset after the first update %ld ms, poll interval "
+           "%lu s, max. deviation of 1 s steps %ld ms, final error %ld ms\n", SKEW_PPM, DISCIPLINE_HOURS, updates,
+           ntp.getDrift(), maxOffset, ntp.getPollInterval() / 1000, maxJump, error);
+    CHECK(std::labs(ntp.getDrift() - SKEW_PPM * 1000) <= SKEW_PPM * 1000 / 10);
+    CHECK(maxOffset < NTP_STEP_THRESHOLD);
+    // slew rate (0.5 ms/s) and drift correction below 1 ms per second, plus the rounding to ms
+    CHECK(maxJump <= 2);
+    CHECK_EQUAL(ntp.getPollInterval(), NTP_POLL_MAX);
+    CHECK(pollIncreases >= 5);
+    CHECK(std::labs(ntp.getOffset()) < NTP_POLL_STABLE_OFFSET);
+}
+
+int main(){
+    testLatency(50, false, NTP_UPDATE_OK);
+    testLatency(400, false, NTP_UPDATE_OK);
+    testLatency(0, true, NTP_UPDATE_TIMEOUT);
+    testStaleAnswer();
+    testDiscipline();
+    return checkResult();
+}
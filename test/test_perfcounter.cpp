@@ -0,0 +1,120 @@
+/**
+ * @file test_perfcounter.cpp
+ * @brief Test of PerfCounter with known durations: min, avg, max and percentiles, the bounds of the histogram
+ * buckets, and the halving of the histogram before a bucket overflows
+ *
+ */
+
+#include <Arduino.h>
+#include "perfcounter.h"
+#include "check.h"
+
+#define CYCLES_PER_US 80            // ESP.getCpuFreqMHz() of the shim
+#define LONG_DURATION 1000000       // 1 s, in the last bucket
+
+void recordUs(PerfCounter &perf, int8_t section, uint32_t us){
+    perf.record(section, us * CYCLES_PER_US);
+}
+
+// durations 1 ... 1000 us
+void testStatistics(){
+    PerfCounter perf;
+    int8_t section = perf.addSection("loop");
+    CHECK_EQUAL(section, 0);
+    CHECK_EQUAL(perf.getPercentile(section, 50), 0);
+    for(uint32_t us = 1000; us >= 1; us--) recordUs(perf, section, us);
+
+    CHECK_EQUAL(perf.getCount(section), 1000);
+    CHECK_EQUAL(perf.getMin(section), 1);
+    CHECK_EQUAL(perf.getAvg(section), 500);
+    CHECK_EQUAL(perf.getMax(section), 1000);
+    // 10 is in the bucket 10 - 11, 500 in 448 - 511, 990 in 896 - 1023 (limited to max)
+    CHECK_EQUAL(perf.getPercentile(section, 50), 511);
+    CHECK_EQUAL(perf.getPercentile(section, 99), 1000);
+    CHECK_EQUAL(perf.getPercentile(section, 100), 1000);
+    CHECK_EQUAL(perf.getPercentile(section, 1), 11);
+
+    // invalid sections and reset
+    CHECK_EQUAL(perf.getCount(PERF_NO_SECTION), 0);
+    CHECK_EQUAL(perf.getMax(5), 0);
+    perf.reset();
+    CHECK_EQUAL(perf.getCount(section), 0);
+    CHECK_EQUAL(perf.getMin(section), 0);
+    CHECK_EQUAL(perf.getAvg(section), 0);
+    CHECK_EQUAL(perf.getPercentile(section, 99), 0);
+
+    for(int i = 1; i < PERF_MAX_SECTIONS; i++) CHECK(perf.addSection("section") != PERF_NO_SECTION);
+    CHECK_EQUAL(perf.addSection("too many"), PERF_NO_SECTION);
+    CHECK_EQUAL(perf.getNumSections(), PERF_MAX_SECTIONS);
+}
+
+// upper bound of the bucket of a duration: median of the duration and a longer one
+uint32_t bucketUpperBound(PerfCounter &perf, int8_t section, uint32_t us){
+    perf.reset();
+    recordUs(perf, section, us);
+    recordUs(perf, section, LONG_DURATION);
+    return perf.getPercentile(section, 50);
+}
+
+// buckets are contiguous, 4 per power of two (relative error < 25%), durations from 114.7 ms in the last bucket
+void testBuckets(){
+    PerfCounter perf;
+    int8_t section = perf.addSection("buckets");
+    uint32_t buckets = 0;
+    uint32_t previousBound = 0;
+    uint32_t lastBucketStart = 0;
+    for(uint32_t us = 0; us <= 200000; us++){
+        uint32_t bound = bucketUpperBound(perf, section, us);
+        CHECK(bound >= us);
+        if(us == 0 || us > previousBound){
+            // first duration of a new bucket directly follows the bound of the previous one
+            CHECK(us == 0 || us == previousBound + 1);
+            CHECK(us < 4 || bound == LONG_DURATION || (bound - us + 1) * 4 <= us);
+            buckets++;
+            lastBucketStart = us;
+        }
+        else{
+            CHECK_EQUAL(bound, previousBound);
+        }
+        previousBound = bound;
+        if(bound == LONG_DURATION) break;
+    }
+    printf("%u buckets, the last one starts at %u us\n", buckets, lastBucketStart);
+    CHECK_EQUAL(buckets, PERF_HIST_BUCKETS);
+    CHECK_EQUAL(lastBucketStart, 114688);
+    CHECK_EQUAL(bucketUpperBound(perf, section, 3), 3);
+    CHECK_EQUAL(bucketUpperBound(perf, section, 4), 4);
+    CHECK_EQUAL(bucketUpperBound(perf, section, 1000), 1023);
+}
+
+// a bucket at its limit: all buckets are halved, the distribution is kept and count, min, avg and max are exact
+void testHalving(){
+    PerfCounter perf;
+    int8_t section = perf.addSection("halving");
+    for(uint32_t i = 0; i < UINT16_MAX; i++) recordUs(perf, section, 10);
+    for(uint32_t i = 0; i < 100; i++) recordUs(perf, section, 1000);
+    // before the halving 100 of 65635 durations are long, the 99.9 % percentile is still short
+    CHECK_EQUAL(perf.getPercentile(section, 99), 11);
+    CHECK_EQUAL(perf.getPercentile(section, 100), 1000);
+
+    // the next short duration halves all buckets: 32768 short and 50 long ones
+    recordUs(perf, section, 10);
+    CHECK_EQUAL(perf.getCount(section), UINT16_MAX + 101);
+    CHECK_EQUAL(perf.getMin(section), 10);
+    CHECK_EQUAL(perf.getMax(section), 1000);
+    CHECK_EQUAL(perf.getAvg(section), (10ULL * (UINT16_MAX + 1) + 1000 * 100) / (UINT16_MAX + 101));
+    CHECK_EQUAL(perf.getPercentile(section, 99), 11);
+    CHECK_EQUAL(perf.getPercentile(section, 100), 1000);
+
+    // 40000 more long ones: 50 + 40000 of 72818 are long, the median moves to the long durations
+    for(uint32_t i = 0; i < 40000; i++) recordUs(perf, section, 1000);
+    CHECK_EQUAL(perf.getPercentile(section, 40), 11);
+    CHECK_EQUAL(perf.getPercentile(section, 50), 1000);
+}
+
+int main(){
+    testStatistics();
+    testBuckets();
+    testHalving();
+    return checkResult();
+}
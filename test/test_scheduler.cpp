@@ -0,0 +1,96 @@
+/**
+ * @file test_scheduler.cpp
+ * @brief Test of the task scheduler with the complete sketch: lateness of the matrix update with slow request
+ * handlers, one clock update per second and no blocking of the loop after a loss of the WiFi connection
+ *
+ */
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include <Adafruit_NeoMatrix.h>
+#include "scheduler.h"
+#include "check.h"
+
+#define SLOW_HANDLER_MS 40          // duration of a slow request (e.g. a file upload or a long JSON answer)
+#define SLOW_HANDLER_EVERY 25       // every 25th call of handleClient() gets a slow request
+#define RUN_SECONDS 60
+
+// as in wordclock_esp8266.ino
+#define PERIOD_HEARTBEAT 5000
+#define TIMEOUT_WIFI_DISCONNECTED 30000
+#define MAX_LOOP_SLEEP 5
+
+void setup();
+void loop();
+void stateChange(uint8_t newState, bool persistant);
+extern ESP8266WebServer server;
+extern Adafruit_NeoMatrix matrix;
+extern Scheduler scheduler;
+extern int8_t taskStateBehavior;
+extern int8_t taskMatrixUpdate;
+
+struct LoopStats {
+    uint32_t behaviorRuns = 0;
+    uint32_t maxLatenessMatrix = 0;
+    uint32_t maxLatenessBehavior = 0;
+    uint32_t maxLoopTime = 0;
+};
+
+/**
+ * @brief Run the loop, the statistics of the scheduler are reset by the heartbeat task, which is the first task and
+ * therefore runs before the other tasks of the same loop cycle
+ */
+LoopStats runLoop(unsigned long ms){
+    LoopStats stats;
+    scheduler.resetStats();
+    uint32_t lastRuns = scheduler.getRuns(taskStateBehavior);
+    unsigned long start = millis();
+    while(millis() - start < ms){
+        unsigned long loopStart = millis();
+        loop();
+        stats.maxLoopTime = max(stats.maxLoopTime, (uint32_t)(millis() - loopStart));
+        uint32_t runs = scheduler.getRuns(taskStateBehavior);
+        stats.behaviorRuns += runs >= lastRuns ? runs - lastRuns : runs;
+        lastRuns = runs;
+        stats.maxLatenessMatrix = max(stats.maxLatenessMatrix, scheduler.getMaxLateness(taskMatrixUpdate));
+        stats.maxLatenessBehavior = max(stats.maxLatenessBehavior, scheduler.getMaxLateness(taskStateBehavior));
+    }
+    return stats;
+}
+
+int main(){
+    setup();
+    stateChange(0, false);
+    runLoop(2000);
+
+    // slow request handlers delay the tasks at most by the duration of one request
+    uint32_t calls = 0;
+    server.onHandleClient = [&calls](){
+        if(++calls % SLOW_HANDLER_EVERY == 0) delay(SLOW_HANDLER_MS);
+    };
+    LoopStats stats = runLoop(RUN_SECONDS * 1000UL);
+    printf("slow handlers (%d ms every %d loops): max lateness matrix %u ms, behavior %u ms, clock updates in %d s: %u\n",
+           SLOW_HANDLER_MS, SLOW_HANDLER_EVERY, stats.maxLatenessMatrix, stats.maxLatenessBehavior, RUN_SECONDS,
+           stats.behaviorRuns);
+    CHECK(stats.maxLatenessMatrix > 0);
+    CHECK(stats.maxLatenessMatrix <= SLOW_HANDLER_MS);
+    CHECK(stats.maxLatenessBehavior <= SLOW_HANDLER_MS);
+    // the clock is updated once per second, a late run must not be followed by a second run in the same second
+    CHECK(stats.behaviorRuns >= RUN_SECONDS - 1 && stats.behaviorRuns <= RUN_SECONDS + 1);
+    server.onHandleClient = nullptr;
+
+    // loss of the WiFi connection: the red pixel is shown without blocking the loop
+    WiFi.connectionStatus = WL_DISCONNECTED;
+    stats = runLoop(TIMEOUT_WIFI_DISCONNECTED + 2 * PERIOD_HEARTBEAT);
+    printf("WiFi lost: max loop time %u ms, max lateness matrix %u ms\n", stats.maxLoopTime, stats.maxLatenessMatrix);
+    CHECK(stats.maxLoopTime <= MAX_LOOP_SLEEP);
+    CHECK(stats.maxLatenessMatrix <= MAX_LOOP_SLEEP);
+    uint16_t pixel = matrix.getPixel(0, 5);
+    CHECK((pixel >> 11) > 0 && ((pixel >> 5) & 0x3F) == 0 && (pixel & 0x1F) == 0);
+
+    // the red pixel disappears after the reconnection
+    WiFi.connectionStatus = WL_CONNECTED;
+    runLoop(2 * PERIOD_HEARTBEAT);
+    CHECK(matrix.getPixel(0, 5) != pixel);
+    return checkResult();
+}
@@ -0,0 +1,138 @@
+/**
+ * @file test_settings.cpp
+ * @brief Test of SettingsStore: coalesced commits, skipped no-op writes, migration of the old byte address map
+ *
+ */
+
+#include <EEPROM.h>
+#include "settings.h"
+#include "check.h"
+
+Settings defaults(){
+    Settings d;
+    memset(&d, 0, sizeof(d));
+    d.nightModeStartHour = 22;
+    d.nightModeEndHour = 7;
+    d.brightness = 40;
+    d.layout = 0;
+    return d;
+}
+
+// run the settings task (every 500 ms like in the sketch) for the given time
+void runTask(SettingsStore &store, unsigned long ms){
+    for(unsigned long t = 0; t < ms; t += 500){
+        delay(500);
+        store.handle();
+    }
+}
+
+// old byte address map (version 3), addresses 14.. were erased flash on clocks with the first firmware
+void writeLegacy(bool withTimezone){
+    memset(EEPROM.flash, 0xFF, sizeof(EEPROM.flash));
+    uint8_t legacy[] = {3, 21, 6, 30, 15, 123, 10, 20, 30, 1, 1, 2, 0, 17};
+    memcpy(EEPROM.flash, legacy, sizeof(legacy));
+    if(withTimezone){
+        EEPROM.flash[14] = 2;
+        uint32_t expires = 1800000000;
+        memcpy(EEPROM.flash + 15, &expires, sizeof(expires));
+        strcpy((char*)EEPROM.flash + 19, "CET-1CEST,M3.5.0,M10.5.0/3");
+    }
+}
+
+void testMigration(){
+    // first firmware: no layout and timezone in the old map
+    writeLegacy(false);
+    SettingsStore store;
+    CHECK(!store.begin(defaults()));
+    CHECK_EQUAL(store.get().nightModeStartHour, 21);
+    CHECK_EQUAL(store.get().nightModeEndMin, 15);
+    CHECK_EQUAL(store.get().brightness, 123);
+    CHECK_EQUAL(store.get().mainColorBlue, 30);
+    CHECK_EQUAL(store.get().nightModeBrightness, 17);
+    CHECK_EQUAL(store.get().layout, 0);
+    CHECK_EQUAL(store.get().tzRule[0], '\0');
+    CHECK_EQUAL(store.get().tzExpires, 0);
+
+    // later firmware with layout and cached timezone
+    writeLegacy(true);
+    SettingsStore migrated;
+    CHECK(!migrated.begin(defaults()));
+    CHECK_EQUAL(migrated.get().layout, 2);
+    CHECK(strcmp(migrated.get().tzRule, "CET-1CEST,M3.5.0,M10.5.0/3") == 0);
+    CHECK_EQUAL(migrated.get().tzExpires, 1800000000);
+
+    // invalid rule (garbage in the flash) is dropped
+    writeLegacy(true);
+    strcpy((char*)EEPROM.flash + 19, "CET-1CEST,M13.5.0");
+    SettingsStore invalid;
+    invalid.begin(defaults());
+    CHECK_EQUAL(invalid.get().tzRule[0], '\0');
+    CHECK_EQUAL(invalid.get().tzExpires, 0);
+
+    // the migrated settings are written once and loaded without a write at the next start
+    uint32_t commits = EEPROM.commits;
+    SettingsStore restarted;
+    CHECK(restarted.begin(defaults()));
+    CHECK_EQUAL(restarted.get().layout, 2);
+    CHECK_EQUAL(EEPROM.commits, commits);
+}
+
+void testCoalescing(){
+    memset(EEPROM.flash, 0xFF, sizeof(EEPROM.flash));
+    SettingsStore store;
+    CHECK(!store.begin(defaults()));
+    CHECK_EQUAL(store.getWriteCount(), 1);
+
+    // slider drag: 50 brightness updates within 2 s
+    uint32_t commits = EEPROM.commits;
+    for(int i = 0; i < 50; i++){
+        store.set(&Settings::brightness, 10 + i * 4);
+        delay(40);
+        if(millis() % 500 < 40) store.handle();
+    }
+    runTask(store, 10000);
+    printf("slider drag with 50 updates: %u commit(s)\n", EEPROM.commits - commits);
+    CHECK_EQUAL(EEPROM.commits - commits, 1);
+    CHECK_EQUAL(store.get().brightness, 10 + 49 * 4);
+
+    // change which is reverted before the quiet period ends: no write
+    commits = EEPROM.commits;
+    store.set(&Settings::layout, 3);
+    store.set(&Settings::layout, 0);
+    runTask(store, 10000);
+    CHECK_EQUAL(EEPROM.commits - commits, 0);
+    CHECK(!store.isPending());
+
+    // same value: not even marked as changed
+    store.set(&Settings::brightness, store.get().brightness);
+    CHECK(!store.isPending());
+
+    // continuous changes every second for 95 s: written at least every SETTINGS_MAX_COMMIT_DELAY
+    commits = EEPROM.commits;
+    for(int i = 0; i < 95; i++){
+        store.set(&Settings::brightness, 100 + i);
+        runTask(store, 1000);
+    }
+    runTask(store, 10000);
+    printf("continuous changes for 95 s: %u commits\n", EEPROM.commits - commits);
+    CHECK_EQUAL(EEPROM.commits - commits, 95000 / SETTINGS_MAX_COMMIT_DELAY + 1);
+
+    // write counter survives a restart
+    uint32_t writes = store.getWriteCount();
+    SettingsStore restarted;
+    CHECK(restarted.begin(defaults()));
+    CHECK_EQUAL(restarted.getWriteCount(), writes);
+    CHECK_EQUAL(restarted.get().brightness, 194);
+
+    // corrupted settings: defaults are used and written
+    EEPROM.flash[20] ^= 1;
+    SettingsStore corrupted;
+    CHECK(!corrupted.begin(defaults()));
+    CHECK_EQUAL(corrupted.get().brightness, 40);
+}
+
+int main(){
+    testMigration();
+    testCoalescing();
+    return checkResult();
+}
@@ -0,0 +1,126 @@
+/**
+ * @file test_telemetry.cpp
+ * @brief Test of the telemetry frame against telemetry_receiver.py: a frame packed by Telemetry::send() is decoded
+ * with the struct format of the receiver, frames of other versions are rejected
+ *
+ * The receiver is run with python3 (as merge_sketch.py by the Makefile), the tests run in the test directory.
+ *
+ */
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <stddef.h>
+#include <string>
+#include "telemetry.h"
+#include "check.h"
+
+#define RECEIVER_DIR ".."
+#define FRAME_SIZE 56
+#define NUM_VALUES 19               // all fields of the receiver except the magic
+
+static_assert(sizeof(TelemetryFrame) == FRAME_SIZE, "layout of TelemetryFrame changed, update telemetry_receiver.py");
+
+/**
+ * @brief Decode a frame with telemetry_receiver.decode()
+ *
+ * @param data frame
+ * @param size size of the frame
+ * @param values decoded values in the order of the receiver's FIELDS without the magic
+ * @return true if the receiver accepted the frame
+ */
+bool decodeWithReceiver(const uint8_t *data, size_t size, long long *values){
+    std::string hex;
+    char byte[3];
+    for(size_t i = 0; i < size; i++){
+        snprintf(byte, sizeof(byte), "%02x", data[i]);
+        hex += byte;
+    }
+    std::string command = "python3 -c \"import sys; sys.path.insert(0, '" RECEIVER_DIR "'); "
+                          "from telemetry_receiver import decode, FRAME_SIZE; "
+                          "frame = decode(bytes.fromhex(sys.argv[1])); "
+                          "print(FRAME_SIZE, *(v for k, v in frame.items() if k != 'magic') if frame else ['None'])\" " + hex;
+    FILE *pipe = popen(command.c_str(), "r");
+    if(!pipe) return false;
+    char output[512] = "";
+    size_t length = fread(output, 1, sizeof(output) - 1, pipe);
+    output[length] = '\0';
+    pclose(pipe);
+
+    char *position = output;
+    CHECK_EQUAL(strtoll(position, &position, 10), FRAME_SIZE);
+    if(strncmp(position, " None", 5) == 0) return false;
+    for(int i = 0; i < NUM_VALUES; i++){
+        values[i] = strtoll(position, &position, 10);
+    }
+    CHECK_EQUAL(*position, '\n');
+    return true;
+}
+
+// every field with a distinct value, negative values for the signed fields
+TelemetryFrame testFrame(){
+    TelemetryFrame frame;
+    frame.state = 3;
+    frame.uptime = 0xF0000001;
+    frame.freeHeap = 41234;
+    frame.maxFreeBlock = 30567;
+    frame.heapFragmentation = 17;
+    frame.rssi = -71;
+    frame.flags = TELEMETRY_FLAG_NTP_SYNCED | TELEMETRY_FLAG_LED_DIRECT;
+    frame.ntpOffset = -1234;
+    frame.ntpDrift = -56789;
+    frame.ledCurrent = 2345;
+    frame.streamFps = 60;
+    frame.loopCount = 3000000000u;
+    frame.loopAvg = 250;
+    frame.loopP99 = 4095;
+    frame.loopMax = 123456;
+    frame.logDrops = 7;
+    return frame;
+}
+
+void testDecode(){
+    Telemetry telemetry;
+    telemetry.begin(IPAddress(192, 168, 0, 10), IPAddress(230, 120, 10, 2), TELEMETRY_PORT);
+    TelemetryFrame frame = testFrame();
+    telemetry.send(frame);
+    telemetry.send(frame);
+
+    long long values[NUM_VALUES];
+    CHECK(decodeWithReceiver((const uint8_t *)&frame, sizeof(frame), values));
+    long long expected[NUM_VALUES] = {TELEMETRY_VERSION, 3, 1, 0xF0000001, 41234, 30567, 17, -71,
+                                      TELEMETRY_FLAG_NTP_SYNCED | TELEMETRY_FLAG_LED_DIRECT, 0, -1234, -56789, 2345,
+                                      60, 3000000000LL, 250, 4095, 123456, 7};
+    for(int i = 0; i < NUM_VALUES; i++){
+        if(values[i] != expected[i]) printf("field %d: %lld, expected %lld\n", i + 1, values[i], expected[i]);
+        CHECK_EQUAL(values[i], expected[i]);
+    }
+
+    // appended fields of a longer frame are ignored
+    uint8_t longer[FRAME_SIZE + 8] = {0};
+    memcpy(longer, &frame, sizeof(frame));
+    CHECK(decodeWithReceiver(longer, sizeof(longer), values));
+    CHECK_EQUAL(values[NUM_VALUES - 1], 7);
+}
+
+void testRejected(){
+    TelemetryFrame frame = testFrame();
+    long long values[NUM_VALUES];
+    frame.magic[0] = TELEMETRY_MAGIC0;
+    frame.magic[1] = TELEMETRY_MAGIC1;
+    frame.version = TELEMETRY_VERSION + 1;
+    CHECK(!decodeWithReceiver((const uint8_t *)&frame, sizeof(frame), values));
+    frame.version = 0;
+    CHECK(!decodeWithReceiver((const uint8_t *)&frame, sizeof(frame), values));
+    frame.version = TELEMETRY_VERSION;
+    frame.magic[1] = 'X';
+    CHECK(!decodeWithReceiver((const uint8_t *)&frame, sizeof(frame), values));
+    frame.magic[1] = TELEMETRY_MAGIC1;
+    CHECK(!decodeWithReceiver((const uint8_t *)&frame, sizeof(frame) - 1, values));
+    CHECK(decodeWithReceiver((const uint8_t *)&frame, sizeof(frame), values));
+}
+
+int main(){
+    testDecode();
+    testRejected();
+    return checkResult();
+}
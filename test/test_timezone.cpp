@@ -0,0 +1,157 @@
+/**
+ * @file test_timezone.cpp
+ * @brief Test of the timezone handling of the complete sketch: invalid cached rules and expiries are refreshed,
+ * the answer of the IP-API is collected without blocking the loop, failed requests are retried with increasing delay
+ *
+ */
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <EEPROM.h>
+#include "settings.h"
+#include "ntp_client_plus.h"
+#include "udplogger.h"
+#include <vector>
+#include "check.h"
+
+void setup();
+void loop();
+Settings getDefaultSettings();
+bool loadTimezoneFromEEPROM(UDPLogger &logger, NTPClientPlus &ntp);
+bool isTimezoneCacheExpired(NTPClientPlus &ntp);
+bool isTimezoneRequestPending();
+extern SettingsStore settings;
+extern NTPClientPlus ntp;
+extern UDPLogger logger;
+
+static const char *answer = "{\"status\":\"success\",\"lat\":52.52,\"lon\":13.405,\"timezone\":\"Europe/Berlin\",\"offset\":7200}";
+
+static std::vector<unsigned long> apiRequests;      // millis() of the connects to the IP-API
+static bool serverReachable = false;
+static std::shared_ptr<FakeConnection> apiConnection;
+
+// runs the loop for the given time, returns the longest loop cycle in ms (fake time)
+unsigned long runLoop(unsigned long ms){
+    unsigned long start = millis();
+    unsigned long longest = 0;
+    while(millis() - start < ms){
+        unsigned long before = millis();
+        loop();
+        longest = std::max(longest, millis() - before);
+        advanceTime(200);
+    }
+    return longest;
+}
+
+// runs the loop until the next connect to the IP-API (at most the given time), returns the waiting time in ms
+unsigned long runUntilRequest(unsigned long ms){
+    size_t requests = apiRequests.size();
+    unsigned long start = millis();
+    while(millis() - start < ms && apiRequests.size() == requests){
+        loop();
+        advanceTime(200);
+    }
+    return millis() - start;
+}
+
+void sendAnswer(const std::string &data){
+    apiConnection->rx.insert(apiConnection->rx.end(), data.begin(), data.end());
+}
+
+int main(){
+    WiFiClient::onConnect = [](const char *host, uint16_t port) -> std::shared_ptr<FakeConnection> {
+        if(strcmp(host, "ip-api.com") != 0 || port != 80) return nullptr;
+        apiRequests.push_back(millis());
+        if(!serverReachable) return nullptr;
+        apiConnection = std::make_shared<FakeConnection>();
+        return apiConnection;
+    };
+
+    // cache from erased flash: no valid rule and an expiry which is never reached
+    memset(EEPROM.flash, 0xFF, sizeof(EEPROM.flash));
+    {
+        SettingsStore erased;
+        erased.begin(getDefaultSettings());
+        char rule[TZ_RULE_MAX_LEN];
+        memset(rule, 0xFF, sizeof(rule) - 1);
+        rule[sizeof(rule) - 1] = '\0';
+        erased.setTimezoneRule(rule);
+        erased.set(&Settings::tzExpires, 0xFFFFFFFF);
+        erased.commit();
+    }
+    setup();
+    CHECK_EQUAL(settings.get().tzRule[0], '\0');
+    CHECK_EQUAL(settings.get().tzExpires, 0);
+
+    // IP-API not reachable: requested after the time is known, retried after 10, 20, 40 min
+    runLoop(80 * 60000UL);
+    printf("invalid cached rule, API not reachable: %zu request(s) within 80 min\n", apiRequests.size());
+    CHECK_EQUAL(apiRequests.size(), 4);
+    if(apiRequests.size() == 4){
+        CHECK(apiRequests[0] < 60000);
+        CHECK_EQUAL((apiRequests[1] - apiRequests[0]) / 60000, 10);
+        CHECK_EQUAL((apiRequests[2] - apiRequests[1]) / 60000, 20);
+        CHECK_EQUAL((apiRequests[3] - apiRequests[2]) / 60000, 40);
+    }
+
+    // IP-API reachable: the answer arrives in parts, the loop keeps running in the meantime
+    serverReachable = true;
+    runUntilRequest(81 * 60000UL);
+    CHECK_EQUAL(apiRequests.size(), 5);
+    if(apiRequests.size() == 5) CHECK_EQUAL((apiRequests[4] - apiRequests[3]) / 60000, 80);
+    CHECK(apiConnection != nullptr);
+    if(!apiConnection) return checkResult();
+    CHECK(apiConnection->tx.find("GET /json/?fields=status,message,lat,lon,timezone,offset HTTP/1.0\r\n") == 0);
+    CHECK(apiConnection->tx.find("Host: ip-api.com\r\n") != std::string::npos);
+    CHECK(isTimezoneRequestPending());
+    sendAnswer("HTTP/1.0 200 OK\r\nContent-Type: application/json; charset=utf-8\r\n");
+    unsigned long longest = runLoop(1000);
+    sendAnswer("Connection: close\r\n\r\n");
+    sendAnswer(std::string(answer, 32));
+    longest = std::max(longest, runLoop(1000));
+    CHECK(isTimezoneRequestPending());
+    sendAnswer(answer + 32);
+    longest = std::max(longest, runLoop(1000));
+    printf("answer in 3 parts: longest loop cycle %lu ms\n", longest);
+    CHECK(longest <= 10);
+    CHECK(!isTimezoneRequestPending());
+    CHECK(!apiConnection->open);
+    CHECK(strcmp(settings.get().tzRule, "CET-1CEST,M3.5.0,M10.5.0/3") == 0);
+    CHECK(ntp.getEpochTime() + 7UL * 24 * 3600 - settings.get().tzExpires <= 2);
+    CHECK(!isTimezoneCacheExpired(ntp));
+
+    // error answer: retried after 10 min (the retry period is reset after the successful request)
+    settings.set(&Settings::tzExpires, 0);
+    CHECK(runUntilRequest(20000) <= 10000);
+    sendAnswer("HTTP/1.0 503 Service Unavailable\r\n\r\n");
+    runLoop(1000);
+    CHECK(!isTimezoneRequestPending());
+    CHECK_EQUAL((runUntilRequest(60 * 60000UL) + 30000) / 60000, 10);
+
+    // server without answer: failed after the timeout
+    runLoop(1000);
+    CHECK(isTimezoneRequestPending());
+    runLoop(2000);
+    CHECK(!isTimezoneRequestPending());
+    CHECK(isTimezoneCacheExpired(ntp));
+    CHECK_EQUAL((runUntilRequest(60 * 60000UL) + 30000) / 60000, 20);
+    sendAnswer("HTTP/1.0 200 OK\r\n\r\n");
+    sendAnswer(answer);
+    runLoop(1000);
+    CHECK(!isTimezoneCacheExpired(ntp));
+
+    // valid rule with an expiry too far in the future: limited to one week
+    settings.setTimezoneRule("CET-1CEST,M3.5.0,M10.5.0/3");
+    settings.set(&Settings::tzExpires, 0xFFFFFFFF);
+    CHECK(loadTimezoneFromEEPROM(logger, ntp));
+    CHECK(!isTimezoneCacheExpired(ntp));
+    CHECK_EQUAL(settings.get().tzExpires, ntp.getEpochTime() + 7UL * 24 * 3600);
+    CHECK(!isTimezoneCacheExpired(ntp));
+
+    // the limited expiry is reached after one week
+    advanceTime(7ULL * 24 * 3600 * 1000000);
+    ntp.updateNTP();
+    CHECK(isTimezoneCacheExpired(ntp));
+
+    return checkResult();
+}
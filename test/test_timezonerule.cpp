@@ -0,0 +1,98 @@
+/**
+ * @file test_timezonerule.cpp
+ * @brief Test of TimezoneRule for zones of all hemispheres against localtime() of the C library, which evaluates the
+ * same POSIX TZ strings, for every 3 hours and every transition from 1970 to 2100
+ *
+ */
+
+#include <chrono>
+#include <ctime>
+#include <cstdlib>
+#include "timezonerule.h"
+#include "check.h"
+
+#define SECONDS_1900_TO_1970 2208988800LL
+#define STEP_SECONDS (3 * 3600)
+
+static const char *zones[] = {
+    "UTC0",
+    "CET-1CEST,M3.5.0,M10.5.0/3",                   // Central Europe
+    "GMT0BST,M3.5.0/1,M10.5.0",                     // United Kingdom
+    "EET-2EEST,M3.5.0/3,M10.5.0/4",                 // Eastern Europe
+    "EST5EDT,M3.2.0,M11.1.0",                       // US Eastern
+    "PST8PDT,M3.2.0,M11.1.0",                       // US Pacific
+    "MST7",                                         // Arizona
+    "NST3:30NDT,M3.2.0,M11.1.0",                    // Newfoundland
+    "AEST-10AEDT,M10.1.0,M4.1.0/3",                 // Australia Sydney
+    "ACST-9:30ACDT,M10.1.0,M4.1.0/3",               // Australia Adelaide
+    "NZST-12NZDT,M9.5.0,M4.1.0/3",                  // New Zealand
+    "<-04>4<-03>,M9.1.6/24,M4.1.6/24",              // Chile
+    "<-03>3<-02>,M3.5.0/-2,M10.5.0/-1",             // Greenland
+    "IST-5:30",                                     // India
+    "JST-9",                                        // Japan
+    "EST5EDT,J60,J300",                             // julian days without 29. Feb
+    "CET-1CEST,100/1:30,280",                       // zero based days with 29. Feb
+};
+
+// offset and DST of the C library for UTC seconds since 1970
+void libraryOffset(time_t t, int32_t *offset, bool *dst){
+    struct tm local;
+    localtime_r(&t, &local);
+    *offset = local.tm_gmtoff;
+    *dst = local.tm_isdst > 0;
+}
+
+int main(){
+    int64_t first = TimezoneRule::daysFromCivil(1970, 1, 1) * 86400LL;
+    int64_t last = TimezoneRule::daysFromCivil(2100, 12, 31) * 86400LL;
+    for(const char *zone : zones){
+        TimezoneRule rule;
+        CHECK(rule.parse(zone));
+        setenv("TZ", zone, 1);
+        tzset();
+
+        int differences = 0;
+        int transitions = 0;
+        for(int64_t utc = first; utc <= last; utc += STEP_SECONDS){
+            int32_t offset;
+            bool dst;
+            libraryOffset(utc - SECONDS_1900_TO_1970, &offset, &dst);
+            if((rule.getOffset(utc) != offset || rule.isDST(utc) != dst) && differences++ < 3){
+                printf("%s: offset %d at %lld, expected %d\n", zone, rule.getOffset(utc), (long long)utc, offset);
+            }
+        }
+        // each transition changes the offset exactly at the calculated second
+        for(int64_t utc = rule.getNextTransition(first); utc <= last; utc = rule.getNextTransition(utc)){
+            int32_t before, after;
+            bool dstBefore, dstAfter;
+            libraryOffset(utc - 1 - SECONDS_1900_TO_1970, &before, &dstBefore);
+            libraryOffset(utc - SECONDS_1900_TO_1970, &after, &dstAfter);
+            if((before == after || rule.getOffset(utc - 1) != before || rule.getOffset(utc) != after)
+               && differences++ < 3){
+                printf("%s: transition at %lld differs\n", zone, (long long)utc);
+            }
+            transitions++;
+        }
+        printf("%-34s %3d transitions, %d differences\n", zone, transitions, differences);
+        CHECK_EQUAL(differences, 0);
+        CHECK_EQUAL(transitions, strchr(zone, ',') ? 2 * 131 : 0);
+    }
+
+    // invalid strings leave the rule unchanged
+    TimezoneRule rule;
+    CHECK(rule.parse("CET-1CEST,M3.5.0,M10.5.0/3"));
+    CHECK(!rule.parse("CET-1CEST,M3.5.0"));
+    CHECK(!rule.parse("X-1"));
+    CHECK(!rule.parse(""));
+    CHECK_EQUAL(rule.getOffset(TimezoneRule::daysFromCivil(2026, 7, 1) * 86400LL), 7200);
+
+    // the offset of following seconds is only a comparison with the cached interval
+    int64_t start = TimezoneRule::daysFromCivil(2026, 1, 1) * 86400LL;
+    int64_t sum = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for(int64_t utc = start; utc < start + 365 * 86400LL; utc++) sum += rule.getOffset(utc);
+    std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - begin;
+    printf("getOffset(): %.1f ns per second of a year\n", duration.count() / (365 * 86400.0));
+    CHECK(sum > 0);
+    return checkResult();
+}
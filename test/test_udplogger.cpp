@@ -0,0 +1,172 @@
+/**
+ * @file test_udplogger.cpp
+ * @brief Test of the ring buffer of UDPLogger (no blocking, drop counter, compile-time elimination of levels), with a
+ * benchmark of messages per second and heap allocations against the former String API
+ *
+ * The former logString() built each message by String concatenation and waited 5 ms when the last message was sent
+ * less than 5 ms before, it is reproduced here for comparison.
+ *
+ */
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <chrono>
+#include <new>
+#include "udplogger.h"
+#include "check.h"
+
+#define BURST_MESSAGES 200
+#define BENCHMARK_RUNS 20000
+
+// ----------------------------------------------------------------------------------
+//                                        ALLOCATION COUNTER
+// ----------------------------------------------------------------------------------
+
+// the default operator delete of libstdc++ releases with free()
+static uint32_t allocations = 0;
+
+void *operator new(size_t size){
+    allocations++;
+    void *p = malloc(size ? size : 1);
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+
+// ----------------------------------------------------------------------------------
+//                                        FORMER LOGGER
+// ----------------------------------------------------------------------------------
+
+class FormerUDPLogger{
+    public:
+        FormerUDPLogger(IPAddress interfaceAddr, IPAddress multicastAddr, int port){
+            _multicastAddr = multicastAddr;
+            _port = port;
+            _interfaceAddr = interfaceAddr;
+            _name = "Log";
+            _Udp.beginMulticast(_interfaceAddr, _multicastAddr, _port);
+            _lastSend = 0;
+        }
+
+        void logString(const String &logmessage){
+            if(millis() < (_lastSend + 5)){
+                delay(5);
+            }
+            snprintf(_packetBuffer, sizeof(_packetBuffer), "%s: %s", _name.c_str(), logmessage.c_str());
+            Serial.println(_packetBuffer);
+            _Udp.beginPacketMulticast(_multicastAddr, _port, _interfaceAddr);
+            _Udp.write((const uint8_t *)_packetBuffer, strlen(_packetBuffer));
+            _Udp.endPacket();
+            _lastSend = millis();
+        }
+
+    private:
+        String _name;
+        IPAddress _multicastAddr;
+        IPAddress _interfaceAddr;
+        int _port;
+        WiFiUDP _Udp;
+        char _packetBuffer[100];
+        unsigned long _lastSend;
+};
+
+// ----------------------------------------------------------------------------------
+//                                        TESTS
+// ----------------------------------------------------------------------------------
+
+static const IPAddress interfaceAddr(192, 168, 0, 10);
+static const IPAddress multicastAddr(230, 120, 10, 2);
+static const String stateName = "clock";
+
+static int evaluations = 0;
+int countEvaluation(){
+    return ++evaluations;
+}
+
+// messages are queued without blocking, sent one per LOG_SEND_INTERVAL and dropped when the buffer is full
+void testRingBuffer(){
+    UDPLogger logger(interfaceAddr, multicastAddr, 8123);
+    logger.setName("Wordclock");
+    uint32_t sent = WiFiUDP::packetsSent;
+    unsigned long start = millis();
+    int queued = 0;
+    while(logger.getDropped() == 0){
+        LOG_INFO(logger, "Heartbeat, state: %s, FreeHeap: %u, rssi: %d", stateName.c_str(), 40000 + queued, -60);
+        queued++;
+    }
+    CHECK_EQUAL(millis(), start);
+    CHECK_EQUAL(WiFiUDP::packetsSent, sent);
+    printf("%d messages queued in 0 ms, %u dropped\n", queued - 1, logger.getDropped());
+
+    // drained from the loop, one message per LOG_SEND_INTERVAL
+    for(int i = 0; i < queued * LOG_SEND_INTERVAL; i++){
+        logger.handle();
+        advanceTime(1000);
+    }
+    CHECK_EQUAL(WiFiUDP::packetsSent - sent, queued - 1);
+
+    // messages longer than the packet buffer are truncated, not dropped
+    std::string longText(300, 'x');
+    LOG_WARNING(logger, "%s", longText.c_str());
+    CHECK_EQUAL(logger.getDropped(), 1);
+    logger.flush();
+    CHECK_EQUAL(WiFiUDP::packetsSent - sent, queued);
+
+    // messages above LOG_LEVEL are not compiled, their arguments are not evaluated
+    LOG_DEBUG(logger, "not compiled %d", countEvaluation());
+    LOG_INFO(logger, "compiled %d", countEvaluation());
+    CHECK_EQUAL(evaluations, 1);
+}
+
+void testBenchmark(){
+    // burst of messages as after a state change: time the caller is blocked
+    FormerUDPLogger former(interfaceAddr, multicastAddr, 8123);
+    UDPLogger logger(interfaceAddr, multicastAddr, 8123);
+    unsigned long start = millis();
+    for(int i = 0; i < BURST_MESSAGES; i++){
+        former.logString("Heartbeat, state: " + stateName + ", FreeHeap: " + String(40000 + i) + ", rssi: " + String(-60));
+    }
+    unsigned long blockedFormer = millis() - start;
+    start = millis();
+    for(int i = 0; i < BURST_MESSAGES; i++){
+        LOG_INFO(logger, "Heartbeat, state: %s, FreeHeap: %u, rssi: %d", stateName.c_str(), 40000 + i, -60);
+    }
+    unsigned long blockedNew = millis() - start;
+    printf("burst of %d messages blocks the caller: logString() %lu ms, LOG_INFO() %lu ms\n", BURST_MESSAGES,
+           blockedFormer, blockedNew);
+    CHECK(blockedFormer >= (BURST_MESSAGES - 1) * 5);
+    CHECK_EQUAL(blockedNew, 0);
+    logger.flush();
+    uint32_t dropped = logger.getDropped();
+
+    // host cost and heap allocations per message, one message sent per LOG_SEND_INTERVAL
+    allocations = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for(int i = 0; i < BENCHMARK_RUNS; i++){
+        former.logString("Heartbeat, state: " + stateName + ", FreeHeap: " + String(40000 + i) + ", rssi: " + String(-60));
+    }
+    std::chrono::duration<double, std::nano> timeFormer = std::chrono::steady_clock::now() - begin;
+    uint32_t allocationsFormer = allocations;
+
+    allocations = 0;
+    begin = std::chrono::steady_clock::now();
+    for(int i = 0; i < BENCHMARK_RUNS; i++){
+        LOG_INFO(logger, "Heartbeat, state: %s, FreeHeap: %u, rssi: %d", stateName.c_str(), 40000 + i, -60);
+        advanceTime(LOG_SEND_INTERVAL * 1000);
+        logger.handle();
+    }
+    std::chrono::duration<double, std::nano> timeNew = std::chrono::steady_clock::now() - begin;
+    uint32_t allocationsNew = allocations;
+    printf("per message: logString() %.0f ns and %.1f allocations, LOG_INFO() %.0f ns and %.1f allocations "
+           "(%.0f messages/s on the host)\n", timeFormer.count() / BENCHMARK_RUNS,
+           (double)allocationsFormer / BENCHMARK_RUNS, timeNew.count() / BENCHMARK_RUNS,
+           (double)allocationsNew / BENCHMARK_RUNS, BENCHMARK_RUNS / (timeNew.count() / 1e9));
+    CHECK_EQUAL(allocationsNew, 0);
+    CHECK(allocationsFormer > 0);
+    CHECK_EQUAL(logger.getDropped(), dropped);
+}
+
+int main(){
+    testRingBuffer();
+    testBenchmark();
+    return checkResult();
+}
@@ -0,0 +1,271 @@
+/**
+ * @file test_wordtables.cpp
+ * @brief Test of the word tables of all layouts against the former String based rendering for all 1440 minutes
+ *
+ * The reference builds the sentence like the former timeToString() of each layout and searches the words one after
+ * the other in the letters of the front plate, like the former showStringOnClock(). The word tables light the intended
+ * word where a word appears twice on the front plate, so the faces may only differ in the known cases where the
+ * sequential search picked the wrong one. In these cases the table face has to match the reference with this word
+ * at its intended position.
+ *
+ */
+
+#include <bitset>
+#include <string>
+#include "wordclocklayouts.h"
+#include "check.h"
+
+// the javanese front plate has a 12th row of letters
+typedef std::bitset<132> Face;
+
+static const char *letters[NUM_LAYOUTS] = {
+    "ESPISTAFUNFVIERTELZEHNZWANZIGUVORTECHNICNACHHALBMELFUNFXCONTROLLEREINSEAWZWEIDREITUMVIERSECHSQYACHTSIEBENZWOLFZEHNEUNJUHR",
+    "ITPISKTENNPQUARTERHALFTWENTYUFIVEMINUTESNATOPASTMEAONEFTWONTHREELRFOUREAWFIVEOSIXZUSEVENEIGHTELEVENUNINETWELVETENAWOCLOCK",
+    "ILOESTZRTUEDEUXSTTROISQUATRETNEUFUNESEPTHUITSIXDIXKONZECINQDHEURESMIDIRMINUITMOINSAECINQETRQUARTDIXVINGT-CINQEETKDEMIEILI",
+    "SONORLEBORE=R#UNASDUEZTREOTTONOVEDIECIUNDICIDODICISETTEQUATTROCSEICINQUEAMENOECUNOQUARTOVENTICINQUELVETENAWOCLDIECIPMEZZA",
+    "JAMASETENGAHTELOROLASIJIPAPATELUENEMPITUWOLULIMOSEPULOHSONGOOSEWELASPASIKURANGPUNJULLIMOSEPRAPATKATESEPULOHIJURONGPULOHATSELAWEMENIT",
+    "ESPESCHAFUFVIERTUBFZAAZWANZGSIVORABOHWORTUHRHAUBIANESSIEISZWOISDRUVIERIYFUFIOSACHSISEBNIACHTINUNIELZANIERBEUFIZWOUFINAGSI"
+};
+
+// ----------------------------------------------------------------------------------
+//                                        REFERENCE SENTENCES
+// ----------------------------------------------------------------------------------
+
+// minute words of the 5 minute steps :05 ... :55 (index 1 ... 11)
+static const char *germanMinutes[12] = {"", "FUNF NACH ", "ZEHN NACH ", "VIERTEL NACH ", "ZWANZIG NACH ", "FUNF VOR HALB ",
+    "HALB ", "FUNF NACH HALB ", "ZWANZIG VOR ", "VIERTEL VOR ", "ZEHN VOR ", "FUNF VOR "};
+static const char *germanHours[12] = {"ZWOLF ", "EIN", "ZWEI ", "DREI ", "VIER ", "FUNF ", "SECHS ", "SIEBEN ", "ACHT ",
+    "NEUN ", "ZEHN ", "ELF "};
+
+std::string germanSentence(int hours, int minutes){
+    std::string message = std::string("ES IST ") + germanMinutes[minutes / 5];
+    hours = (hours % 12 + (minutes >= 25)) % 12;
+    message += germanHours[hours];
+    if(hours == 1) message += minutes > 4 ? "S " : " ";
+    if(minutes < 5) message += "UHR ";
+    return message;
+}
+
+static const char *englishMinutes[12] = {"", "FIVE MINUTES ", "TEN MINUTES ", "QUARTER ", "TWENTY MINUTES ",
+    "TWENTY FIVE MINUTES ", "HALF ", "TWENTY FIVE MINUTES ", "TWENTY MINUTES ", "QUARTER ", "TEN MINUTES ", "FIVE MINUTES "};
+static const char *englishHours[13] = {"", "ONE ", "TWO ", "THREE ", "FOUR ", "FIVE ", "SIX ", "SEVEN ", "EIGHT ", "NINE ",
+    "TEN ", "ELEVEN ", "TWELVE "};
+
+std::string englishSentence(int hours, int minutes){
+    std::string message = std::string("IT IS ") + englishMinutes[minutes / 5];
+    hours %= 12;
+    if(minutes >= 35){
+        hours = (hours + 1) % 12;
+        message += "TO ";
+    }
+    else if(minutes >= 5){
+        message += "PAST ";
+    }
+    message += englishHours[hours == 0 ? 12 : hours];
+    if(minutes < 5) message += "OCLOCK ";
+    return message;
+}
+
+static const char *frenchNumbers[13] = {"", "UNE", "DEUX", "TROIS", "QUATRE", "CINQ", "SIX", "SEPT", "HUIT", "NEUF", "DIX",
+    "ONZE", "DOUZE"};
+static const char *frenchMinutes[12] = {"", " CINQ", " DIX", " ET QUART", " VINGT", " VINGT-CINQ", " ET DEMI",
+    " MOINS VINGT-CINQ", " MOINS VINGT", " MOINS QUART", " MOINS DIX", " MOINS CINQ"};
+
+std::string frenchSentence(int hours, int minutes){
+    minutes = minutes / 5 * 5;
+    std::string message = "IL EST ";
+    if(minutes >= 35) hours++;
+    if((hours == 0 && minutes <= 30) || (hours == 24 && minutes >= 35)){
+        message += "MINUIT";
+    }
+    else if(hours == 12){
+        message += "MIDI";
+    }
+    else{
+        int hours12h = hours > 12 ? hours - 12 : hours;
+        message += std::string(frenchNumbers[hours12h]) + " HEURE" + (hours12h > 1 ? "S" : "");
+    }
+    message += frenchMinutes[minutes / 5];
+    if(minutes == 30 && !(hours == 0 || hours == 12 || hours == 13)) message += "E";
+    return message;
+}
+
+static const char *italianHours[12] = {"DODICI ", "UNA ", "DUE ", "TRE ", "QUATTRO ", "CINQUE ", "SEI ", "SETTE ", "OTTO ",
+    "NOVE ", "DIECI ", "UNDICI "};
+static const char *italianMinutes[12] = {"", "E CINQUE ", "E DIECI ", "E UN QUARTO ", "E VENTI ", "E VENTICINQUE ",
+    "E MEZZA ", "MENO VENTICINQUE ", "MENO VENTI ", "MENO UN QUARTO ", "MENO DIECI ", "MENO CINQUE "};
+
+std::string italianSentence(int hours, int minutes){
+    hours = (hours % 12 + (minutes >= 35)) % 12;
+    std::string message = hours == 1 ? "= # " : "SONO LE ";
+    return message + italianHours[hours] + italianMinutes[minutes / 5];
+}
+
+static const char *javaneseHours[13] = {"", "SIJI ", "LORO ", "TELU ", "PAPAT ", "LIMO ", "ENEM ", "PITU ", "WOLU ", "SONGO ",
+    "SEPULOH ", "SEWELAS ", "ROLAS "};
+static const char *javaneseMinutes[12] = {"", "LIMO MENIT ", "SEPULOH MENIT ", "SEPRAPAT MENIT", "RONGPULOH MENIT ",
+    "SELAWE MENIT ", "", "SELAWE MENIT ", "RONGPULOH MENIT ", "SEPRAPAT MENIT ", "SEPULOH MENIT ", "LIMO MENIT "};
+
+std::string javaneseSentence(int hours, int minutes){
+    std::string message = "JAM ";
+    hours %= 12;
+    if(minutes >= 30) hours = (hours + 1) % 12;
+    if(minutes >= 30 && minutes < 35) message += "SETENGAH ";
+    message += javaneseHours[hours == 0 ? 12 : hours];
+    if(minutes >= 35) message += "KURANG ";
+    else if(minutes >= 5 && minutes < 30) message += "PUNJUL ";
+    message += javaneseMinutes[minutes / 5];
+    if(minutes < 5 || (minutes >= 30 && minutes < 35)) message += "PAS ";
+    return message;
+}
+
+static const char *swissMinutes[12] = {"", "FUF AB ", "ZAA AB ", "VIERTU AB ", "ZWANZG AB ", "FUF VOR HAUBI ", "HAUBI ",
+    "FUF AB HAUBI ", "ZWANZG VOR ", "VIERTU VOR ", "ZAA VOR ", "FUF VOR "};
+static const char *swissHours[12] = {"ZWOUFI ", "EIS ", "ZWOI ", "DRU ", "VIERI ", "FUFI ", "SACHSI ", "SEBNI ", "ACHTI ",
+    "NUNI ", "ZANI ", "EUFI "};
+
+std::string swissSentence(int hours, int minutes){
+    std::string message = std::string("ES ESCH ") + swissMinutes[minutes / 5];
+    message += swissHours[(hours % 12 + (minutes >= 25)) % 12];
+    if(minutes < 5) message += "GSI ";
+    return message;
+}
+
+std::string sentence(int layout, int hours, int minutes){
+    switch(layout){
+        case lt_german: return germanSentence(hours, minutes);
+        case lt_english: return englishSentence(hours, minutes);
+        case lt_french: return frenchSentence(hours, minutes);
+        case lt_italian: return italianSentence(hours, minutes);
+        case lt_javanese: return javaneseSentence(hours, minutes);
+        default: return swissSentence(hours, minutes);
+    }
+}
+
+// ----------------------------------------------------------------------------------
+//                                        FACES
+// ----------------------------------------------------------------------------------
+
+// word of a sentence which is placed at a fixed position of the front plate instead of searching it
+struct Relocation {
+    std::string word;
+    size_t occurrence;              // index of the word in the sentence
+    size_t position;                // intended position on the front plate
+};
+
+// former showStringOnClock(): each word is searched after the end of the previous one, the search ends at the
+// first empty word (two spaces) or at a word which is not found
+Face referenceFace(int layout, const std::string &message, const Relocation *relocation = NULL){
+    Face face;
+    std::string text = message + " ";
+    std::string plate = letters[layout];
+    size_t lastLetter = 0;
+    size_t start = 0;
+    for(size_t end, index = 0; (end = text.find(' ', start)) != std::string::npos && end > start; start = end + 1, index++){
+        std::string word = text.substr(start, end - start);
+        size_t position = plate.find(word, lastLetter);
+        if(relocation && index == relocation->occurrence) position = relocation->position;
+        if(position == std::string::npos) break;
+        for(size_t i = 0; i < word.size(); i++) face.set(position + i);
+        lastLetter = position + word.size();
+    }
+    return face;
+}
+
+Face tableFace(int layout, int hours, int minutes){
+    Face face;
+    uint8_t words[MAX_WORDS_PER_TIME];
+    uint8_t numWords = layoutTimeToWords(layout, hours, minutes, words);
+    for(uint8_t i = 0; i < numWords; i++){
+        WordPosition position = getWordPosition(layout, words[i]);
+        for(uint8_t k = 0; k < position.length; k++) face.set(position.start + k);
+    }
+    return face;
+}
+
+// index of the last instance of a word in a sentence
+size_t lastWordIndex(const std::string &message, const std::string &word){
+    std::string text = message + " ";
+    size_t last = std::string::npos;
+    size_t index = 0;
+    for(size_t start = 0, end; (end = text.find(' ', start)) != std::string::npos && end > start; start = end + 1, index++){
+        if(text.compare(start, end - start, word) == 0) last = index;
+    }
+    return last;
+}
+
+// cases in which the sequential search of the former rendering lit a wrong instance of a word: the word and its
+// intended position, false if the layout and time are not affected
+bool getKnownRelocation(int layout, int hours, int minutes, const std::string &message, Relocation &relocation){
+    std::string plate = letters[layout];
+    switch(layout){
+        case lt_german: {
+            // VIER of VIERTEL and the minute words FUNF and ZEHN instead of the hours 4, 5 and 10 (last instances)
+            int hour = (hours % 12 + (minutes >= 25)) % 12;
+            if(hour != 4 && hour != 5 && hour != 10) return false;
+            relocation.word = hour == 4 ? "VIER" : hour == 5 ? "FUNF" : "ZEHN";
+            relocation.position = plate.rfind(relocation.word);
+            break;
+        }
+        case lt_english: {
+            // minute words FIVE and TEN instead of the hours 5 and 10 (last instances)
+            int hour = (hours % 12 + (minutes >= 35)) % 12;
+            if(hour != 5 && hour != 10) return false;
+            relocation.word = hour == 5 ? "FIVE" : "TEN";
+            relocation.position = plate.rfind(relocation.word);
+            break;
+        }
+        case lt_french:
+            // ET of ET QUART instead of the one in front of DEMIE
+            if(minutes / 5 != 6) return false;
+            relocation.word = "ET";
+            relocation.position = plate.rfind("ET", plate.find("DEMIE"));
+            break;
+        case lt_italian:
+            // E of the minutes inside of the hour words instead of the single E behind MENO
+            if(minutes < 5 || minutes >= 35) return false;
+            relocation.word = "E";
+            relocation.position = plate.find("E", plate.find("MENO") + 4);
+            break;
+        default:
+            return false;
+    }
+    relocation.occurrence = lastWordIndex(message, relocation.word);
+    return relocation.occurrence != std::string::npos;
+}
+
+int main(){
+    for(int layout = 0; layout < NUM_LAYOUTS; layout++){
+        CHECK(isLayoutAvailable(layout));
+        CHECK(strlen(letters[layout]) >= 121);
+        int identical = 0;
+        int known = 0;
+        int unexpected = 0;
+        for(int minute = 0; minute < 24 * 60; minute++){
+            int hours = minute / 60;
+            int minutes = minute % 60;
+            std::string message = sentence(layout, hours, minutes);
+            Face reference = referenceFace(layout, message);
+            Face table = tableFace(layout, hours, minutes);
+            if(table == reference){
+                identical++;
+                continue;
+            }
+            // only the position of one word differs: exactly the reference face with the word at its intended position
+            Relocation relocation;
+            if(getKnownRelocation(layout, hours, minutes, message, relocation)
+               && table == referenceFace(layout, message, &relocation)){
+                known++;
+                continue;
+            }
+            if(unexpected++ < 3){
+                printf("%s %02d:%02d \"%s\": faces differ\n", getLayoutName(layout), hours, minutes, message.c_str());
+            }
+        }
+        printf("%-9s %4d identical, %3d fixed word positions, %d unexpected\n", getLayoutName(layout), identical, known,
+               unexpected);
+        CHECK_EQUAL(unexpected, 0);
+        if(layout == lt_swiss || layout == lt_javanese) CHECK_EQUAL(identical, 24 * 60);
+    }
+    return checkResult();
+}
@@ -19,7 +19,7 @@ Tetris::Tetris(){
  * @brief Construct a new Tetris:: Tetris object
  * 
  * @param myledmatrix pointer to LEDMatrix object, need to provide gridAddPixel(x, y, col), drawOnMatrix(), gridFlush() and printNumber(x,y,n,col)
- * @param mylogger pointer to UDPLogger object, need to provide a function logString(message)
+ * @param mylogger pointer to UDPLogger object
  */
 Tetris::Tetris(LEDMatrix *myledmatrix, UDPLogger *mylogger){
     _logger = mylogger;
@@ -75,7 +75,7 @@ void Tetris::loopCycle(){
             // at game end show all bricks on field in red color for 1.5 seconds, then show score
             if (_tetrisGameOver == true) {
                 _tetrisGameOver = false;
-                (*_logger).logString("Tetris: end");
+                LOG_INFO(*_logger, "Tetris: end");
                 everythingRed();
                 _tetrisshowscoreTime = millis();
             }
@@ -111,12 +111,12 @@ void Tetris::ctrlPlayPause() {
     {
         _lastButtonClick = millis();
         if (_gameStatet == GAME_STATE_PAUSEDt) {
-            (*_logger).logString("Tetris: continue");
+            LOG_INFO(*_logger, "Tetris: continue");
 
             _gameStatet = GAME_STATE_RUNNINGt;
 
         } else if (_gameStatet == GAME_STATE_RUNNINGt) {
-            (*_logger).logString("Tetris: pause");
+            LOG_INFO(*_logger, "Tetris: pause");
 
             _gameStatet = GAME_STATE_PAUSEDt;
         }
@@ -182,7 +182,7 @@ void Tetris::ctrlDown() {
  */
 void Tetris::setSpeed(uint8_t i) {
     if(i > 15) i = 15;
-    (*_logger).logString("setSpeed: " + String(i));
+    LOG_INFO(*_logger, "setSpeed: %u", i);
     _speedtetris = -10 * i + 150;
 }
 
@@ -201,7 +201,7 @@ void Tetris::resetLEDs()
  * 
  */
 void Tetris::tetrisInit() {
-    (*_logger).logString("Tetris: init");
+    LOG_INFO(*_logger, "Tetris: init");
     
     clearField();
     _brickSpeed = INIT_SPEED;
@@ -393,7 +393,7 @@ void Tetris::rotateActiveBrick() {
         tmpBrick.pix[3][2] = _activeBrick.pix[2][0];
         tmpBrick.pix[3][3] = _activeBrick.pix[3][0];
     } else {
-        (*_logger).logString("Tetris: Brick size error");
+        LOG_ERROR(*_logger, "Tetris: Brick size error");
     }
 
     // Now validate by checking collision.
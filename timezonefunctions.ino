@@ -1,99 +1,369 @@
-#include <ESP8266HTTPClient.h>
+
+#include <ESP8266WiFi.h>
 #include "ntp_client_plus.h"
 #include "udplogger.h"
+#include "jsonscanner.h"
+
+#define TZ_CACHE_TTL (7UL * 24 * 3600)      // validity of the cached timezone in seconds (one week)
+#define TZ_CACHE_TTL_FIXED (24UL * 3600)    // validity of a cached fixed UTC offset (unknown DST rule) in seconds
+#define TIMEOUT_TIMEZONE_API 2000           // max. time in ms without data from the IP-API
+#define TIMEOUT_TIMEZONE_CONNECT 1000       // max. time in ms of the DNS lookup and of the TCP connect (each)
+#define TZ_API_HOST "ip-api.com"
+// see API documentation on https://ip-api.com/docs/api:json to see which fields are available
+#define TZ_API_PATH "/json/?fields=status,message,lat,lon,timezone,offset"
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_MOVED_PERMANENTLY 301
+#define TZ_NAME_MAX_LEN 40                  // max. length of IANA timezone name incl. terminating zero
 
 int api_offset = 0;
-String api_timezone = "";
+char api_timezone[TZ_NAME_MAX_LEN] = "";
 float api_lat = 0.0;
 float api_lon = 0.0;
 
+// parts of the answer of the IP-API
+enum TimezoneRequestState {
+  TZ_STATE_IDLE,      // no request running
+  TZ_STATE_STATUS,    // waiting for the status line
+  TZ_STATE_HEADER,    // skipping the header up to the empty line
+  TZ_STATE_BODY       // scanning the JSON body
+};
+
+// results of feedTimezoneAnswer()
+#define TZ_ANSWER_FAILED -1
+#define TZ_ANSWER_OK 0
+#define TZ_ANSWER_PENDING 1
+
+WiFiClient tzClient;
+TimezoneRequestState tzState = TZ_STATE_IDLE;
+unsigned long tzLastData = 0;     // millis() of the last received character
+int tzHttpCode = 0;
+uint8_t tzSpaces = 0;             // spaces in the status line so far
+bool tzEmptyLine = false;         // current header line is empty so far
+
+char tzStatus[12];
+char tzMessage[40];
+char tzOffset[12];
+char tzLat[16];
+char tzLon[16];
+JsonField tzFields[] = {
+  {"status", tzStatus, sizeof(tzStatus)},
+  {"message", tzMessage, sizeof(tzMessage)},
+  {"timezone", api_timezone, sizeof(api_timezone)},
+  {"offset", tzOffset, sizeof(tzOffset)},
+  {"lat", tzLat, sizeof(tzLat)},
+  {"lon", tzLon, sizeof(tzLon)}
+};
+JsonScanner tzScanner(tzFields, sizeof(tzFields) / sizeof(tzFields[0]));
+
+// POSIX TZ rules of common timezones (IANA name, rule), as pairs of zero terminated strings, end of table = empty name.
+// Timezones not listed here are used with the fixed UTC offset reported by the API.
+const char timezoneRules[] PROGMEM =
+  "Europe/Berlin\0"       "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Vienna\0"       "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Zurich\0"       "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Busingen\0"     "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Vaduz\0"        "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Luxembourg\0"   "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Paris\0"        "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Brussels\0"     "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Amsterdam\0"    "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Rome\0"         "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Madrid\0"       "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Copenhagen\0"   "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Oslo\0"         "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Stockholm\0"    "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Warsaw\0"       "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Prague\0"       "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/Budapest\0"     "CET-1CEST,M3.5.0,M10.5.0/3\0"
+  "Europe/London\0"       "GMT0BST,M3.5.0/1,M10.5.0\0"
+  "Europe/Dublin\0"       "IST-1GMT0,M10.5.0,M3.5.0/1\0"
+  "Europe/Lisbon\0"       "WET0WEST,M3.5.0/1,M10.5.0\0"
+  "Europe/Helsinki\0"     "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+  "Europe/Athens\0"       "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+  "Europe/Bucharest\0"    "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+  "Europe/Kyiv\0"         "EET-2EEST,M3.5.0/3,M10.5.0/4\0"
+  "America/New_York\0"    "EST5EDT,M3.2.0,M11.1.0\0"
+  "America/Chicago\0"     "CST6CDT,M3.2.0,M11.1.0\0"
+  "America/Denver\0"      "MST7MDT,M3.2.0,M11.1.0\0"
+  "America/Phoenix\0"     "MST7\0"
+  "America/Los_Angeles\0" "PST8PDT,M3.2.0,M11.1.0\0"
+  "America/Anchorage\0"   "AKST9AKDT,M3.2.0,M11.1.0\0"
+  "America/Toronto\0"     "EST5EDT,M3.2.0,M11.1.0\0"
+  "America/Vancouver\0"   "PST8PDT,M3.2.0,M11.1.0\0"
+  "Pacific/Honolulu\0"    "HST10\0"
+  "Australia/Sydney\0"    "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+  "Australia/Melbourne\0" "AEST-10AEDT,M10.1.0,M4.1.0/3\0"
+  "Australia/Brisbane\0"  "AEST-10\0"
+  "Australia/Adelaide\0"  "ACST-9:30ACDT,M10.1.0,M4.1.0/3\0"
+  "Australia/Perth\0"     "AWST-8\0"
+  "Pacific/Auckland\0"    "NZST-12NZDT,M9.5.0,M4.1.0/3\0"
+  "Asia/Jakarta\0"        "WIB-7\0"
+  "\0";
+
 /**
- * @brief Request the timezone and other data from the IP-API
- * 
+ * @brief Send the request for the timezone and other data to the IP-API, the answer is collected by
+ * pollTimezoneRequest() without blocking
+ *
+ * Only the DNS lookup and the TCP connect block, each at most TIMEOUT_TIMEZONE_CONNECT ms.
+ *
  * @param logger UDPLogger object to log messages
- * @return bool true if the api request was successful
+ * @return true if the request was sent
  */
-bool requestAPIData(UDPLogger &logger) {
-  WiFiClient client;
-  HTTPClient http;
-  bool res = false;
-  logger.logString("[HTTP] Requesting timezone from IP-API");
-  // see API documentation on https://ip-api.com/docs/api:json to see which fields are available
-  if (http.begin(client, "http://ip-api.com/json/?fields=status,message,country,countryCode,region,regionName,city,zip,lat,lon,timezone,offset,query")) { 
-    int httpCode = http.GET();
-
-    if (httpCode > 0) { 
-      if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_MOVED_PERMANENTLY) {
-        String payload = http.getString();
-
-        api_timezone = getJsonParameterValue(payload, "timezone", true);
-        logger.logString("[HTTP] Received timezone: " + api_timezone);
-
-        String offsetString = getJsonParameterValue(payload, "offset", false);
-        api_offset = offsetString.toInt() / 60;
-        logger.logString("[HTTP] Received offset (min): " + String(api_offset));
-
-        String latString = getJsonParameterValue(payload, "lat", false);
-        api_lat = latString.toFloat();
-        logger.logString("[HTTP] Received latitude: " + String(api_lat));
-
-        String lonString = getJsonParameterValue(payload, "lon", false);
-        api_lon = lonString.toFloat();
-        logger.logString("[HTTP] Received longitude: " + String(api_lon));
+bool beginTimezoneRequest(UDPLogger &logger) {
+  if (tzState != TZ_STATE_IDLE) {
+    return false;
+  }
+  LOG_INFO(logger, "[HTTP] Requesting timezone from IP-API");
+  IPAddress ip;
+  if (!WiFi.hostByName(TZ_API_HOST, ip, TIMEOUT_TIMEZONE_CONNECT)) {
+    LOG_WARNING(logger, "[HTTP] Unable to resolve %s", TZ_API_HOST);
+    return false;
+  }
+  // the stream timeout limits the connect
+  tzClient.setTimeout(TIMEOUT_TIMEZONE_CONNECT);
+  if (!tzClient.connect(ip, 80)) {
+    LOG_WARNING(logger, "[HTTP] Unable to connect");
+    return false;
+  }
+  // HTTP/1.0 to get the body without chunked transfer encoding, so it can be scanned directly from the stream
+  tzClient.print(F("GET " TZ_API_PATH " HTTP/1.0\r\nHost: " TZ_API_HOST "\r\nConnection: close\r\n\r\n"));
+  tzHttpCode = 0;
+  tzSpaces = 0;
+  tzScanner.reset();
+  tzState = TZ_STATE_STATUS;
+  tzLastData = millis();
+  return true;
+}
 
-      }
-    } 
+/**
+ * @brief Check if a request to the IP-API is waiting for the answer
+ *
+ * @return true if a request is pending
+ */
+bool isTimezoneRequestPending() {
+  return tzState != TZ_STATE_IDLE;
+}
+
+/**
+ * @brief Process the received part of the answer of the IP-API (non-blocking) and apply the timezone
+ * when the answer is complete
+ *
+ * @param logger UDPLogger object to log messages
+ * @param ntp NTPClientPlus object to set the timezone
+ * @return true if the request finished (successfully or not), the cache is not expired after a successful request
+ */
+bool pollTimezoneRequest(UDPLogger &logger, NTPClientPlus &ntp) {
+  if (tzState == TZ_STATE_IDLE) {
+    return false;
+  }
+
+  int result = TZ_ANSWER_PENDING;
+  while (result == TZ_ANSWER_PENDING && tzClient.available() > 0) {
+    result = feedTimezoneAnswer(logger, tzClient.read());
+    tzLastData = millis();
+  }
+  if (result == TZ_ANSWER_PENDING) {
+    if (!tzClient.connected()) {
+      LOG_WARNING(logger, "[HTTP] Invalid or incomplete answer");
+      result = TZ_ANSWER_FAILED;
+    }
+    else if (millis() - tzLastData > TIMEOUT_TIMEZONE_API) {
+      LOG_WARNING(logger, "[HTTP] Timeout");
+      result = TZ_ANSWER_FAILED;
+    }
     else {
-      Serial.printf("[HTTP] GET... failed, error: %s\n", http.errorToString(httpCode).c_str());
-      res = false;
+      return false;
     }
-    http.end(); // Close connection
   }
-  else {
-    logger.logString("[HTTP] Unable to connect");
-    res = false;
+
+  tzClient.stop();
+  tzState = TZ_STATE_IDLE;
+  if (result == TZ_ANSWER_OK) {
+    updateTimezoneFromAPI(logger, ntp);
   }
-  return res;
+  return true;
 }
 
 /**
- * @brief Get the Json Parameter Value object
- * 
- * @param json 
- * @param parameter 
- * @return String 
+ * @brief (private) Process the next character of the answer of the IP-API (status line, header and JSON body)
+ *
+ * @param logger UDPLogger object to log messages
+ * @param c character
+ * @return int TZ_ANSWER_PENDING until the answer is complete, then TZ_ANSWER_OK or TZ_ANSWER_FAILED
  */
-String getJsonParameterValue(String json, String parameter, bool isString) {
-  String value = "";
-  if(isString) {
-    int index = json.indexOf("\"" + parameter + "\":\"");
-    if (index != -1) {
-      int start = index + parameter.length() + 4; 
-      int end = json.indexOf("\"", start);
-      value = json.substring(start, end);
-    }
+int feedTimezoneAnswer(UDPLogger &logger, char c) {
+  switch (tzState) {
+    case TZ_STATE_STATUS:
+      // "HTTP/1.0 200 OK"
+      if (c == '\n') {
+        tzEmptyLine = true;
+        tzState = TZ_STATE_HEADER;
+      }
+      else if (c == ' ') {
+        tzSpaces++;
+      }
+      else if (tzSpaces == 1 && isdigit((unsigned char)c)) {
+        tzHttpCode = tzHttpCode * 10 + (c - '0');
+      }
+      break;
+
+    case TZ_STATE_HEADER:
+      if (c == '\n') {
+        if (tzEmptyLine) {
+          if (tzHttpCode != HTTP_CODE_OK && tzHttpCode != HTTP_CODE_MOVED_PERMANENTLY) {
+            LOG_WARNING(logger, "[HTTP] GET failed, code: %d", tzHttpCode);
+            return TZ_ANSWER_FAILED;
+          }
+          tzState = TZ_STATE_BODY;
+        }
+        tzEmptyLine = true;
+      }
+      else if (c != '\r') {
+        tzEmptyLine = false;
+      }
+      break;
+
+    case TZ_STATE_BODY:
+      if (!tzScanner.feed(c)) {
+        LOG_WARNING(logger, "[HTTP] Invalid or incomplete answer");
+        return TZ_ANSWER_FAILED;
+      }
+      if (tzScanner.isDone()) {
+        return evaluateTimezoneAnswer(logger);
+      }
+      break;
+
+    default:
+      break;
+  }
+  return TZ_ANSWER_PENDING;
+}
+
+/**
+ * @brief (private) Take over the fields of a complete answer of the IP-API
+ *
+ * @param logger UDPLogger object to log messages
+ * @return int TZ_ANSWER_OK if the API reported success and the timezone
+ */
+int evaluateTimezoneAnswer(UDPLogger &logger) {
+  if (strcmp(tzStatus, "success") != 0 || !tzFields[2].found || !tzFields[3].found) {
+    LOG_WARNING(logger, "[HTTP] API error: %s", tzMessage);
+    return TZ_ANSWER_FAILED;
   }
-  else {
-    int index = json.indexOf("\"" + parameter + "\":");
-    if (index != -1) {
-      int start = index + parameter.length() + 3; 
-      int end = json.indexOf(",", start);
-      value = json.substring(start, end);
+  LOG_INFO(logger, "[HTTP] Received timezone: %s", api_timezone);
+
+  api_offset = atol(tzOffset) / 60;
+  LOG_INFO(logger, "[HTTP] Received offset (min): %d", api_offset);
+
+  api_lat = atof(tzLat);
+  LOG_INFO(logger, "[HTTP] Received latitude: %.2f", api_lat);
+
+  api_lon = atof(tzLon);
+  LOG_INFO(logger, "[HTTP] Received longitude: %.2f", api_lon);
+  return TZ_ANSWER_OK;
+}
+
+/**
+ * @brief Look up the POSIX TZ rule of an IANA timezone name (e.g. "Europe/Berlin")
+ *
+ * @param name IANA timezone name
+ * @param rule buffer for the rule (TZ_RULE_MAX_LEN bytes)
+ * @return true if the timezone was found in the table
+ */
+bool findTimezoneRule(const char *name, char *rule) {
+  const char *entry = timezoneRules;
+  while (pgm_read_byte(entry) != '\0') {
+    const char *entryRule = entry + strlen_P(entry) + 1;
+    if (strcmp_P(name, entry) == 0) {
+      strncpy_P(rule, entryRule, TZ_RULE_MAX_LEN - 1);
+      rule[TZ_RULE_MAX_LEN - 1] = '\0';
+      return true;
     }
+    entry = entryRule + strlen_P(entryRule) + 1;
+  }
+  return false;
+}
+
+/**
+ * @brief Load the cached timezone from EEPROM and apply it to the NTP client (no network access,
+ * the cached timezone is used even if expired, until it is refreshed)
+ *
+ * A cached rule which is not accepted by the NTP client (e.g. erased flash) is cleared, so it is
+ * treated as expired and requested again.
+ *
+ * @param logger UDPLogger object to log messages
+ * @param ntp NTPClientPlus object to set the timezone
+ * @return true if a valid timezone was cached
+ */
+bool loadTimezoneFromEEPROM(UDPLogger &logger, NTPClientPlus &ntp) {
+  const char *rule = settings.get().tzRule;
+  if (rule[0] == '\0') {
+    LOG_INFO(logger, "Timezone: no cached timezone, using default");
+    return false;
   }
-  return value;
+  if (!ntp.setTimezone(rule)) {
+    LOG_WARNING(logger, "Timezone: invalid cached timezone, using default");
+    settings.setTimezoneRule("");
+    settings.set(&Settings::tzExpires, 0);
+    return false;
+  }
+  LOG_INFO(logger, "Timezone (cached): %s", rule);
+  return true;
 }
 
 /**
- * @brief Update the UTC offset from the timezone string obtained from the IP-API
- * 
+ * @brief Check if the cached timezone needs to be refreshed (requires a valid time)
+ *
+ * An expiry further in the future than TZ_CACHE_TTL can not have been written by updateTimezoneFromAPI()
+ * (e.g. erased flash or a wrong time when it was saved), it is limited to now + TZ_CACHE_TTL.
+ *
+ * @param ntp NTPClientPlus object to get the current time
+ * @return true if the cache is expired or empty
+ */
+bool isTimezoneCacheExpired(NTPClientPlus &ntp) {
+  uint32_t now = ntp.getEpochTime();
+  if (settings.get().tzRule[0] == '\0' || now >= settings.get().tzExpires) {
+    return true;
+  }
+  if (settings.get().tzExpires - now > TZ_CACHE_TTL) {
+    settings.set(&Settings::tzExpires, now + TZ_CACHE_TTL);
+  }
+  return false;
+}
+
+/**
+ * @brief Apply the timezone of a successful answer of the IP-API to the NTP client and save it in the EEPROM cache
+ *
+ * If the timezone is not known, the fixed UTC offset of the API is used and expires earlier,
+ * as it does not follow daylight saving time changes.
+ *
  * @param logger UDPLogger object to log messages
- * @param ntp NTPClientPlus object to set the UTC offset
- * @return int 
+ * @param ntp NTPClientPlus object to set the timezone
+ * @return true if the timezone was updated
  */
-void updateUTCOffsetFromTimezoneAPI(UDPLogger &logger, NTPClientPlus &ntp) {
-  bool res = requestAPIData(logger);
-  if (res) {
-    ntp.setUTCOffset(api_offset);      
+bool updateTimezoneFromAPI(UDPLogger &logger, NTPClientPlus &ntp) {
+  char rule[TZ_RULE_MAX_LEN];
+  uint32_t ttl = TZ_CACHE_TTL;
+  if (!findTimezoneRule(api_timezone, rule)) {
+    // POSIX offsets are west of UTC, e.g. UTC+01:30 -> "<+0130>-1:30"
+    int offset = abs(api_offset);
+    snprintf(rule, TZ_RULE_MAX_LEN, "<%c%02d%02d>%c%d:%02d", api_offset < 0 ? '-' : '+', offset / 60, offset % 60,
+              api_offset < 0 ? '+' : '-', offset / 60, offset % 60);
+    ttl = TZ_CACHE_TTL_FIXED;
+  }
+
+  if (!ntp.setTimezone(rule)) {
+    LOG_WARNING(logger, "Timezone: invalid rule %s", rule);
+    return false;
+  }
+  ntp.calcDate();
+  LOG_INFO(logger, "Timezone: %s", rule);
+
+  bool changed = strcmp(settings.get().tzRule, rule) != 0;
+  settings.setTimezoneRule(rule);
+  settings.set(&Settings::tzExpires, (uint32_t)(ntp.getEpochTime() + ttl));
+  if (changed) {
+    LOG_INFO(logger, "Timezone changed, saved to EEPROM");
   }
-}
\ No newline at end of file
+  return true;
+}
@@ -0,0 +1,431 @@
+#include "timezonerule.h"
+
+/**
+ * @brief Construct a new TimezoneRule object (UTC without DST)
+ *
+ */
+TimezoneRule::TimezoneRule()
+{
+    this->parse("UTC0");
+}
+
+/**
+ * @brief Set the rule from a POSIX TZ string, e.g. "CET-1CEST,M3.5.0,M10.5.0/3"
+ *
+ * Format: std offset [dst [offset] [,start[/time],end[/time]]]
+ * The offset is given west of UTC (CET-1 = UTC+1). If DST has no rule, the US rule is used.
+ *
+ * @param posixTZ POSIX TZ string
+ * @return true if the string was valid (otherwise the rule is not changed)
+ */
+bool TimezoneRule::parse(const char *posixTZ)
+{
+    const char *p = posixTZ;
+    int32_t stdOffset;
+    int32_t dstOffset;
+    TransitionRule start = {'M', 3, 2, 0, 0, TZ_DEFAULT_TRANSITION_TIME};
+    TransitionRule end = {'M', 11, 1, 0, 0, TZ_DEFAULT_TRANSITION_TIME};
+    bool hasDST = false;
+
+    if (!parseName(&p) || !parseTime(&p, &stdOffset))
+    {
+        return false;
+    }
+    stdOffset = -stdOffset;
+    dstOffset = stdOffset + 3600;
+
+    if (*p != '\0')
+    {
+        hasDST = true;
+        if (!parseName(&p))
+        {
+            return false;
+        }
+        if (*p != ',' && *p != '\0')
+        {
+            if (!parseTime(&p, &dstOffset))
+            {
+                return false;
+            }
+            dstOffset = -dstOffset;
+        }
+        if (*p == ',')
+        {
+            p++;
+            if (!parseRule(&p, &start) || *p != ',')
+            {
+                return false;
+            }
+            p++;
+            if (!parseRule(&p, &end) || *p != '\0')
+            {
+                return false;
+            }
+        }
+        else if (*p != '\0')
+        {
+            return false;
+        }
+    }
+
+    this->_stdOffset = stdOffset;
+    this->_dstOffset = dstOffset;
+    this->_hasDST = hasDST;
+    this->_start = start;
+    this->_end = end;
+
+    // invalidate cache
+    this->_cacheFrom = 0;
+    this->_cacheUntil = 0;
+    return true;
+}
+
+/**
+ * @brief Change the offset of the standard time, the difference between standard and DST offset is kept
+ *
+ * @param offset offset of standard time to UTC in seconds (east of UTC = positive)
+ */
+void TimezoneRule::setStandardOffset(int32_t offset)
+{
+    this->_dstOffset += offset - this->_stdOffset;
+    this->_stdOffset = offset;
+    this->_cacheFrom = 0;
+    this->_cacheUntil = 0;
+}
+
+/**
+ * @brief Get the offset of the local time to UTC
+ *
+ * Only recalculated when the given time is outside of the interval between two transitions,
+ * otherwise it's just a comparison.
+ *
+ * @param utcSeconds UTC seconds since 1. Jan. 1900
+ * @return int32_t offset in seconds (local time = UTC + offset)
+ */
+int32_t TimezoneRule::getOffset(int64_t utcSeconds)
+{
+    if (utcSeconds < this->_cacheFrom || utcSeconds >= this->_cacheUntil)
+    {
+        this->updateCache(utcSeconds);
+    }
+    return this->_cacheOffset;
+}
+
+/**
+ * @brief Check if DST is active at the given time
+ *
+ * @param utcSeconds UTC seconds since 1. Jan. 1900
+ * @return true if DST is active
+ */
+bool TimezoneRule::isDST(int64_t utcSeconds)
+{
+    this->getOffset(utcSeconds);
+    return this->_cacheDST;
+}
+
+/**
+ * @brief Get the time of the next change of the offset
+ *
+ * @param utcSeconds UTC seconds since 1. Jan. 1900
+ * @return int64_t UTC seconds since 1. Jan. 1900 of next transition (INT64_MAX if there is none)
+ */
+int64_t TimezoneRule::getNextTransition(int64_t utcSeconds)
+{
+    this->getOffset(utcSeconds);
+    return this->_cacheUntil;
+}
+
+/**
+ * @brief Convert a date to days since 1. Jan. 1900 (algorithm "days_from_civil" from http://howardhinnant.github.io/date_algorithms.html)
+ *
+ * @param year year (>= 1900)
+ * @param month month (1-12)
+ * @param day day of month (1-31)
+ * @return long days since 1. Jan. 1900
+ */
+long TimezoneRule::daysFromCivil(unsigned int year, unsigned int month, unsigned int day)
+{
+    year -= month <= 2 ? 1 : 0;
+    unsigned long era = year / 400;
+    unsigned long yoe = year - era * 400;                                           // year of era [0, 399]
+    unsigned long doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;  // day of year starting at 1. March [0, 365]
+    unsigned long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                      // day of era [0, 146096]
+    return static_cast<long>(era * 146097 + doe) - 693901;
+}
+
+/**
+ * @brief Convert days since 1. Jan. 1900 to a date (closed form, no loops)
+ *
+ * Algorithm "civil_from_days" from http://howardhinnant.github.io/date_algorithms.html,
+ * counting years from 1. March so that the leap day is the last day of the year.
+ *
+ * @param days1900 days since 1. Jan. 1900
+ * @param year calculated year
+ * @param month calculated month (1-12)
+ * @param day calculated day of month (1-31)
+ */
+void TimezoneRule::civilFromDays(unsigned long days1900, unsigned int *year, unsigned int *month, unsigned int *day)
+{
+    unsigned long z = days1900 + 693901;                                            // days since 1. March 0000
+    unsigned long era = z / 146097;                                                 // 400 year cycles
+    unsigned long doe = z - era * 146097;                                           // day of era [0, 146096]
+    unsigned long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;      // year of era [0, 399]
+    unsigned long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                    // day of year starting at 1. March [0, 365]
+    unsigned long mp = (5 * doy + 2) / 153;                                         // month starting at March [0, 11]
+    *day = doy - (153 * mp + 2) / 5 + 1;
+    *month = mp < 10 ? mp + 3 : mp - 9;
+    *year = yoe + era * 400 + (*month <= 2 ? 1 : 0);
+}
+
+/**
+ * @brief (private) Calculate the offset valid at the given time and the interval until the next transition
+ *
+ * @param utcSeconds UTC seconds since 1. Jan. 1900
+ */
+void TimezoneRule::updateCache(int64_t utcSeconds)
+{
+    if (!this->_hasDST)
+    {
+        this->_cacheFrom = INT64_MIN;
+        this->_cacheUntil = INT64_MAX;
+        this->_cacheOffset = this->_stdOffset;
+        this->_cacheDST = false;
+        return;
+    }
+
+    unsigned int year, month, day;
+    civilFromDays((utcSeconds + this->_stdOffset) / 86400, &year, &month, &day);
+
+    // transitions of previous, current and next year in chronological order
+    int64_t transitions[6];
+    bool toDST[6];
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        int64_t start = this->transitionTime(year - 1 + i, this->_start, this->_stdOffset);
+        int64_t end = this->transitionTime(year - 1 + i, this->_end, this->_dstOffset);
+        // southern hemisphere: DST ends before it starts within a year
+        bool startFirst = start < end;
+        transitions[2 * i] = startFirst ? start : end;
+        toDST[2 * i] = startFirst;
+        transitions[2 * i + 1] = startFirst ? end : start;
+        toDST[2 * i + 1] = !startFirst;
+    }
+
+    // find last transition before the given time
+    int8_t last = -1;
+    while (last < 5 && transitions[last + 1] <= utcSeconds)
+    {
+        last++;
+    }
+
+    if (last < 0)
+    {
+        this->_cacheFrom = INT64_MIN;
+        this->_cacheDST = !toDST[0];
+    }
+    else
+    {
+        this->_cacheFrom = transitions[last];
+        this->_cacheDST = toDST[last];
+    }
+    this->_cacheUntil = last < 5 ? transitions[last + 1] : INT64_MAX;
+    this->_cacheOffset = this->_cacheDST ? this->_dstOffset : this->_stdOffset;
+}
+
+/**
+ * @brief (private) Calculate the time of a transition in the given year
+ *
+ * @param year year of transition
+ * @param rule transition rule
+ * @param offsetBefore offset to UTC valid before the transition (the time of the rule is given in this local time)
+ * @return int64_t UTC seconds since 1. Jan. 1900
+ */
+int64_t TimezoneRule::transitionTime(unsigned int year, const TransitionRule &rule, int32_t offsetBefore)
+{
+    long days = daysFromCivil(year, 1, 1);
+    bool leapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+
+    if (rule.type == 'J')
+    {
+        // 29. Feb is never counted
+        days += rule.day - 1 + (leapYear && rule.day >= 60 ? 1 : 0);
+    }
+    else if (rule.type == 'D')
+    {
+        days += rule.day;
+    }
+    else
+    {
+        long firstOfMonth = daysFromCivil(year, rule.month, 1);
+        long firstOfNextMonth = rule.month == 12 ? daysFromCivil(year + 1, 1, 1) : daysFromCivil(year, rule.month + 1, 1);
+        // 1. Jan. 1900 was a monday, weekday 0 = sunday
+        uint8_t weekdayFirst = (firstOfMonth + 1) % 7;
+        days = firstOfMonth + (rule.weekday + 7 - weekdayFirst) % 7 + (rule.week - 1) * 7;
+        // week 5 = last occurrence in month
+        while (days >= firstOfNextMonth)
+        {
+            days -= 7;
+        }
+    }
+
+    return static_cast<int64_t>(days) * 86400 + rule.time - offsetBefore;
+}
+
+/**
+ * @brief (private) Skip the name of a timezone (at least 3 letters or quoted in <>)
+ *
+ * @param p pointer to current position in string, moved behind the name
+ * @return true if name is valid
+ */
+bool TimezoneRule::parseName(const char **p)
+{
+    const char *s = *p;
+    if (*s == '<')
+    {
+        while (*s != '>')
+        {
+            if (*s == '\0')
+            {
+                return false;
+            }
+            s++;
+        }
+        *p = s + 1;
+        return true;
+    }
+    while (isalpha(*s))
+    {
+        s++;
+    }
+    if (s - *p < 3)
+    {
+        return false;
+    }
+    *p = s;
+    return true;
+}
+
+/**
+ * @brief (private) Parse an unsigned decimal number
+ *
+ * @param p pointer to current position in string, moved behind the number
+ * @param value parsed number
+ * @return true if a number was found
+ */
+bool TimezoneRule::parseNumber(const char **p, int32_t *value)
+{
+    if (!isdigit(**p))
+    {
+        return false;
+    }
+    *value = 0;
+    while (isdigit(**p))
+    {
+        *value = *value * 10 + (**p - '0');
+        (*p)++;
+    }
+    return true;
+}
+
+/**
+ * @brief (private) Parse a time or offset [+|-]hh[:mm[:ss]]
+ *
+ * @param p pointer to current position in string, moved behind the time
+ * @param seconds parsed time in seconds
+ * @return true if time is valid
+ */
+bool TimezoneRule::parseTime(const char **p, int32_t *seconds)
+{
+    int32_t sign = 1;
+    if (**p == '+' || **p == '-')
+    {
+        sign = **p == '-' ? -1 : 1;
+        (*p)++;
+    }
+    int32_t hours, minutes = 0, secs = 0;
+    if (!parseNumber(p, &hours))
+    {
+        return false;
+    }
+    if (**p == ':')
+    {
+        (*p)++;
+        if (!parseNumber(p, &minutes))
+        {
+            return false;
+        }
+        if (**p == ':')
+        {
+            (*p)++;
+            if (!parseNumber(p, &secs))
+            {
+                return false;
+            }
+        }
+    }
+    *seconds = sign * (hours * 3600 + minutes * 60 + secs);
+    return true;
+}
+
+/**
+ * @brief (private) Parse a transition rule Mm.w.d[/time], Jn[/time] or n[/time]
+ *
+ * @param p pointer to current position in string, moved behind the rule
+ * @param rule parsed rule
+ * @return true if rule is valid
+ */
+bool TimezoneRule::parseRule(const char **p, TransitionRule *rule)
+{
+    int32_t value;
+    rule->time = TZ_DEFAULT_TRANSITION_TIME;
+
+    if (**p == 'M')
+    {
+        int32_t week, weekday;
+        (*p)++;
+        if (!parseNumber(p, &value) || value < 1 || value > 12 || **p != '.')
+        {
+            return false;
+        }
+        (*p)++;
+        if (!parseNumber(p, &week) || week < 1 || week > 5 || **p != '.')
+        {
+            return false;
+        }
+        (*p)++;
+        if (!parseNumber(p, &weekday) || weekday > 6)
+        {
+            return false;
+        }
+        rule->type = 'M';
+        rule->month = value;
+        rule->week = week;
+        rule->weekday = weekday;
+    }
+    else if (**p == 'J')
+    {
+        (*p)++;
+        if (!parseNumber(p, &value) || value < 1 || value > 365)
+        {
+            return false;
+        }
+        rule->type = 'J';
+        rule->day = value;
+    }
+    else
+    {
+        if (!parseNumber(p, &value) || value > 365)
+        {
+            return false;
+        }
+        rule->type = 'D';
+        rule->day = value;
+    }
+
+    if (**p == '/')
+    {
+        (*p)++;
+        return parseTime(p, &rule->time);
+    }
+    return true;
+}
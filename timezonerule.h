@@ -0,0 +1,63 @@
+/**
+ * @file timezonerule.h
+ * @brief Class for calculating the local time offset (incl. daylight saving time) from a POSIX TZ string
+ *
+ * Examples of POSIX TZ strings:
+ * - Central Europe:    "CET-1CEST,M3.5.0,M10.5.0/3"
+ * - US Eastern:        "EST5EDT,M3.2.0,M11.1.0"
+ * - Australia Sydney:  "AEST-10AEDT,M10.1.0,M4.1.0/3"
+ * - Japan (no DST):    "JST-9"
+ *
+ */
+
+#ifndef timezonerule_h
+#define timezonerule_h
+
+#include <Arduino.h>
+
+#define TZ_DEFAULT_TRANSITION_TIME 7200 // time of transition if not given in rule (02:00:00)
+
+class TimezoneRule{
+
+    public:
+        TimezoneRule();
+        bool parse(const char *posixTZ);
+        void setStandardOffset(int32_t offset);
+        int32_t getOffset(int64_t utcSeconds);
+        bool isDST(int64_t utcSeconds);
+        int64_t getNextTransition(int64_t utcSeconds);
+        static long daysFromCivil(unsigned int year, unsigned int month, unsigned int day);
+        static void civilFromDays(unsigned long days1900, unsigned int *year, unsigned int *month, unsigned int *day);
+
+    private:
+        // rule for the start or end of DST: 'M' = month.week.weekday, 'J' = julian day 1-365 (without 29. Feb), 'D' = day 0-365
+        struct TransitionRule {
+            char type;
+            uint8_t month;
+            uint8_t week;
+            uint8_t weekday;
+            uint16_t day;
+            int32_t time;       // seconds after midnight (local time)
+        };
+
+        int32_t _stdOffset = 0;             // offset of standard time to UTC in seconds (east of UTC = positive)
+        int32_t _dstOffset = 0;             // offset of daylight saving time to UTC in seconds
+        bool _hasDST = false;
+        TransitionRule _start;
+        TransitionRule _end;
+
+        // cached offset, valid from _cacheFrom until (excluding) _cacheUntil (UTC seconds since 1900)
+        int64_t _cacheFrom = 0;
+        int64_t _cacheUntil = 0;
+        int32_t _cacheOffset = 0;
+        bool _cacheDST = false;
+
+        void updateCache(int64_t utcSeconds);
+        int64_t transitionTime(unsigned int year, const TransitionRule &rule, int32_t offsetBefore);
+        static bool parseName(const char **p);
+        static bool parseNumber(const char **p, int32_t *value);
+        static bool parseTime(const char **p, int32_t *seconds);
+        static bool parseRule(const char **p, TransitionRule *rule);
+};
+
+#endif
@@ -18,23 +18,125 @@ void UDPLogger::setName(String name){
 }
 
 void UDPLogger::logString(const String& logmessage){
-    // wait 5 milliseconds if last send was less than 5 milliseconds before 
-    if(millis() < (_lastSend + 5)){
-        delay(5);
-    }
     // use fixed buffer instead of string concatenation to avoid heap fragmentation
     // message will be truncated to fit into _packetBuffer (99 chars + NUL)
-    snprintf(_packetBuffer, sizeof(_packetBuffer), "%s: %s", _name.c_str(), logmessage.c_str());
-    Serial.println(_packetBuffer);
-    _Udp.beginPacketMulticast(_multicastAddr, _port, _interfaceAddr);
-    _Udp.print(_packetBuffer);
-    _Udp.endPacket();
-    _lastSend=millis();
+    int len = formatName();
+    snprintf(_packetBuffer + len, sizeof(_packetBuffer) - len, "%s", logmessage.c_str());
+    enqueue();
+}
+
+/**
+ * @brief Log a printf-style message without heap allocation (use the LOG_xxx macros)
+ *
+ * @param level log level of the message (LOG_LEVEL_ERROR ... LOG_LEVEL_DEBUG)
+ * @param format format string in PROGMEM
+ * @param ... arguments of the format string
+ */
+void UDPLogger::logf(uint8_t level, PGM_P format, ...){
+    // the LOG_xxx macros remove these calls already at compile time
+    if(level > LOG_LEVEL){
+        return;
+    }
+    int len = formatName();
+    va_list args;
+    va_start(args, format);
+    vsnprintf_P(_packetBuffer + len, sizeof(_packetBuffer) - len, format, args);
+    va_end(args);
+    enqueue();
 }
 
 void UDPLogger::logColor24bit(uint32_t color){
   uint8_t resultRed = color >> 16 & 0xff;
   uint8_t resultGreen = color >> 8 & 0xff;
   uint8_t resultBlue = color & 0xff;
-  logString(String(resultRed) + ", " + String(resultGreen) + ", " + String(resultBlue));
+  LOG_INFO(*this, "%u, %u, %u", resultRed, resultGreen, resultBlue);
+}
+
+/**
+ * @brief Send the next queued message if the send interval has passed, needs to be called in every loop cycle
+ *
+ */
+void UDPLogger::handle(){
+    if(_used > 0 && millis() - _lastSend >= LOG_SEND_INTERVAL){
+        sendNext();
+    }
+}
+
+/**
+ * @brief Send all queued messages (blocking), e.g. before a restart
+ *
+ */
+void UDPLogger::flush(){
+    while(_used > 0){
+        if(millis() - _lastSend < LOG_SEND_INTERVAL){
+            delay(1);
+            continue;
+        }
+        sendNext();
+    }
+}
+
+/**
+ * @brief Get the number of messages dropped because the ring buffer was full
+ *
+ * @return uint32_t number of messages
+ */
+uint32_t UDPLogger::getDropped(){
+    return _dropped;
+}
+
+/**
+ * @brief (private) Write the name prefix into _packetBuffer
+ *
+ * @return int length of the prefix
+ */
+int UDPLogger::formatName(){
+    int len = snprintf(_packetBuffer, sizeof(_packetBuffer), "%s: ", _name.c_str());
+    return min(len, (int)sizeof(_packetBuffer) - 1);
+}
+
+/**
+ * @brief (private) Print the message in _packetBuffer to Serial and copy it into the ring buffer
+ *
+ */
+void UDPLogger::enqueue(){
+    Serial.println(_packetBuffer);
+
+    uint16_t len = strlen(_packetBuffer);
+    if(_used + len + 1 > LOG_BUFFER_SIZE){
+        _dropped++;
+        return;
+    }
+    _buffer[_head] = len;
+    _head = (_head + 1) % LOG_BUFFER_SIZE;
+    for(uint16_t i = 0; i < len; i++){
+        _buffer[_head] = _packetBuffer[i];
+        _head = (_head + 1) % LOG_BUFFER_SIZE;
+    }
+    _used += len + 1;
+}
+
+/**
+ * @brief (private) Send the oldest queued message via UDP multicast
+ *
+ * @return true if a message was sent
+ */
+bool UDPLogger::sendNext(){
+    if(_used == 0){
+        return false;
+    }
+    uint16_t len = _buffer[_tail];
+    _tail = (_tail + 1) % LOG_BUFFER_SIZE;
+    for(uint16_t i = 0; i < len; i++){
+        _packetBuffer[i] = _buffer[_tail];
+        _tail = (_tail + 1) % LOG_BUFFER_SIZE;
+    }
+    _packetBuffer[len] = '\0';
+    _used -= len + 1;
+
+    _Udp.beginPacketMulticast(_multicastAddr, _port, _interfaceAddr);
+    _Udp.write((const uint8_t*)_packetBuffer, len);
+    _Udp.endPacket();
+    _lastSend = millis();
+    return true;
 }
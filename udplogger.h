@@ -1,12 +1,17 @@
 /**
  * @file udplogger.h
  * @author techniccontroller (mail[at]techniccontroller.com)
- * @brief Class for sending logging Strings as multicast messages 
- * @version 0.1
+ * @brief Class for sending logging Strings as multicast messages
+ * @version 0.2
  * @date 2022-03-21
- * 
+ *
+ * Messages are formatted into a fixed buffer and queued in a ring buffer, which is drained by handle()
+ * (one message per LOG_SEND_INTERVAL, without blocking the caller). If the ring buffer is full,
+ * new messages are dropped and counted. Use the LOG_xxx macros with format strings in PROGMEM,
+ * messages above LOG_LEVEL are removed at compile time.
+ *
  * @copyright Copyright (c) 2022
- * 
+ *
  */
 
 #ifndef udplogger_h
@@ -15,6 +20,42 @@
 #include <Arduino.h>
 #include <WiFiUdp.h>
 
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#define LOG_LEVEL LOG_LEVEL_INFO        // messages with a higher level are not compiled
+
+#define LOG_MESSAGE_SIZE 100            // max. length of a message incl. name and NUL
+#define LOG_BUFFER_SIZE 1024            // ring buffer for queued messages (1 byte length + text per message)
+#define LOG_SEND_INTERVAL 5             // min. time (ms) between two UDP messages
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(logger, format, ...) (logger).logf(LOG_LEVEL_ERROR, PSTR(format), ##__VA_ARGS__)
+#else
+#define LOG_ERROR(logger, format, ...) do {} while(0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARNING
+#define LOG_WARNING(logger, format, ...) (logger).logf(LOG_LEVEL_WARNING, PSTR(format), ##__VA_ARGS__)
+#else
+#define LOG_WARNING(logger, format, ...) do {} while(0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(logger, format, ...) (logger).logf(LOG_LEVEL_INFO, PSTR(format), ##__VA_ARGS__)
+#else
+#define LOG_INFO(logger, format, ...) do {} while(0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(logger, format, ...) (logger).logf(LOG_LEVEL_DEBUG, PSTR(format), ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(logger, format, ...) do {} while(0)
+#endif
+
 
 class UDPLogger{
 
@@ -23,15 +64,29 @@ class UDPLogger{
         UDPLogger(IPAddress interfaceAddr, IPAddress multicastAddr, int port);
         void setName(String name);
         void logString(const String& logmessage);
+        void logf(uint8_t level, PGM_P format, ...) __attribute__((format(printf, 3, 4)));
         void logColor24bit(uint32_t color);
+        void handle();
+        void flush();
+        uint32_t getDropped();
     private:
         String _name;
         IPAddress _multicastAddr;
         IPAddress _interfaceAddr;
         int _port;
         WiFiUDP _Udp;
-        char _packetBuffer[100];
+        char _packetBuffer[LOG_MESSAGE_SIZE];
         unsigned long _lastSend;
+
+        uint8_t _buffer[LOG_BUFFER_SIZE];
+        uint16_t _head = 0;             // next byte to write
+        uint16_t _tail = 0;             // next byte to read
+        uint16_t _used = 0;             // number of used bytes
+        uint32_t _dropped = 0;
+
+        int formatName();
+        void enqueue();
+        bool sendNext();
 };
 
-#endif
\ No newline at end of file
+#endif
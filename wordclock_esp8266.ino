@@ -42,32 +42,23 @@
 #include "tetris.h"
 #include "snake.h"
 #include "pong.h"
+#include "wordclocklayouts.h"
+#include "ledstream.h"
+#include "scheduler.h"
+#include "perfcounter.h"
+#include "telemetry.h"
+#include "eventstream.h"
+#include "jsonwriter.h"
+#include "commandregistry.h"
+#include "settings.h"
+#include "settingsjournal.h"
 
 
 // ----------------------------------------------------------------------------------
 //                                        CONSTANTS
 // ----------------------------------------------------------------------------------
 
-#define EEPROM_VERSION_CODE   3  // Change this value when defaults settings change
-
-// EEPROM address map (all uint8_t, 1 byte each)
-#define EEPROM_SIZE          14  // size of EEPROM to save persistent variables
-#define ADR_EEPROM_VERSION    0  // uint8_t
-#define ADR_NM_START_H        1  // uint8_t
-#define ADR_NM_END_H          2  // uint8_t
-#define ADR_NM_START_M        3  // uint8_t
-#define ADR_NM_END_M          4  // uint8_t
-#define ADR_BRIGHTNESS        5  // uint8_t
-#define ADR_MC_RED            6  // uint8_t
-#define ADR_MC_GREEN          7  // uint8_t
-#define ADR_MC_BLUE           8  // uint8_t
-#define ADR_STATE             9  // uint8_t
-#define ADR_NM_ACTIVATED     10  // uint8_t
-#define ADR_COLSHIFTSPEED    11  // uint8_t
-#define ADR_COLSHIFTACTIVE   12  // uint8_t
-#define ADR_NM_BRIGHTNESS    13  // uint8_t
-
-// DEFAULT SETTINGS (if one changes this, also increment the EEPROM_VERSION_CODE, to ensure that the EEPROM is updated with the new defaults)
+// DEFAULT SETTINGS (if one changes this, also increment the SETTINGS_VERSION in settings.h, to ensure that the EEPROM is updated with the new defaults)
 #define DEFAULT_NM_START_HOUR 22 // default start hour of nightmode (0-23)
 #define DEFAULT_NM_START_MIN 5   // default start minute of nightmode (0-59)
 #define DEFAULT_NM_END_HOUR 7    // default end hour of nightmode (0-23)
@@ -89,25 +80,42 @@
 #define RECT 5
 
 #define PERIOD_HEARTBEAT 5000
+#define PERIOD_TELEMETRY 1000     // period of the binary telemetry frames (0 = disabled)
+#define PERIOD_EVENTS 250         // check for state changes to be pushed to the event clients
+#define UI_STATE_JSON_SIZE 400    // buffer size for the UI state as JSON
 #define PERIOD_ANIMATION 200
 #define PERIOD_TETRIS 50
 #define PERIOD_SNAKE 50
 #define PERIOD_PONG 10
 #define TIMEOUT_LEDDIRECT 5000
+#define LEDDIRECT_CHUNK_SIZE 64   // number of base64 characters decoded at once (multiple of 4)
 #define TIMEOUT_WIFI_DISCONNECTED 30000
 #define PERIOD_STATECHANGE 10000
-#define PERIOD_NTPUPDATE 30000
+#define PERIOD_NTPRETRY 10000     // retry after failed NTP update
 #define PERIOD_TIMEVISUUPDATE 1000
 #define PERIOD_MATRIXUPDATE 100
 #define PERIOD_NIGHTMODECHECK 20000
+#define PERIOD_TIMEZONECHECK 10000  // check if cached timezone is expired
+#define PERIOD_TIMEZONERETRY 600000 // retry after failed timezone request (doubled after each further failure)
+#define PERIOD_TIMEZONERETRY_MAX 14400000 // max. retry period of the timezone request (4 h)
+#define PERIOD_SETTINGSCHECK 500    // check if changed settings need to be written to flash
+#define JOURNAL_KEY_MODECOLOR 0x0100 // + state: uint8_t[3] main color of a mode in the settings journal (see command "modecolor")
+#define MAX_LOOP_SLEEP 5            // max. sleep time (ms) of the loop between tasks
+#define MAX_COMMANDS_PER_REQUEST 16 // max. number of commands in one request to /cmd
 
 #define SHORTPRESS 100
 #define LONGPRESS 2000
 
 #define CURRENT_LIMIT_LED 2500 // limit the total current sonsumed by LEDs (mA)
+// current (mA) of one color channel of a LED at full value, adapt to the LED type (e.g. red draws less on some WS2812B)
+#define CURRENT_LED_RED 20
+#define CURRENT_LED_GREEN 20
+#define CURRENT_LED_BLUE 20
 
 #define DEFAULT_SMOOTHING_FACTOR 0.5
 
+#define USE_CLOCKFACE_CACHE false // render all clock faces once at boot (needs about 5.5 kB of RAM, see clockfacecache.ino)
+
 // number of colors in colors array
 #define NUM_COLORS 7
 
@@ -144,7 +152,8 @@ const String hostname = "wordclock";
 // URL DNS server
 const char WebserverURL[] = "www.wordclock.local";
 
-int utcOffset = 60; // UTC offset in minutes
+// timezone as POSIX TZ string (UTC offset and daylight saving time rule), e.g. "EST5EDT,M3.2.0,M11.1.0" for US Eastern
+const char timezoneRule[] = "CET-1CEST,M3.5.0,M10.5.0/3";
 
 // ----------------------------------------------------------------------------------
 //                                        GLOBAL VARIABLES
@@ -182,25 +191,71 @@ uint8_t brightness = DEFAULT_BRIGHTNESS;            // current brightness of led
 bool sprialDir = false;
 
 // timestamp variables
-long lastheartbeat = millis();      // time of last heartbeat sending
-long lastStep = millis();           // time of last animation step
 long lastLEDdirect = -TIMEOUT_LEDDIRECT; // time of last direct LED command (=> fall back to normal mode after timeout)
-long lastStateChange = millis();    // time of last state change
-long lastNTPUpdate = millis() - (PERIOD_NTPUPDATE-3000);  // time of last NTP update
-long lastAnimationStep = millis();  // time of last Matrix update
-long lastNightmodeCheck = millis()  - (PERIOD_NIGHTMODECHECK-3000); // time of last nightmode check
 long buttonPressStart = 0;          // time of push button press start 
 long wifiDisconnectedSince = 0;     // time since WiFi connection was lost (0 = connected)
+bool wifiLost = false;              // WiFi connection lost for longer than TIMEOUT_WIFI_DISCONNECTED (shows a red pixel)
 uint16_t behaviorUpdatePeriod = PERIOD_TIMEVISUUPDATE; // holdes the period in which the behavior should be updated
 
+// ids of the tasks of the scheduler
+int8_t taskHeartbeat = SCHEDULER_NO_TASK;
+int8_t taskStateBehavior = SCHEDULER_NO_TASK;
+int8_t taskMatrixUpdate = SCHEDULER_NO_TASK;
+int8_t taskStateChange = SCHEDULER_NO_TASK;
+int8_t taskNTPUpdate = SCHEDULER_NO_TASK;
+int8_t taskTimezoneUpdate = SCHEDULER_NO_TASK;
+int8_t taskNightmodeCheck = SCHEDULER_NO_TASK;
+int8_t taskTelemetry = SCHEDULER_NO_TASK;
+int8_t taskEvents = SCHEDULER_NO_TASK;
+int8_t taskSettings = SCHEDULER_NO_TASK;
+
+// state shown in the web UI, the last published state is used to send only the changes to the event clients
+struct UIState {
+  uint8_t state;
+  bool stateAutoChange;
+  bool ledOff;
+  bool nightModeActivated;
+  uint8_t nightModeStartHour;
+  uint8_t nightModeStartMin;
+  uint8_t nightModeEndHour;
+  uint8_t nightModeEndMin;
+  uint8_t brightness;
+  uint8_t nightModeBrightness;
+  bool colorshift;
+  uint8_t colorshiftspeed;
+  uint8_t layout;
+  uint32_t color;
+};
+UIState publishedUIState;
+
+#if PERF_ENABLED
+// ids of the instrumented sections
+int8_t perfLoop = PERF_NO_SECTION;
+int8_t perfServer = PERF_NO_SECTION;
+int8_t perfLEDStream = PERF_NO_SECTION;
+int8_t perfBehavior = PERF_NO_SECTION;
+int8_t perfMatrix = PERF_NO_SECTION;
+int8_t perfNTP = PERF_NO_SECTION;
+#endif
+
 // Create necessary global objects
 UDPLogger logger;
 WiFiUDP NTPUDP;
-NTPClientPlus ntp = NTPClientPlus(NTPUDP, "pool.ntp.org", utcOffset, true);
+NTPClientPlus ntp = NTPClientPlus(NTPUDP, "pool.ntp.org", timezoneRule);
 LEDMatrix ledmatrix = LEDMatrix(&matrix, brightness, &logger);
 Tetris mytetris = Tetris(&ledmatrix, &logger);
 Snake mysnake = Snake(&ledmatrix, &logger);
 Pong mypong = Pong(&ledmatrix, &logger);
+LEDStream ledstream = LEDStream(&ledmatrix);
+Scheduler scheduler;
+Telemetry telemetry;
+EventStream events = EventStream(&server);
+CommandRegistry commands;
+SettingsStore settings;
+SettingsJournal journal = SettingsJournal(&LittleFS);
+#if PERF_ENABLED
+PerfCounter perf;
+#endif
 
 float filterFactor = DEFAULT_SMOOTHING_FACTOR;        // stores smoothing factor for led transition
 uint8_t currentState = st_clock;                      // stores current state
@@ -214,6 +269,7 @@ bool apmode = false;                                  // stores if WiFi AP mode
 bool dynColorShiftActive = DEFAULT_COLSHIFT_ACTIVE;   // stores if dynamic color shift is active
 uint8_t dynColorShiftPhase = 0;                       // stores the phase of the dynamic color shift
 uint8_t dynColorShiftSpeed = DEFAULT_COLSHIFT_SPEED;  // stores the speed of the dynamic color shift -> used to calc update period
+uint8_t currentLayout = DEFAULT_LAYOUT;               // stores the language layout of the clock face
 
 // nightmode settings
 uint8_t nightModeStartHour = DEFAULT_NM_START_HOUR;
@@ -226,6 +282,8 @@ uint8_t nightModeBrightness = DEFAULT_NM_BRIGHTNESS;
 int watchdogCounter = 30;
 
 bool waitForTimeAfterReboot = false; // wait for time update after reboot
+uint32_t timezoneRetryPeriod = PERIOD_TIMEZONERETRY; // delay of the next retry after a failed timezone request
+bool rebootRequested = false;        // restart after the response to the current command was sent
 
 // ----------------------------------------------------------------------------------
 //                                        SETUP
@@ -239,27 +297,8 @@ void setup() {
   Serial.printf("\nSketchname: %s\nBuild: %s\n", (__FILE__), (__TIMESTAMP__));
   Serial.println();
 
-  //Init EEPROM
-  EEPROM.begin(EEPROM_SIZE);
-
-  // Check EEPROM version code
-  uint8_t storedVersion = EEPROM.read(ADR_EEPROM_VERSION);
-  if (storedVersion != EEPROM_VERSION_CODE) {
-    // Set new defaults
-    EEPROM.write(ADR_EEPROM_VERSION, EEPROM_VERSION_CODE);
-    EEPROM.write(ADR_NM_START_H, DEFAULT_NM_START_HOUR);
-    EEPROM.write(ADR_NM_START_M, DEFAULT_NM_START_MIN);
-    EEPROM.write(ADR_NM_END_H, DEFAULT_NM_END_HOUR);
-    EEPROM.write(ADR_NM_END_M, DEFAULT_NM_END_MIN);
-    EEPROM.write(ADR_BRIGHTNESS, DEFAULT_BRIGHTNESS);
-    setMainColor(DEFAULT_MC_RED, DEFAULT_MC_GREEN, DEFAULT_MC_BLUE);
-    EEPROM.write(ADR_STATE, st_clock);
-    EEPROM.write(ADR_NM_ACTIVATED, DEFAULT_NM_ACTIVATED);
-    EEPROM.write(ADR_COLSHIFTSPEED, DEFAULT_COLSHIFT_SPEED);
-    EEPROM.write(ADR_COLSHIFTACTIVE, DEFAULT_COLSHIFT_ACTIVE);
-    EEPROM.write(ADR_NM_BRIGHTNESS, DEFAULT_NM_BRIGHTNESS);
-    EEPROM.commit();
-  }
+  // load persistent settings from EEPROM (defaults if no valid settings are stored)
+  bool settingsLoaded = settings.begin(getDefaultSettings());
 
   // configure button pin as input
   pinMode(BUTTONPIN, INPUT_PULLUP);
@@ -267,6 +306,7 @@ void setup() {
   // setup Matrix LED functions
   ledmatrix.setupMatrix();
   ledmatrix.setCurrentLimit(CURRENT_LIMIT_LED);
+  ledmatrix.setCurrentModel(CURRENT_LED_RED, CURRENT_LED_GREEN, CURRENT_LED_BLUE);
 
   if(ESP.getResetReason().equals("Power On") || ESP.getResetReason().equals("External System")){
     // Turn on minutes leds (blue)
@@ -367,32 +407,42 @@ void setup() {
   // init ESP8266 File manager (LittleFS)
   setupFS();
 
+  // load additional settings from the journal on LittleFS
+  bool journalLoaded = journal.begin();
+
   // setup OTA
   setupOTA(hostname);
 
   server.on("/cmd", handleCommand); // process commands
   server.on("/data", handleDataRequest); // process datarequests
+  server.on("/events", handleEvents); // push channel for state changes (Server-Sent Events)
   server.on("/leddirect", HTTP_POST, handleLEDDirect); // Call the 'handleLEDDirect' function when a POST request is made to URI "/leddirect"
+  const char *collectedHeaders[] = {"Content-Type"};    // needed to detect raw binary data for /leddirect
+  server.collectHeaders(collectedHeaders, 1);
   server.begin();
+
+  // listen for raw LED frames via UDP (DDP protocol)
+  ledstream.begin(LEDSTREAM_PORT);
   
   // create UDP Logger to send logging messages via UDP multicast
   logger = UDPLogger(WiFi.localIP(), logMulticastIP, logMulticastPort);
   logger.setName("Wordclock 2.0");
-  logger.logString("Start program\n");
-  delay(10);
-  logger.logString("Sketchname: "+ String(__FILE__));
-  delay(10);
-  logger.logString("Build: " + String(__TIMESTAMP__));
-  delay(10);
-  logger.logString("IP: " + WiFi.localIP().toString());
-  delay(10);
-  logger.logString("Reset Reason: " + ESP.getResetReason());
-
-  // setup NTP
-  updateUTCOffsetFromTimezoneAPI(logger, ntp);
+
+  // binary telemetry frames are sent to the same multicast group on a separate port
+  telemetry.begin(WiFi.localIP(), logMulticastIP, TELEMETRY_PORT);
+  LOG_INFO(logger, "Start program");
+  LOG_INFO(logger, "Sketchname: %s", __FILE__);
+  LOG_INFO(logger, "Build: %s", __TIMESTAMP__);
+  LOG_INFO(logger, "IP: %s", WiFi.localIP().toString().c_str());
+  LOG_INFO(logger, "Reset Reason: %s", ESP.getResetReason().c_str());
+  LOG_INFO(logger, "Settings %s, flash writes: %u", settingsLoaded ? "loaded" : "reset to defaults", settings.getWriteCount());
+  LOG_INFO(logger, "Settings journal %s, keys: %u", journalLoaded ? "loaded" : "repaired", journal.getNumKeys());
+
+  // setup NTP (timezone from cache, it is refreshed in the loop after the clock is running)
+  loadTimezoneFromEEPROM(logger, ntp);
   ntp.setupNTPClient();
-  logger.logString("NTP running");
-  logger.logString("Time: " +  ntp.getFormattedTime());
+  LOG_INFO(logger, "NTP running");
+  LOG_INFO(logger, "Time: %s", ntp.getFormattedTime().c_str());
 
   // load persistent variables from EEPROM
   loadMainColorFromEEPROM();
@@ -401,6 +451,11 @@ void setup() {
   loadBrightnessSettingsFromEEPROM();
   loadColorShiftStateFromEEPROM();
   loadNightmodeBrightnessFromEEPROM();
+  loadLayoutFromEEPROM();
+  applyModeColor();
+
+  // send the startup messages now, before they fill up the log buffer (setup is blocking anyway)
+  logger.flush();
   
   if(ESP.getResetReason().equals("Power On") || ESP.getResetReason().equals("External System")){
     // test quickly each LED
@@ -416,6 +471,7 @@ void setup() {
     // clear Matrix
     matrix.fillScreen(0);
     matrix.show();
+    ledmatrix.forceRedraw();
     delay(200);
 
     // display IP
@@ -436,6 +492,21 @@ void setup() {
     waitForTimeAfterReboot = true;
   }
 
+  if(USE_CLOCKFACE_CACHE){
+    buildClockFaceCache();
+    benchmarkClockFace();
+  }
+
+  // register periodic tasks
+  setupTasks();
+
+  // register the commands of the /cmd route
+  setupCommands();
+
+#if PERF_ENABLED
+  setupPerfSections();
+#endif
+
   // run the entry action for the initial state
   entryAction(currentState);
 }
@@ -446,43 +517,240 @@ void setup() {
 // ----------------------------------------------------------------------------------
 
 void loop() {
-  // handle OTA
-  handleOTA();
-  
-  // handle Webserver
-  server.handleClient();
-
-  // send regularly heartbeat messages via UDP multicast
-  if(millis() - lastheartbeat > PERIOD_HEARTBEAT){
-    logger.logString("Heartbeat, state: " + stateNames[currentState] + ", FreeHeap: " + ESP.getFreeHeap() + ", HeapFrag: " + ESP.getHeapFragmentation() + ", MaxFreeBlock: " + ESP.getMaxFreeBlockSize() + "\n");
-    lastheartbeat = millis();
-
-    // Check wifi status (only if no apmode)
-    if(!apmode){
-      if(WiFi.status() != WL_CONNECTED){
-        if(wifiDisconnectedSince == 0){
-          wifiDisconnectedSince = millis();
-          Serial.println("connection lost");
-        }
+  uint32_t idle = 0;
 
-        if(millis() - wifiDisconnectedSince >= TIMEOUT_WIFI_DISCONNECTED){
-          ledmatrix.gridAddPixel(0, 5, colors24bit[1]);
-          ledmatrix.drawOnMatrixInstant();
-          delay(1000);
-        }
+  // send queued log messages
+  logger.handle();
+
+  {
+    // duration of one loop cycle without sleep
+    PERF_SCOPE(perf, perfLoop);
+
+    // handle OTA
+    handleOTA();
+    
+    // handle Webserver
+    {
+      PERF_SCOPE(perf, perfServer);
+      server.handleClient();
+    }
+
+    // handle LED frames received via UDP, uses the same timeout as /leddirect to fall back to normal mode
+    {
+      PERF_SCOPE(perf, perfLEDStream);
+      if(ledstream.handle()){
+        ledmatrix.drawOnMatrixInstant();
+        lastLEDdirect = millis();
       }
-      else {
-        wifiDisconnectedSince = 0;
+    }
+
+    // handle button press
+    handleButton();
+
+    // collect the answers of pending NTP and timezone requests
+    {
+      PERF_SCOPE(perf, perfNTP);
+      handleNTPAnswer();
+      handleTimezoneAnswer();
+    }
+
+    // run all due tasks
+    idle = scheduler.run();
+  }
+
+  // sleep until the next deadline (limited to keep webserver and UDP responsive)
+  if(idle > 0){
+    delay(min(idle, (uint32_t)MAX_LOOP_SLEEP));
+  }
+}
+
+/**
+ * @brief Register all periodic tasks at the scheduler
+ */
+void setupTasks(){
+  taskHeartbeat = scheduler.addTask("heartbeat", heartbeatTask, PERIOD_HEARTBEAT, PERIOD_HEARTBEAT);
+  taskStateBehavior = scheduler.addTask("behavior", stateBehaviorTask, behaviorUpdatePeriod, 0);
+  taskMatrixUpdate = scheduler.addTask("matrix", matrixUpdateTask, PERIOD_MATRIXUPDATE, 0);
+  taskStateChange = scheduler.addTask("statechange", stateChangeTask, PERIOD_STATECHANGE, PERIOD_STATECHANGE);
+  taskNTPUpdate = scheduler.addTask("ntp", ntpUpdateTask, ntp.getPollInterval(), 3000);
+  taskTimezoneUpdate = scheduler.addTask("timezone", timezoneUpdateTask, PERIOD_TIMEZONECHECK, PERIOD_TIMEZONECHECK);
+  taskNightmodeCheck = scheduler.addTask("nightmode", nightmodeCheckTask, PERIOD_NIGHTMODECHECK, 3000);
+  taskEvents = scheduler.addTask("events", eventsTask, PERIOD_EVENTS, PERIOD_EVENTS);
+  taskSettings = scheduler.addTask("settings", settingsTask, PERIOD_SETTINGSCHECK, PERIOD_SETTINGSCHECK);
+  if(PERIOD_TELEMETRY > 0){
+    taskTelemetry = scheduler.addTask("telemetry", telemetryTask, PERIOD_TELEMETRY, PERIOD_TELEMETRY);
+  }
+}
+
+#if PERF_ENABLED
+/**
+ * @brief Register all instrumented code sections
+ */
+void setupPerfSections(){
+  perfLoop = perf.addSection("loop");
+  perfServer = perf.addSection("server");
+  perfLEDStream = perf.addSection("ledstream");
+  perfBehavior = perf.addSection("behavior");
+  perfMatrix = perf.addSection("matrix");
+  perfNTP = perf.addSection("ntp");
+}
+
+/**
+ * @brief Log p99 and max duration of all instrumented sections (split into several messages if necessary)
+ */
+void logPerfStats(){
+  char line[64] = "";
+  size_t len = 0;
+  for(int8_t i = 0; i < perf.getNumSections(); i++){
+    char entry[32];
+    snprintf(entry, sizeof(entry), " %s %u/%u", perf.getName(i), perf.getPercentile(i, 99), perf.getMax(i));
+    if(len > 0 && len + strlen(entry) >= sizeof(line)){
+      LOG_INFO(logger, "Perf p99/max us:%s", line);
+      len = 0;
+    }
+    len += snprintf(line + len, sizeof(line) - len, "%s", entry);
+  }
+  LOG_INFO(logger, "Perf p99/max us:%s", line);
+}
+#endif
+
+/**
+ * @brief Task: send regularly heartbeat messages via UDP multicast and check the WiFi connection
+ */
+void heartbeatTask(){
+  LOG_INFO(logger, "Heartbeat, state: %s, FreeHeap: %u, HeapFrag: %u, MaxFreeBlock: %u", stateNames[currentState].c_str(),
+            ESP.getFreeHeap(), ESP.getHeapFragmentation(), ESP.getMaxFreeBlockSize());
+  LOG_INFO(logger, "Frames shown: %u, skipped: %u, max us: %u, mA: %u", ledmatrix.getFramesShown(), ledmatrix.getFramesSkipped(),
+            ledmatrix.getMaxFrameTime(true), ledmatrix.getEstimatedCurrent());
+  if(millis() - lastLEDdirect <= TIMEOUT_LEDDIRECT){
+    LOG_INFO(logger, "LED stream fps: %u, frames: %u, dropped: %u, invalid: %u", ledstream.getFramesPerSecond(),
+              ledstream.getFramesReceived(), ledstream.getPacketsDropped(), ledstream.getPacketsInvalid());
+  }
+  logTaskStats();
+#if PERF_ENABLED
+  logPerfStats();
+#endif
+
+  // Check wifi status (only if no apmode)
+  if(!apmode){
+    if(WiFi.status() != WL_CONNECTED){
+      if(wifiDisconnectedSince == 0){
+        wifiDisconnectedSince = millis();
+        Serial.println("connection lost");
       }
+
+      // the red pixel is added by matrixUpdateTask(), so the loop is not blocked here
+      wifiLost = (millis() - wifiDisconnectedSince >= TIMEOUT_WIFI_DISCONNECTED);
+    }
+    else {
+      wifiDisconnectedSince = 0;
+      wifiLost = false;
+    }
+  }
+}
+
+/**
+ * @brief Task: send a binary telemetry frame via UDP multicast
+ */
+void telemetryTask(){
+  TelemetryFrame frame;
+  frame.state = currentState;
+  frame.uptime = millis();
+  frame.freeHeap = ESP.getFreeHeap();
+  frame.maxFreeBlock = ESP.getMaxFreeBlockSize();
+  frame.heapFragmentation = ESP.getHeapFragmentation();
+  frame.rssi = apmode ? 0 : WiFi.RSSI();
+  frame.flags = (ntp.isSynced() ? TELEMETRY_FLAG_NTP_SYNCED : 0)
+                | (nightMode ? TELEMETRY_FLAG_NIGHTMODE : 0)
+                | (ledOff ? TELEMETRY_FLAG_LED_OFF : 0)
+                | ((millis() - lastLEDdirect <= TIMEOUT_LEDDIRECT) ? TELEMETRY_FLAG_LED_DIRECT : 0);
+  frame.ntpOffset = ntp.getOffset();
+  frame.ntpDrift = ntp.getDrift();
+  frame.ledCurrent = ledmatrix.getEstimatedCurrent();
+  frame.streamFps = ledstream.getFramesPerSecond();
+#if PERF_ENABLED
+  frame.loopCount = perf.getCount(perfLoop);
+  frame.loopAvg = perf.getAvg(perfLoop);
+  frame.loopP99 = perf.getPercentile(perfLoop, 99);
+  frame.loopMax = perf.getMax(perfLoop);
+#else
+  frame.loopCount = 0;
+  frame.loopAvg = 0;
+  frame.loopP99 = 0;
+  frame.loopMax = 0;
+#endif
+  frame.logDrops = logger.getDropped();
+  telemetry.send(frame);
+}
+
+/**
+ * @brief Task: push changes of the UI state to the event clients and keep the connections alive
+ */
+void eventsTask(){
+  events.handle();
+  UIState current = getUIState();
+  if(events.getNumClients() > 0){
+    char json[UI_STATE_JSON_SIZE];
+    if(formatUIState(json, sizeof(json), current, &publishedUIState) > 0){
+      events.broadcast("state", json);
     }
   }
+  publishedUIState = current;
+}
+
+/**
+ * @brief Task: write changed settings to the flash after the quiet period
+ */
+void settingsTask(){
+  bool pending = settings.isPending();
+  settings.handle();
+  if(pending && !settings.isPending()){
+    LOG_INFO(logger, "Settings saved, %u changes, flash writes: %u", settings.getChanges(), settings.getWriteCount());
+  }
+}
 
-  // handle state behaviours (trigger loopCycles of different states depending on current state)
-  if(!ledOff && (millis() - lastStep > behaviorUpdatePeriod) && (millis() - lastLEDdirect > TIMEOUT_LEDDIRECT)){
-    updateStateBehavior(currentState);    
-    lastStep = millis();
+/**
+ * @brief Log the task with the longest run time and the task with the largest lateness since the last call
+ */
+void logTaskStats(){
+  int8_t slowest = 0;
+  int8_t latest = 0;
+  for(int8_t i = 1; i < scheduler.getNumTasks(); i++){
+    if(scheduler.getMaxRunTime(i) > scheduler.getMaxRunTime(slowest)) slowest = i;
+    if(scheduler.getMaxLateness(i) > scheduler.getMaxLateness(latest)) latest = i;
   }
+  LOG_INFO(logger, "Tasks: max run %s %u us, max late %s %u ms, log drops: %u", scheduler.getName(slowest),
+            scheduler.getMaxRunTime(slowest), scheduler.getName(latest), scheduler.getMaxLateness(latest), logger.getDropped());
+  scheduler.resetStats();
+}
 
+/**
+ * @brief Task: handle state behaviours (trigger loopCycles of different states depending on current state)
+ */
+void stateBehaviorTask(){
+  if(!ledOff && (millis() - lastLEDdirect > TIMEOUT_LEDDIRECT)){
+    PERF_SCOPE(perf, perfBehavior);
+    updateStateBehavior(currentState);
+  }
+  // period depends on the state (and may be adjusted by the state itself)
+  scheduleStateBehavior();
+}
+
+/**
+ * @brief Re-arm the behavior task: the clock runs right after the next full second, all other states with a fixed period
+ */
+void scheduleStateBehavior(){
+  scheduler.setPeriod(taskStateBehavior, behaviorUpdatePeriod);
+  if(currentState == st_clock && !dynColorShiftActive){
+    // relative to now and not to the last deadline, a late run would otherwise trigger a second update in the same second
+    scheduler.schedule(taskStateBehavior, PERIOD_TIMEVISUUPDATE - ntp.getMilliseconds());
+  }
+}
+
+/**
+ * @brief Task: apply brightness and periodically write colors to matrix
+ */
+void matrixUpdateTask(){
   // Turn off LEDs if ledOff is true
   if(ledOff && !waitForTimeAfterReboot){
     ledmatrix.gridFlush();
@@ -496,80 +764,136 @@ void loop() {
     ledmatrix.setBrightness(brightness);
   }
 
-  // periodically write colors to matrix
-  if(millis() - lastAnimationStep > PERIOD_MATRIXUPDATE && !waitForTimeAfterReboot && (millis() - lastLEDdirect > TIMEOUT_LEDDIRECT)){
+  if(!waitForTimeAfterReboot && (millis() - lastLEDdirect > TIMEOUT_LEDDIRECT)){
+    PERF_SCOPE(perf, perfMatrix);
+    if(wifiLost){
+      ledmatrix.gridAddPixel(0, 5, colors24bit[1]);
+    }
     ledmatrix.drawOnMatrixSmooth(filterFactor);
-    lastAnimationStep = millis();
   }
+}
 
-  // handle button press
-  handleButton();
-
-  // handle state changes
-  if(stateAutoChange && (millis() - lastStateChange > PERIOD_STATECHANGE) && !ledOff){
+/**
+ * @brief Task: automatic state change
+ */
+void stateChangeTask(){
+  if(stateAutoChange && !ledOff){
     // increment state variable and trigger state change
     stateChange((currentState + 1) % NUM_STATES, false);
-    
-    // save last automatic state change
-    lastStateChange = millis();
-  }
-
-  // NTP time update
-  if(millis() - lastNTPUpdate > PERIOD_NTPUPDATE){
-    int res = ntp.updateNTP();
-    if(res == 0){
-      ntp.calcDate();
-      logger.logString("NTP-Update successful");
-      logger.logString("Time: " +  ntp.getFormattedTime());
-      logger.logString("Date: " +  ntp.getFormattedDate());
-      logger.logString("Day of Week (Mon=1, Sun=7): " +  String(ntp.getDayOfWeek()));
-      logger.logString("Summertime: " + String(ntp.updateSWChange()));
-      lastNTPUpdate = millis();
-      watchdogCounter = 30;
-      checkNightmode();
-      if(waitForTimeAfterReboot && !nightMode){
-        // update mode (e.g. write the current time onto the matrix) first time after reboot
-        entryAction(currentState);
-        updateStateBehavior(currentState);
-        ledmatrix.drawOnMatrixInstant();
-      }
-      waitForTimeAfterReboot = false;
-    }
-    else if(res == -1){
-      logger.logString("NTP-Update not successful. Reason: Timeout");
-      lastNTPUpdate += 10000;
-      watchdogCounter--;
-    }
-    else if(res == 1){
-      logger.logString("NTP-Update not successful. Reason: Too large time difference");
-      logger.logString("Time: " +  ntp.getFormattedTime());
-      logger.logString("Date: " +  ntp.getFormattedDate());
-      logger.logString("Day of Week (Mon=1, Sun=7): " +  ntp.getDayOfWeek());
-      logger.logString("Summertime: " + String(ntp.updateSWChange()));
-      lastNTPUpdate += 10000;
-      watchdogCounter--;
-    }
-    else {
-      logger.logString("NTP-Update not successful. Reason: NTP time not valid (<1970)");
-      lastNTPUpdate += 10000;
-      watchdogCounter--;
+  }
+}
+
+/**
+ * @brief Task: send NTP request (asynchronous, the answer is collected by handleNTPAnswer())
+ */
+void ntpUpdateTask(){
+  if(!ntp.isUpdatePending()){
+    ntp.beginUpdate();
+  }
+}
+
+/**
+ * @brief Check for the answer of a pending NTP request and process the result
+ */
+void handleNTPAnswer(){
+  int res = ntp.poll();
+  if(res == NTP_UPDATE_PENDING || res == NTP_UPDATE_IDLE){
+    return;
+  }
+
+  if(res == NTP_UPDATE_OK){
+    ntp.calcDate();
+    LOG_INFO(logger, "NTP-Update successful");
+    LOG_INFO(logger, "Time: %s", ntp.getFormattedTime().c_str());
+    LOG_INFO(logger, "Date: %s", ntp.getFormattedDate().c_str());
+    LOG_INFO(logger, "Day of Week (Mon=1, Sun=7): %u", ntp.getDayOfWeek());
+    LOG_INFO(logger, "Summertime: %d", ntp.updateSWChange());
+    LOG_INFO(logger, "NTP offset: %ld ms, delay: %ld ms, drift: %ld ppb, poll: %lu s", ntp.getOffset(), ntp.getDelay(),
+              ntp.getDrift(), ntp.getPollInterval() / 1000);
+    // poll interval is adapted by NTPClientPlus
+    scheduler.setPeriod(taskNTPUpdate, ntp.getPollInterval());
+    watchdogCounter = 30;
+    checkNightmode();
+    if(waitForTimeAfterReboot && !nightMode){
+      // update mode (e.g. write the current time onto the matrix) first time after reboot
+      entryAction(currentState);
+      updateStateBehavior(currentState);
+      ledmatrix.drawOnMatrixInstant();
     }
+    waitForTimeAfterReboot = false;
+  }
+  else if(res == NTP_UPDATE_TIMEOUT){
+    LOG_WARNING(logger, "NTP-Update not successful. Reason: Timeout");
+    scheduler.schedule(taskNTPUpdate, PERIOD_NTPRETRY);
+    watchdogCounter--;
+  }
+  else if(res == NTP_UPDATE_DIFF){
+    LOG_WARNING(logger, "NTP-Update not successful. Reason: Too large time difference");
+    LOG_INFO(logger, "Time: %s", ntp.getFormattedTime().c_str());
+    LOG_INFO(logger, "Date: %s", ntp.getFormattedDate().c_str());
+    LOG_INFO(logger, "Day of Week (Mon=1, Sun=7): %u", ntp.getDayOfWeek());
+    LOG_INFO(logger, "Summertime: %d", ntp.updateSWChange());
+    scheduler.schedule(taskNTPUpdate, PERIOD_NTPRETRY);
+    watchdogCounter--;
+  }
+  else {
+    LOG_WARNING(logger, "NTP-Update not successful. Reason: NTP time not valid (<1970)");
+    scheduler.schedule(taskNTPUpdate, PERIOD_NTPRETRY);
+    watchdogCounter--;
+  }
+
+  LOG_INFO(logger, "Watchdog Counter: %d", watchdogCounter);
+  if(watchdogCounter <= 0){
+      LOG_ERROR(logger, "Trigger restart due to watchdog...");
+      settings.commit();
+      logger.flush();
+      delay(100);
+      ESP.restart();
+  }
+}
 
-    logger.logString("Watchdog Counter: " + String(watchdogCounter));
-    if(watchdogCounter <= 0){
-        logger.logString("Trigger restart due to watchdog...");
-        delay(100);
-        ESP.restart();
+/**
+ * @brief Task: refresh cached timezone (only with valid time, to be able to check the expiry),
+ * the answer is collected by handleTimezoneAnswer()
+ */
+void timezoneUpdateTask(){
+  if(ntp.isSynced() && !waitForTimeAfterReboot && !isTimezoneRequestPending() && isTimezoneCacheExpired(ntp)){
+    if(!beginTimezoneRequest(logger)){
+      scheduleTimezoneRetry();
     }
-    
   }
+}
+
+/**
+ * @brief Check for the answer of a pending timezone request, retry later if it failed
+ */
+void handleTimezoneAnswer(){
+  if(!pollTimezoneRequest(logger, ntp)){
+    return;
+  }
+  if(isTimezoneCacheExpired(ntp)){
+    scheduleTimezoneRetry();
+  }
+  else{
+    timezoneRetryPeriod = PERIOD_TIMEZONERETRY;
+  }
+}
+
+/**
+ * @brief Schedule the next timezone request after a failed one, the period is doubled while the API is not reachable
+ */
+void scheduleTimezoneRetry(){
+  scheduler.schedule(taskTimezoneUpdate, timezoneRetryPeriod);
+  timezoneRetryPeriod = min(timezoneRetryPeriod * 2, (uint32_t)PERIOD_TIMEZONERETRY_MAX);
+}
 
-  // check if nightmode need to be activated
-  if(millis() - lastNightmodeCheck > PERIOD_NIGHTMODECHECK && !waitForTimeAfterReboot){
+/**
+ * @brief Task: check if nightmode need to be activated
+ */
+void nightmodeCheckTask(){
+  if(!waitForTimeAfterReboot){
     checkNightmode();
-    lastNightmodeCheck = millis();
   }
- 
 }
 
 
@@ -593,18 +917,17 @@ void updateStateBehavior(uint8_t state){
         } else {
           ledmatrix.setDynamicColorShiftPhase(-1);
           filterFactor = DEFAULT_SMOOTHING_FACTOR;
+          // the next update follows right after the next full second (see scheduleStateBehavior()), so the minute changes on time
           behaviorUpdatePeriod = PERIOD_TIMEVISUUPDATE;
         }
         uint8_t hours = ntp.getHours24();
         uint8_t minutes = ntp.getMinutes();
-        static uint8_t lastMinutes = 0;
-        static String timeAsString = "";
-        if(lastMinutes != minutes){
-          timeAsString = timeToString(hours, minutes);
-          lastMinutes = minutes;
+        if(isClockFaceCacheValid()){
+          showTimeFromCache(hours, minutes, maincolor_clock);
+        } else {
+          showTimeOnClock(hours, minutes, maincolor_clock);
+          drawMinuteIndicator(minutes, maincolor_clock);
         }
-        showStringOnClock(timeAsString, maincolor_clock);
-        drawMinuteIndicator(minutes, maincolor_clock);
       }
       break;
     // state diclock
@@ -674,7 +997,7 @@ void updateStateBehavior(uint8_t state){
  * 
  */
 void checkNightmode(){
-  logger.logString("Check nightmode");
+  LOG_DEBUG(logger, "Check nightmode");
   int hours = ntp.getHours24();
   int minutes = ntp.getMinutes();
   
@@ -688,12 +1011,12 @@ void checkNightmode(){
   if (startInMinutes < endInMinutes && nightModeActivated) { // Same day scenario
       if (startInMinutes < currentTimeInMinutes && currentTimeInMinutes < endInMinutes) {
           nightMode = true;
-          logger.logString("Nightmode active");
+          LOG_INFO(logger, "Nightmode active");
       }
   } else if (startInMinutes > endInMinutes && nightModeActivated) { // Overnight scenario
       if (currentTimeInMinutes >= startInMinutes || currentTimeInMinutes < endInMinutes) {
           nightMode = true;
-          logger.logString("Nightmode active");
+          LOG_INFO(logger, "Nightmode active");
       }
   }
 }
@@ -756,13 +1079,15 @@ void entryAction(uint8_t state){
       }
       break;
   }
+  // apply the update period of the new state
+  scheduleStateBehavior();
 }
 
 /**
  * @brief execute a state change to given newState
  * 
  * @param newState the new state to be changed to
- * @param persistant if true, the state will be saved to EEPROM
+ * @param persistant if true, the state will be saved to EEPROM (after the quiet period of the settings)
  */
 void stateChange(uint8_t newState, bool persistant){
   if(ledOff){
@@ -772,12 +1097,11 @@ void stateChange(uint8_t newState, bool persistant){
   ledmatrix.gridFlush();
   // set new state
   currentState = newState;
+  applyModeColor();
   entryAction(currentState);
-  logger.logString("State change to: " + stateNames[currentState]);
+  LOG_INFO(logger, "State change to: %s", stateNames[currentState].c_str());
   if(persistant){
-    // save state to EEPROM
-    EEPROM.write(ADR_STATE, currentState);
-    EEPROM.commit();
+    settings.set(&Settings::state, currentState);
   }
 }
 
@@ -786,53 +1110,92 @@ void stateChange(uint8_t newState, bool persistant){
  * 
  * Allows the control of all LEDs from external source. 
  * It will overwrite the normal program for 5 seconds.
- * A 11x11 picture can be sent as base64 encoded string to be displayed on matrix.
+ * A 11x11 picture can be sent
+ * - as base64 encoded string (form data, 4 bytes per pixel: red, green, blue, unused) or
+ * - as raw binary body with content type application/octet-stream (3 bytes per pixel: red, green, blue).
+ * Pixels are ordered row by row (index = x + y * WIDTH). Base64 data is decoded completely before the pixels are set,
+ * so invalid data does not leave a partially updated matrix.
  * 
  */
 void handleLEDDirect() {
   if (server.method() != HTTP_POST) {
     server.send(405, "text/plain", "Method Not Allowed");
-  } else {
-    String message = "POST data was:\n";
-    /*logger.logString(message);
-    delay(10);
-    for (uint8_t i = 0; i < server.args(); i++) {
-      message += " " + server.argName(i) + ": " + server.arg(i) + "\n";
-      logger.logString(server.arg(i));
-      delay(10);
-    }*/
-    if(server.args() == 1){
-      String data = String(server.arg(0));
-      int dataLength = data.length();
-      //char byteArray[dataLength];
-      //data.toCharArray(byteArray, dataLength);
-
-      // base64 decoding
-      char base64data[dataLength];
-      data.toCharArray(base64data, dataLength);
-      int base64dataLen = dataLength;
-      int decodedLength = Base64.decodedLength(base64data, base64dataLen);
-      char byteArray[decodedLength];
-      Base64.decode(byteArray, base64data, base64dataLen);
-
-      /*for(int i = 0; i < 10; i++){
-        logger.logString(String((int)(byteArray[i])));
-        delay(10);
-      }*/
-
-
-      for(int i = 0; i < dataLength; i += 4) {
-        uint8_t red = byteArray[i]; // red
-        uint8_t green = byteArray[i + 1]; // green
-        uint8_t blue = byteArray[i + 2]; // blue
-        ledmatrix.gridAddPixel((i/4) % WIDTH, (i/4) / HEIGHT, LEDMatrix::Color24bit(red, green, blue));
-      }
-      ledmatrix.drawOnMatrixInstant();
+    return;
+  }
 
-      lastLEDdirect = millis();
+  const uint8_t *pixels = NULL;
+  uint16_t numPixels = 0;
+  if (server.hasHeader("Content-Type") && server.header("Content-Type").startsWith("application/octet-stream")) {
+    // raw body is stored as argument "plain" by the webserver
+    const String& data = server.arg("plain");
+    if (data.length() % 3 == 0 && data.length() <= WIDTH * HEIGHT * 3) {
+      pixels = (const uint8_t*)data.c_str();
+      numPixels = data.length() / 3;
+    }
+  }
+  else {
+    static uint8_t decoded[WIDTH * HEIGHT * 3];
+    if (server.args() == 1 && decodeLEDDirectBase64(server.arg(0), decoded, numPixels)) {
+      pixels = decoded;
     }
-    server.send(200, "text/plain", message);
   }
+
+  if (pixels == NULL) {
+    server.send(400, "text/plain", "Invalid LED data");
+    return;
+  }
+  ledmatrix.gridSetPixelsRGB(0, pixels, numPixels);
+  ledmatrix.drawOnMatrixInstant();
+  lastLEDdirect = millis();
+  server.send(200, "text/plain", "OK");
+}
+
+/**
+ * @brief Decode base64 encoded pixels (4 bytes per pixel: red, green, blue, unused) chunk by chunk into a RGB buffer
+ * 
+ * @param data base64 encoded string
+ * @param rgb buffer for the pixels (3 bytes per pixel, WIDTH * HEIGHT pixels)
+ * @param numPixels number of decoded pixels
+ * @return true if the data is valid (complete pixels only)
+ */
+bool decodeLEDDirectBase64(const String& data, uint8_t *rgb, uint16_t &numPixels) {
+  unsigned int length = data.length();
+  numPixels = 0;
+  if (length > (unsigned int)Base64.encodedLength(WIDTH * HEIGHT * 4)) {
+    return false;
+  }
+
+  Base64Decoder decoder;
+  const char *input = data.c_str();
+  uint8_t decoded[LEDDIRECT_CHUNK_SIZE / 4 * 3 + 2];
+  uint8_t pixelBytes = 0;
+  for (unsigned int i = 0; i < length; i += LEDDIRECT_CHUNK_SIZE) {
+    unsigned int chunkLength = min(length - i, (unsigned int)LEDDIRECT_CHUNK_SIZE);
+    int decodedLength = decoder.update(decoded, input + i, chunkLength);
+    // flush the remaining characters after the last chunk
+    if (decodedLength >= 0 && i + chunkLength == length) {
+      int finalLength = decoder.final(decoded + decodedLength);
+      decodedLength = finalLength < 0 ? -1 : decodedLength + finalLength;
+    }
+    if (decodedLength < 0) {
+      return false;
+    }
+
+    for (int k = 0; k < decodedLength; k++) {
+      if (numPixels >= WIDTH * HEIGHT) {
+        return false;
+      }
+      // the 4th byte of each pixel is unused
+      if (pixelBytes < 3) {
+        rgb[numPixels * 3 + pixelBytes] = decoded[k];
+      }
+      if (++pixelBytes == 4) {
+        numPixels++;
+        pixelBytes = 0;
+      }
+    }
+  }
+  return pixelBytes == 0;
 }
 
 /**
@@ -845,7 +1208,7 @@ void handleButton(){
   // check rising edge
   if(buttonPressed == true && lastButtonState == false){
     // button press start
-    logger.logString("Button press started");
+    LOG_INFO(logger, "Button press started");
     buttonPressStart = millis();
   }
   // check falling edge
@@ -853,13 +1216,13 @@ void handleButton(){
     // button press ended
     if((millis() - buttonPressStart) > LONGPRESS){
       // longpress -> nightmode
-      logger.logString("Button press ended - longpress");
+      LOG_INFO(logger, "Button press ended - longpress");
 
       ledOff = true;
     }
     else if((millis() - buttonPressStart) > SHORTPRESS){
       // shortpress -> state change 
-      logger.logString("Button press ended - shortpress");
+      LOG_INFO(logger, "Button press ended - shortpress");
 
       if(ledOff){
         ledOff = false;
@@ -873,15 +1236,58 @@ void handleButton(){
 }
 
 /**
- * @brief Set main color
+ * @brief Get the default settings, which are used if no valid settings are stored in the EEPROM
+ *
+ * @return Settings default settings
+ */
+Settings getDefaultSettings(){
+  Settings defaults;
+  memset(&defaults, 0, sizeof(defaults));
+  defaults.nightModeStartHour = DEFAULT_NM_START_HOUR;
+  defaults.nightModeStartMin = DEFAULT_NM_START_MIN;
+  defaults.nightModeEndHour = DEFAULT_NM_END_HOUR;
+  defaults.nightModeEndMin = DEFAULT_NM_END_MIN;
+  defaults.nightModeActivated = DEFAULT_NM_ACTIVATED;
+  defaults.nightModeBrightness = DEFAULT_NM_BRIGHTNESS;
+  defaults.brightness = DEFAULT_BRIGHTNESS;
+  defaults.mainColorRed = DEFAULT_MC_RED;
+  defaults.mainColorGreen = DEFAULT_MC_GREEN;
+  defaults.mainColorBlue = DEFAULT_MC_BLUE;
+  defaults.state = st_clock;
+  defaults.colorShiftSpeed = DEFAULT_COLSHIFT_SPEED;
+  defaults.colorShiftActive = DEFAULT_COLSHIFT_ACTIVE;
+  defaults.layout = DEFAULT_LAYOUT;
+  return defaults;
+}
+
+/**
+ * @brief Set main color, if the current mode has an own color, the color of the mode is changed
  * 
  */
 void setMainColor(uint8_t red, uint8_t green, uint8_t blue){
   maincolor_clock = LEDMatrix::Color24bit(red, green, blue);
-  EEPROM.put(ADR_MC_RED, red);
-  EEPROM.put(ADR_MC_GREEN, green);
-  EEPROM.put(ADR_MC_BLUE, blue);
-  EEPROM.commit();
+  uint8_t rgb[3] = {red, green, blue};
+  if(journal.get(JOURNAL_KEY_MODECOLOR + currentState, rgb, 0) >= 0){
+    journal.set(JOURNAL_KEY_MODECOLOR + currentState, rgb, sizeof(rgb));
+    return;
+  }
+  settings.set(&Settings::mainColorRed, red);
+  settings.set(&Settings::mainColorGreen, green);
+  settings.set(&Settings::mainColorBlue, blue);
+}
+
+/**
+ * @brief Apply the own color of the current mode (see command "modecolor") or the common main color
+ * 
+ */
+void applyModeColor(){
+  uint8_t rgb[3];
+  if(journal.get(JOURNAL_KEY_MODECOLOR + currentState, rgb, sizeof(rgb)) == sizeof(rgb)){
+    maincolor_clock = LEDMatrix::Color24bit(rgb[0], rgb[1], rgb[2]);
+  }
+  else{
+    loadMainColorFromEEPROM();
+  }
 }
 
 /**
@@ -889,9 +1295,9 @@ void setMainColor(uint8_t red, uint8_t green, uint8_t blue){
  * 
 */
 void loadMainColorFromEEPROM(){
-  uint8_t red = EEPROM.read(ADR_MC_RED);
-  uint8_t green = EEPROM.read(ADR_MC_GREEN);
-  uint8_t blue = EEPROM.read(ADR_MC_BLUE);
+  uint8_t red = settings.get().mainColorRed;
+  uint8_t green = settings.get().mainColorGreen;
+  uint8_t blue = settings.get().mainColorBlue;
   if(int(red) + int(green) + int(blue) < 50){
     maincolor_clock = colors24bit[2];
   }else{
@@ -904,11 +1310,10 @@ void loadMainColorFromEEPROM(){
  * 
  */
 void loadCurrentStateFromEEPROM(){
-  currentState = EEPROM.read(ADR_STATE);
+  currentState = settings.get().state;
   if(currentState >= NUM_STATES){
     currentState = st_clock;
-    EEPROM.write(ADR_STATE, currentState);
-    EEPROM.commit();
+    settings.set(&Settings::state, currentState);
   }
 }
 
@@ -917,18 +1322,18 @@ void loadCurrentStateFromEEPROM(){
  */
 void loadNightmodeSettingsFromEEPROM()
 {
-  nightModeStartHour = EEPROM.read(ADR_NM_START_H);
-  nightModeStartMin = EEPROM.read(ADR_NM_START_M);
-  nightModeEndHour = EEPROM.read(ADR_NM_END_H);
-  nightModeEndMin = EEPROM.read(ADR_NM_END_M);
-  nightModeActivated = EEPROM.read(ADR_NM_ACTIVATED);
+  nightModeStartHour = settings.get().nightModeStartHour;
+  nightModeStartMin = settings.get().nightModeStartMin;
+  nightModeEndHour = settings.get().nightModeEndHour;
+  nightModeEndMin = settings.get().nightModeEndMin;
+  nightModeActivated = settings.get().nightModeActivated;
   if(nightModeStartHour < 0 || nightModeStartHour > 23) nightModeStartHour = 22;
   if(nightModeStartMin < 0 || nightModeStartMin > 59) nightModeStartMin = 0;
   if(nightModeEndHour < 0 || nightModeEndHour > 23) nightModeEndHour = 7;
   if(nightModeEndMin < 0 || nightModeEndMin > 59) nightModeEndMin = 0;
-  logger.logString("Nightmode activated: " + String(nightModeActivated));
-  logger.logString("Nightmode starts at: " + String(nightModeStartHour) + ":" + String(nightModeStartMin));
-  logger.logString("Nightmode ends at: " + String(nightModeEndHour) + ":" + String(nightModeEndMin));
+  LOG_INFO(logger, "Nightmode activated: %d", nightModeActivated);
+  LOG_INFO(logger, "Nightmode starts at: %d:%d", nightModeStartHour, nightModeStartMin);
+  LOG_INFO(logger, "Nightmode ends at: %d:%d", nightModeEndHour, nightModeEndMin);
 }
 
 /**
@@ -938,9 +1343,9 @@ void loadNightmodeSettingsFromEEPROM()
  */
 void loadBrightnessSettingsFromEEPROM()
 {
-  brightness = EEPROM.read(ADR_BRIGHTNESS);
+  brightness = settings.get().brightness;
   if(brightness < 10) brightness = 10;
-  logger.logString("Brightness: " + String(brightness));
+  LOG_INFO(logger, "Brightness: %d", brightness);
   ledmatrix.setBrightness(brightness);
 }
 
@@ -950,11 +1355,11 @@ void loadBrightnessSettingsFromEEPROM()
  */
 void loadColorShiftStateFromEEPROM()
 {
-  dynColorShiftSpeed = EEPROM.read(ADR_COLSHIFTSPEED);
+  dynColorShiftSpeed = settings.get().colorShiftSpeed;
   if (dynColorShiftSpeed == 0) dynColorShiftSpeed = 1;
-  logger.logString("ColorShiftSpeed: " + String(dynColorShiftSpeed));
-  dynColorShiftActive = EEPROM.read(ADR_COLSHIFTACTIVE);
-  logger.logString("ColorShiftActive: " + String(dynColorShiftActive));
+  LOG_INFO(logger, "ColorShiftSpeed: %d", dynColorShiftSpeed);
+  dynColorShiftActive = settings.get().colorShiftActive;
+  LOG_INFO(logger, "ColorShiftActive: %d", dynColorShiftActive);
 }
 
 /**
@@ -963,220 +1368,579 @@ void loadColorShiftStateFromEEPROM()
  */
 void loadNightmodeBrightnessFromEEPROM()
 {
-  nightModeBrightness = EEPROM.read(ADR_NM_BRIGHTNESS);
-  logger.logString("Night mode brightness: " + String(nightModeBrightness));
+  nightModeBrightness = settings.get().nightModeBrightness;
+  LOG_INFO(logger, "Night mode brightness: %d", nightModeBrightness);
+}
+
+/**
+ * @brief Load the language layout from EEPROM
+ *
+ * the layout was added later, so an unknown value falls back to the default layout
+ */
+void loadLayoutFromEEPROM()
+{
+  currentLayout = settings.get().layout;
+  if(!isLayoutAvailable(currentLayout)){
+    currentLayout = DEFAULT_LAYOUT;
+    settings.set(&Settings::layout, currentLayout);
+  }
+  LOG_INFO(logger, "Layout: %s", getLayoutName(currentLayout));
+}
+
+/**
+ * @brief Switch the language layout of the clock face and save it to EEPROM
+ *
+ * @param layout index of layout (ClockLayout)
+ * @return true if layout was changed
+ */
+bool setLayout(uint8_t layout){
+  if(!isLayoutAvailable(layout)){
+    return false;
+  }
+  if(layout != currentLayout){
+    currentLayout = layout;
+    settings.set(&Settings::layout, currentLayout);
+    // cached faces belong to the old layout
+    if(isClockFaceCacheValid()){
+      buildClockFaceCache();
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Register all commands of the /cmd route
+ */
+void setupCommands(){
+  commands.addCommand("led", cmdLED);
+  commands.addCommand("mode", cmdMode);
+  commands.addCommand("ledoff", cmdLEDOff);
+  commands.addCommand("nightmodeactivated", cmdNightmodeActivated);
+  commands.addCommand("setting", cmdSetting);
+  commands.addCommand("lang", cmdLang);
+  commands.addCommand("resetwifi", cmdResetWifi);
+  commands.addCommand("stateautochange", cmdStateAutoChange);
+  commands.addCommand("colorshift", cmdColorShift);
+  commands.addCommand("modecolor", cmdModeColor);
+  commands.addCommand("reboot", cmdReboot);
+  commands.addCommand("tetris", cmdTetris);
+  commands.addCommand("snake", cmdSnake);
+  commands.addCommand("pong", cmdPong);
 }
 
 /**
  * @brief Handler for handling commands sent to "/cmd" url
  * 
+ * A request can contain several commands (e.g. /cmd?setting=22-0-7-0-40-1-0&lang=german). All commands
+ * are checked first, if one is unknown or has an invalid value, nothing is changed (400 Bad Request).
+ * Otherwise they are executed in the given order, the changed settings are written together after the quiet period
+ * of the settings store.
  */
 void handleCommand() {
-  // receive command and handle accordingly
-  for (uint8_t i = 0; i < server.args(); i++) {
-    String log_str = "Command received: " + server.argName(i) + " " + server.arg(i);
-    logger.logString(log_str);
+  uint8_t numCommands = server.args();
+  CommandHandler handlers[MAX_COMMANDS_PER_REQUEST];
+  char message[64];
+
+  if(numCommands > MAX_COMMANDS_PER_REQUEST){
+    server.send(400, "text/plain", "Too many commands");
+    return;
   }
-  
-  if (server.argName(0) == "led") // the parameter which was sent to this server is led color
-  {
-    String colorstr = server.arg(0) + "-";
-    String redstr = split(colorstr, '-', 0);
-    String greenstr= split(colorstr, '-', 1);
-    String bluestr = split(colorstr, '-', 2);
-    logger.logString(colorstr);
-    logger.logString("r: " + String(redstr.toInt()));
-    logger.logString("g: " + String(greenstr.toInt()));
-    logger.logString("b: " + String(bluestr.toInt()));
-    // set new main color
-    setMainColor(redstr.toInt(), greenstr.toInt(), bluestr.toInt());
-  }
-  else if (server.argName(0) == "mode") // the parameter which was sent to this server is mode change
-  {
-    String modestr = server.arg(0);
-    logger.logString("Mode change via Webserver to: " + modestr);
-    // set current mode/state accordant sent mode
-    if(modestr == "clock"){
-      stateChange(st_clock, true);
-    }
-    else if(modestr == "diclock"){
-      stateChange(st_diclock, true);
-    }
-    else if(modestr == "spiral"){
-      stateChange(st_spiral, true);
+
+  // check all commands before anything is changed
+  for(uint8_t i = 0; i < numCommands; i++){
+    const char *name = server.argName(i).c_str();
+    const char *value = server.arg(i).c_str();
+    LOG_INFO(logger, "Command received: %s %s", name, value);
+    handlers[i] = commands.find(name);
+    if(handlers[i] == NULL){
+      snprintf(message, sizeof(message), "Unknown command: %s", name);
     }
-    else if(modestr == "tetris"){
-      stateChange(st_tetris, true);
+    else if(!handlers[i](value, false)){
+      snprintf(message, sizeof(message), "Invalid value for command: %s", name);
     }
-    else if(modestr == "snake"){
-      stateChange(st_snake, true);
+    else{
+      continue;
     }
-    else if(modestr == "pingpong"){
-      stateChange(st_pingpong, true);
-    } 
-  }
-  else if(server.argName(0) == "ledoff"){
-    String modestr = server.arg(0);
-    logger.logString("LED off change via Webserver to: " + modestr);
-    if(modestr == "1") ledOff = true;
-    else ledOff = false;
-  }
-  else if(server.argName(0) == "nightmodeactivated"){
-    String modestr = server.arg(0);
-    logger.logString("nightModeActivated change via Webserver to: " + modestr);
-    if(modestr == "1") nightModeActivated = true;
-    else nightModeActivated = false;
-    EEPROM.write(ADR_NM_ACTIVATED, nightModeActivated);
-    EEPROM.commit();
-    checkNightmode();
+    LOG_WARNING(logger, "%s", message);
+    server.send(400, "text/plain", message);
+    return;
   }
-  else if(server.argName(0) == "setting"){
-    String timestr = server.arg(0) + "-";
-    logger.logString("Nightmode setting change via Webserver to: " + timestr);
-    nightModeStartHour = split(timestr, '-', 0).toInt();
-    nightModeStartMin = split(timestr, '-', 1).toInt();
-    nightModeEndHour = split(timestr, '-', 2).toInt();
-    nightModeEndMin = split(timestr, '-', 3).toInt();
-    brightness = split(timestr, '-', 4).toInt();
-    dynColorShiftSpeed = split(timestr, '-', 5).toInt();
-    nightModeBrightness = split(timestr, '-', 6).toInt();
-    if(nightModeStartHour < 0 || nightModeStartHour > 23) nightModeStartHour = 22;
-    if(nightModeStartMin < 0 || nightModeStartMin > 59) nightModeStartMin = 0;
-    if(nightModeEndHour < 0 || nightModeEndHour > 23) nightModeEndHour = 7;
-    if(nightModeEndMin < 0 || nightModeEndMin > 59) nightModeEndMin = 0;
-    if(brightness < 10) brightness = 10;
-    if(dynColorShiftSpeed == 0) dynColorShiftSpeed = 1;
-    EEPROM.write(ADR_NM_START_H, nightModeStartHour);
-    EEPROM.write(ADR_NM_START_M, nightModeStartMin);
-    EEPROM.write(ADR_NM_END_H, nightModeEndHour);
-    EEPROM.write(ADR_NM_END_M, nightModeEndMin);
-    EEPROM.write(ADR_BRIGHTNESS, brightness);
-    EEPROM.write(ADR_COLSHIFTSPEED, dynColorShiftSpeed);
-    EEPROM.write(ADR_NM_BRIGHTNESS, nightModeBrightness);
-    EEPROM.commit();
-    logger.logString("Nightmode starts at: " + String(nightModeStartHour) + ":" + String(nightModeStartMin));
-    logger.logString("Nightmode ends at: " + String(nightModeEndHour) + ":" + String(nightModeEndMin));
-    logger.logString("Brightness: " + String(brightness));
-    logger.logString("ColorShiftSpeed: " + String(dynColorShiftSpeed));
-    logger.logString("Night mode brightness: " + String(nightModeBrightness));
-    ledmatrix.setBrightness(brightness);
-    lastNightmodeCheck = millis()  - PERIOD_NIGHTMODECHECK;
+
+  for(uint8_t i = 0; i < numCommands; i++){
+    handlers[i](server.arg(i).c_str(), true);
   }
-  else if (server.argName(0) == "resetwifi"){
-    wifiManager.resetSettings();
-    // run LED test.
-    for(int r = 0; r < HEIGHT; r++){
-      for(int c = 0; c < WIDTH; c++){
-        matrix.fillScreen(0);
-        matrix.drawPixel(c, r, LEDMatrix::color24to16bit(colors24bit[2]));
-        matrix.show();
-        delay(10); 
-        }
-    }
-    
-    // clear Matrix
-    matrix.fillScreen(0);
-    matrix.show();
-    delay(200);
+  server.send(204, "text/plain", "No Content"); // this page doesn't send back content --> 204
+
+  if(rebootRequested){
+    settings.commit();
+    logger.flush();
+    delay(1000);
+    ESP.restart();
   }
-  else if(server.argName(0) == "stateautochange"){
-    String modestr = server.arg(0);
-    logger.logString("stateAutoChange change via Webserver to: " + modestr);
-    if(modestr == "1") stateAutoChange = true;
-    else stateAutoChange = false;
-  }
-  else if(server.argName(0) == "tetris"){
-    String cmdstr = server.arg(0);
-    logger.logString("Tetris cmd via Webserver to: " + cmdstr);
-    if(cmdstr == "up"){
-      mytetris.ctrlUp();
-    }
-    else if(cmdstr == "left"){
-      mytetris.ctrlLeft();
-    }
-    else if(cmdstr == "right"){
-      mytetris.ctrlRight();
-    }
-    else if(cmdstr == "down"){
-      mytetris.ctrlDown();
+}
+
+/**
+ * @brief Parse numbers separated by the given character (e.g. "255-128-0")
+ * 
+ * @param str string to parse
+ * @param separator separating character
+ * @param values array for the parsed numbers
+ * @param count max. number of values
+ * @return uint8_t number of parsed values, 0 if the string contains anything else than up to count numbers with
+ * separators in between (e.g. "1-2-3xyz" or more than count numbers)
+ */
+uint8_t parseNumbers(const char *str, char separator, long *values, uint8_t count){
+  uint8_t num = 0;
+  while(num < count){
+    char *end;
+    values[num] = strtol(str, &end, 10);
+    if(end == str){
+      return 0;
     }
-    else if(cmdstr == "play"){
-      mytetris.ctrlStart();
+    num++;
+    if(*end == '\0'){
+      break;
     }
-    else if(cmdstr == "pause"){
-      mytetris.ctrlPlayPause();
+    if(*end != separator || num == count){
+      return 0;
     }
+    str = end + 1;
   }
-  else if(server.argName(0) == "snake"){
-    String cmdstr = server.arg(0);
-    logger.logString("Snake cmd via Webserver to: " + cmdstr);
-    if(cmdstr == "up"){
-      mysnake.ctrlUp();
-    }
-    else if(cmdstr == "left"){
-      mysnake.ctrlLeft();
-    }
-    else if(cmdstr == "right"){
-      mysnake.ctrlRight();
-    }
-    else if(cmdstr == "down"){
-      mysnake.ctrlDown();
-    }
-    else if(cmdstr == "new"){
-      mysnake.initGame();
-    }
+  return num;
+}
+
+/**
+ * @brief Parse a flag, which is sent as "0" or "1"
+ * 
+ * @param str string to parse
+ * @param flag parsed flag
+ * @return true if the string is a valid flag
+ */
+bool parseFlag(const char *str, bool &flag){
+  if(strcmp(str, "0") != 0 && strcmp(str, "1") != 0){
+    return false;
   }
-  else if(server.argName(0) == "pong"){
-    String cmdstr = server.arg(0);
-    logger.logString("Pong cmd via Webserver to: " + cmdstr);
-    if(cmdstr == "up"){
-      mypong.ctrlUp(1);
+  flag = (str[0] == '1');
+  return true;
+}
+
+/**
+ * @brief Command "led": set the main color, value "<red>-<green>-<blue>"
+ */
+bool cmdLED(const char *value, bool apply){
+  long rgb[3];
+  if(parseNumbers(value, '-', rgb, 3) != 3){
+    return false;
+  }
+  for(uint8_t i = 0; i < 3; i++){
+    if(rgb[i] < 0 || rgb[i] > 255) return false;
+  }
+  if(apply){
+    LOG_INFO(logger, "Main color r: %ld, g: %ld, b: %ld", rgb[0], rgb[1], rgb[2]);
+    setMainColor(rgb[0], rgb[1], rgb[2]);
+  }
+  return true;
+}
+
+/**
+ * @brief Command "mode": change the state, value is the name of the state in lower case (e.g. "clock")
+ */
+bool cmdMode(const char *value, bool apply){
+  static const char *const modeNames[] = {"clock", "diclock", "spiral", "tetris", "snake", "pingpong"};
+  for(uint8_t state = 0; state < NUM_STATES; state++){
+    if(strcmp(value, modeNames[state]) == 0){
+      if(apply){
+        LOG_INFO(logger, "Mode change via Webserver to: %s", value);
+        stateChange(state, true);
+      }
+      return true;
     }
-    else if(cmdstr == "down"){
-      mypong.ctrlDown(1);
+  }
+  return false;
+}
+
+/**
+ * @brief Command "ledoff": switch off all LEDs, value "0" or "1"
+ */
+bool cmdLEDOff(const char *value, bool apply){
+  bool flag;
+  if(!parseFlag(value, flag)){
+    return false;
+  }
+  if(apply){
+    LOG_INFO(logger, "LED off change via Webserver to: %d", flag);
+    ledOff = flag;
+  }
+  return true;
+}
+
+/**
+ * @brief Command "nightmodeactivated": enable the nightmode, value "0" or "1"
+ */
+bool cmdNightmodeActivated(const char *value, bool apply){
+  bool flag;
+  if(!parseFlag(value, flag)){
+    return false;
+  }
+  if(apply){
+    LOG_INFO(logger, "nightModeActivated change via Webserver to: %d", flag);
+    nightModeActivated = flag;
+    settings.set(&Settings::nightModeActivated, nightModeActivated);
+    checkNightmode();
+  }
+  return true;
+}
+
+/**
+ * @brief Command "setting": nightmode and brightness settings,
+ * value "<start hour>-<start min>-<end hour>-<end min>-<brightness>-<colorshift speed>-<nightmode brightness>"
+ */
+bool cmdSetting(const char *value, bool apply){
+  long values[7];
+  if(parseNumbers(value, '-', values, 7) != 7){
+    return false;
+  }
+  for(uint8_t i = 0; i < 7; i++){
+    if(values[i] < 0 || values[i] > 255) return false;
+  }
+  if(!apply){
+    return true;
+  }
+  nightModeStartHour = values[0];
+  nightModeStartMin = values[1];
+  nightModeEndHour = values[2];
+  nightModeEndMin = values[3];
+  brightness = values[4];
+  dynColorShiftSpeed = values[5];
+  nightModeBrightness = values[6];
+  if(nightModeStartHour > 23) nightModeStartHour = 22;
+  if(nightModeStartMin > 59) nightModeStartMin = 0;
+  if(nightModeEndHour > 23) nightModeEndHour = 7;
+  if(nightModeEndMin > 59) nightModeEndMin = 0;
+  if(brightness < 10) brightness = 10;
+  if(dynColorShiftSpeed == 0) dynColorShiftSpeed = 1;
+  settings.set(&Settings::nightModeStartHour, nightModeStartHour);
+  settings.set(&Settings::nightModeStartMin, nightModeStartMin);
+  settings.set(&Settings::nightModeEndHour, nightModeEndHour);
+  settings.set(&Settings::nightModeEndMin, nightModeEndMin);
+  settings.set(&Settings::brightness, brightness);
+  settings.set(&Settings::colorShiftSpeed, dynColorShiftSpeed);
+  settings.set(&Settings::nightModeBrightness, nightModeBrightness);
+  LOG_INFO(logger, "Nightmode starts at: %d:%d, ends at: %d:%d", nightModeStartHour, nightModeStartMin, nightModeEndHour, nightModeEndMin);
+  LOG_INFO(logger, "Brightness: %d, night mode: %d, ColorShiftSpeed: %d", brightness, nightModeBrightness, dynColorShiftSpeed);
+  ledmatrix.setBrightness(brightness);
+  scheduler.schedule(taskNightmodeCheck, 0);
+  return true;
+}
+
+/**
+ * @brief Command "lang": change the language layout, value is the name of the layout (e.g. "german")
+ */
+bool cmdLang(const char *value, bool apply){
+  int8_t layout = findLayout(value);
+  if(layout < 0){
+    LOG_WARNING(logger, "Layout not available: %s", value);
+    return false;
+  }
+  if(apply){
+    LOG_INFO(logger, "Layout change via Webserver to: %s", value);
+    setLayout(layout);
+  }
+  return true;
+}
+
+/**
+ * @brief Command "resetwifi": delete the WiFi credentials and run the LED test, no value
+ */
+bool cmdResetWifi(const char *value, bool apply){
+  if(!apply){
+    return true;
+  }
+  LOG_INFO(logger, "Reset WiFi settings via Webserver");
+  wifiManager.resetSettings();
+  // run LED test.
+  for(int r = 0; r < HEIGHT; r++){
+    for(int c = 0; c < WIDTH; c++){
+      matrix.fillScreen(0);
+      matrix.drawPixel(c, r, LEDMatrix::color24to16bit(colors24bit[2]));
+      matrix.show();
+      delay(10); 
+      }
+  }
+  
+  // clear Matrix
+  matrix.fillScreen(0);
+  matrix.show();
+  ledmatrix.forceRedraw();
+  delay(200);
+  return true;
+}
+
+/**
+ * @brief Command "stateautochange": enable the automatic state change, value "0" or "1"
+ */
+bool cmdStateAutoChange(const char *value, bool apply){
+  bool flag;
+  if(!parseFlag(value, flag)){
+    return false;
+  }
+  if(apply){
+    LOG_INFO(logger, "stateAutoChange change via Webserver to: %d", flag);
+    stateAutoChange = flag;
+  }
+  return true;
+}
+
+/**
+ * @brief Command "colorshift": enable the dynamic color shift, value "0" or "1"
+ */
+bool cmdColorShift(const char *value, bool apply){
+  bool flag;
+  if(!parseFlag(value, flag)){
+    return false;
+  }
+  if(apply){
+    LOG_INFO(logger, "ColorShift change via Webserver to: %d", flag);
+    dynColorShiftActive = flag;
+    settings.set(&Settings::colorShiftActive, dynColorShiftActive);
+  }
+  return true;
+}
+
+/**
+ * @brief Command "modecolor": give the current mode an own main color (starting with the current color), value "0" or "1".
+ * While enabled, the command "led" changes the color of the mode.
+ */
+bool cmdModeColor(const char *value, bool apply){
+  bool flag;
+  if(!parseFlag(value, flag)){
+    return false;
+  }
+  if(apply){
+    LOG_INFO(logger, "Own color of mode %s: %d", stateNames[currentState].c_str(), flag);
+    if(flag){
+      uint8_t rgb[3] = {(uint8_t)(maincolor_clock >> 16), (uint8_t)(maincolor_clock >> 8), (uint8_t)maincolor_clock};
+      journal.set(JOURNAL_KEY_MODECOLOR + currentState, rgb, sizeof(rgb));
     }
-    else if(cmdstr == "new"){
-      mypong.initGame(1);
+    else{
+      journal.remove(JOURNAL_KEY_MODECOLOR + currentState);
     }
+    applyModeColor();
   }
-  else if(server.argName(0) == "reboot"){
-    logger.logString("Reboot via Webserver");
-    server.send(204, "text/plain", "No Content"); // this page doesn't send back content --> 204
-    delay(1000);
-    ESP.restart();
+  return true;
+}
+
+/**
+ * @brief Command "reboot": restart after the response was sent, no value
+ */
+bool cmdReboot(const char *value, bool apply){
+  if(apply){
+    LOG_INFO(logger, "Reboot via Webserver");
+    rebootRequested = true;
   }
-  else if(server.argName(0) == "colorshift"){
-    Serial.println("ColorShift change via Webserver");
-    String str = server.arg(0);
-    if(str == "1") dynColorShiftActive = true;
-    else dynColorShiftActive = false;
-    EEPROM.write(ADR_COLSHIFTACTIVE, dynColorShiftActive);
-    EEPROM.commit();
+  return true;
+}
+
+/**
+ * @brief Command "tetris": control of the game, value "up", "left", "right", "down", "play" or "pause"
+ */
+bool cmdTetris(const char *value, bool apply){
+  if(strcmp(value, "up") == 0){
+    if(apply) mytetris.ctrlUp();
   }
-  server.send(204, "text/plain", "No Content"); // this page doesn't send back content --> 204
+  else if(strcmp(value, "left") == 0){
+    if(apply) mytetris.ctrlLeft();
+  }
+  else if(strcmp(value, "right") == 0){
+    if(apply) mytetris.ctrlRight();
+  }
+  else if(strcmp(value, "down") == 0){
+    if(apply) mytetris.ctrlDown();
+  }
+  else if(strcmp(value, "play") == 0){
+    if(apply) mytetris.ctrlStart();
+  }
+  else if(strcmp(value, "pause") == 0){
+    if(apply) mytetris.ctrlPlayPause();
+  }
+  else{
+    return false;
+  }
+  return true;
 }
 
 /**
- * @brief Splits a string at given character and return specified element
- * 
- * @param s string to split
- * @param parser separating character
- * @param index index of the element to return
- * @return String 
+ * @brief Command "snake": control of the game, value "up", "left", "right", "down" or "new"
+ */
+bool cmdSnake(const char *value, bool apply){
+  if(strcmp(value, "up") == 0){
+    if(apply) mysnake.ctrlUp();
+  }
+  else if(strcmp(value, "left") == 0){
+    if(apply) mysnake.ctrlLeft();
+  }
+  else if(strcmp(value, "right") == 0){
+    if(apply) mysnake.ctrlRight();
+  }
+  else if(strcmp(value, "down") == 0){
+    if(apply) mysnake.ctrlDown();
+  }
+  else if(strcmp(value, "new") == 0){
+    if(apply) mysnake.initGame();
+  }
+  else{
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Command "pong": control of the game (player 1), value "up", "down" or "new"
  */
-String split(String s, char parser, int index) {
-  String rs="";
-  int parserCnt=0;
-  int rFromIndex=0, rToIndex=-1;
-  while (index >= parserCnt) {
-    rFromIndex = rToIndex+1;
-    rToIndex = s.indexOf(parser,rFromIndex);
-    if (index == parserCnt) {
-      if (rToIndex == 0 || rToIndex == -1) return "";
-      return s.substring(rFromIndex,rToIndex);
-    } else parserCnt++;
-  }
-  return rs;
+bool cmdPong(const char *value, bool apply){
+  if(strcmp(value, "up") == 0){
+    if(apply) mypong.ctrlUp(1);
+  }
+  else if(strcmp(value, "down") == 0){
+    if(apply) mypong.ctrlDown(1);
+  }
+  else if(strcmp(value, "new") == 0){
+    if(apply) mypong.initGame(1);
+  }
+  else{
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Handler for the event stream, sends the complete UI state to the new client,
+ * afterwards only changes are sent (see eventsTask())
+ *
+ */
+void handleEvents() {
+  int8_t client = events.subscribe();
+  if(client >= 0){
+    char json[UI_STATE_JSON_SIZE];
+    formatUIState(json, sizeof(json), getUIState(), NULL);
+    events.send(client, "state", json);
+    LOG_INFO(logger, "Event client connected (%u clients)", events.getNumClients());
+  }
+}
+
+/**
+ * @brief Collect the current state shown in the web UI
+ *
+ * @return UIState
+ */
+UIState getUIState(){
+  UIState ui;
+  ui.state = currentState;
+  ui.stateAutoChange = stateAutoChange;
+  ui.ledOff = ledOff;
+  ui.nightModeActivated = nightModeActivated;
+  ui.nightModeStartHour = nightModeStartHour;
+  ui.nightModeStartMin = nightModeStartMin;
+  ui.nightModeEndHour = nightModeEndHour;
+  ui.nightModeEndMin = nightModeEndMin;
+  ui.brightness = brightness;
+  ui.nightModeBrightness = nightModeBrightness;
+  ui.colorshift = dynColorShiftActive;
+  ui.colorshiftspeed = dynColorShiftSpeed;
+  ui.layout = currentLayout;
+  ui.color = maincolor_clock;
+  return ui;
+}
+
+/**
+ * @brief Write the UI state as JSON object (all values as strings, as expected by the web UI)
+ *
+ * @param json writer for the response or a buffer
+ * @param ui state to be written
+ * @param previous if not NULL, only fields which differ from this state are written
+ * @return uint8_t number of written fields
+ */
+uint8_t writeUIState(JsonWriter &json, const UIState &ui, const UIState *previous){
+  char value[16];
+  uint8_t fields = 0;
+  json.beginObject();
+  if(!previous || previous->state != ui.state){
+    json.field("mode", stateNames[ui.state].c_str());
+    snprintf(value, sizeof(value), "%u", ui.state);
+    json.field("modeid", value);
+    fields += 2;
+  }
+  if(!previous || previous->stateAutoChange != ui.stateAutoChange){
+    json.field("stateAutoChange", ui.stateAutoChange ? "1" : "0");
+    fields++;
+  }
+  if(!previous || previous->ledOff != ui.ledOff){
+    json.field("ledoff", ui.ledOff ? "1" : "0");
+    fields++;
+  }
+  if(!previous || previous->nightModeActivated != ui.nightModeActivated){
+    json.field("nightModeActivated", ui.nightModeActivated ? "1" : "0");
+    fields++;
+  }
+  if(!previous || previous->nightModeStartHour != ui.nightModeStartHour || previous->nightModeStartMin != ui.nightModeStartMin){
+    snprintf(value, sizeof(value), "%02u-%02u", ui.nightModeStartHour, ui.nightModeStartMin);
+    json.field("nightModeStart", value);
+    fields++;
+  }
+  if(!previous || previous->nightModeEndHour != ui.nightModeEndHour || previous->nightModeEndMin != ui.nightModeEndMin){
+    snprintf(value, sizeof(value), "%02u-%02u", ui.nightModeEndHour, ui.nightModeEndMin);
+    json.field("nightModeEnd", value);
+    fields++;
+  }
+  if(!previous || previous->brightness != ui.brightness){
+    snprintf(value, sizeof(value), "%u", ui.brightness);
+    json.field("brightness", value);
+    fields++;
+  }
+  if(!previous || previous->nightModeBrightness != ui.nightModeBrightness){
+    snprintf(value, sizeof(value), "%u", ui.nightModeBrightness);
+    json.field("nightModeBrightness", value);
+    fields++;
+  }
+  if(!previous || previous->colorshift != ui.colorshift){
+    json.field("colorshift", ui.colorshift ? "1" : "0");
+    fields++;
+  }
+  if(!previous || previous->colorshiftspeed != ui.colorshiftspeed){
+    snprintf(value, sizeof(value), "%u", ui.colorshiftspeed);
+    json.field("colorshiftspeed", value);
+    fields++;
+  }
+  if(!previous || previous->layout != ui.layout){
+    json.field("lang", getLayoutName(ui.layout));
+    fields++;
+  }
+  if(!previous || previous->color != ui.color){
+    snprintf(value, sizeof(value), "%u-%u-%u", (unsigned)(ui.color >> 16 & 0xff), (unsigned)(ui.color >> 8 & 0xff), (unsigned)(ui.color & 0xff));
+    json.field("color", value);
+    fields++;
+  }
+  json.endObject();
+  return fields;
+}
+
+/**
+ * @brief Format the UI state as JSON object into a buffer (see writeUIState())
+ *
+ * @param buffer buffer for the JSON object
+ * @param size size of the buffer (UI_STATE_JSON_SIZE)
+ * @param ui state to be formatted
+ * @param previous if not NULL, only fields which differ from this state are written
+ * @return size_t length of the JSON object (0 if there are no changes)
+ */
+size_t formatUIState(char *buffer, size_t size, const UIState &ui, const UIState *previous){
+  JsonWriter json(buffer, size);
+  if(writeUIState(json, ui, previous) == 0){
+    buffer[0] = '\0';
+    return 0;
+  }
+  json.end();
+  return strlen(buffer);
 }
 
 /**
@@ -1193,47 +1957,42 @@ void handleDataRequest() {
   
   if (server.argName(0) == "key") // the parameter which was sent to this server is led color
   {
-    String message = "{";
-    String keystr = server.arg(0);
+    const String &keystr = server.arg(0);
+    JsonWriter json(&server);
+    json.begin(200);
     if(keystr == "mode"){
-      message += "\"mode\":\"" + stateNames[currentState] + "\"";
-      message += ",";
-      message += "\"modeid\":\"" + String(currentState) + "\"";
-      message += ",";
-      message += "\"stateAutoChange\":\"" + String(stateAutoChange) + "\"";
-      message += ",";
-      message += "\"ledoff\":\"" + String(ledOff) + "\"";
-      message += ",";
-      message += "\"nightModeActivated\":\"" + String(nightModeActivated) + "\"";
-      message += ",";
-      message += "\"nightModeStart\":\"" + leadingZero2Digit(nightModeStartHour) + "-" + leadingZero2Digit(nightModeStartMin) + "\"";
-      message += ",";
-      message += "\"nightModeEnd\":\"" + leadingZero2Digit(nightModeEndHour) + "-" + leadingZero2Digit(nightModeEndMin) + "\"";
-      message += ",";
-      message += "\"brightness\":\"" + String(brightness) + "\"";
-      message += ",";
-      message += "\"nightModeBrightness\":\"" + String(nightModeBrightness) + "\"";
-      message += ",";
-      message += "\"colorshift\":\"" + String(dynColorShiftActive) + "\"";
-      message += ",";
-      message += "\"colorshiftspeed\":\"" + String(dynColorShiftSpeed) + "\"";
+      writeUIState(json, getUIState(), NULL);
+    }
+#if PERF_ENABLED
+    else if(keystr == "perf"){
+      // durations in us since boot or the last reset (/data?key=perf&reset=1)
+      json.beginObject();
+      json.field("cpuMHz", ESP.getCpuFreqMHz());
+      json.key("sections");
+      json.beginArray();
+      for(int8_t i = 0; i < perf.getNumSections(); i++){
+        json.beginObject();
+        json.field("name", perf.getName(i));
+        json.field("count", perf.getCount(i));
+        json.field("min", perf.getMin(i));
+        json.field("avg", perf.getAvg(i));
+        json.field("max", perf.getMax(i));
+        json.field("p50", perf.getPercentile(i, 50));
+        json.field("p99", perf.getPercentile(i, 99));
+        json.endObject();
+      }
+      json.endArray();
+      json.endObject();
+      if(server.hasArg("reset")){
+        perf.reset();
+      }
+    }
+#endif
+    else{
+      json.beginObject();
+      json.endObject();
     }
-    message += "}";
-    server.send(200, "application/json", message);
+    json.end();
   }
 }
 
-/**
- * @brief Convert Integer to String with leading zero
- * 
- * @param value 
- * @return String 
- */
-String leadingZero2Digit(int value){
-  String msg = "";
-  if(value < 10){
-    msg = "0";
-  }
-  msg += String(value);
-  return msg;
-}
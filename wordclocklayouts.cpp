@@ -0,0 +1,856 @@
+/**
+ * @file wordclocklayouts.cpp
+ * @brief Word tables of all supported languages (front plate layouts) of the word clock
+ * 
+ * Each layout consists of a list of words (position on the front plate), the words for 
+ * each 5 minute step, the words for the hours and a function which builds the sentence for a given time.
+ * 
+ */
+
+#include "wordclocklayouts.h"
+
+/**
+ * @brief Append the given words (PROGMEM list, NO_WORD entries are skipped) to the word list
+ * 
+ * @param table list of words in PROGMEM
+ * @param count number of entries in table
+ * @param words list of words
+ * @param numWords number of words in the list
+ * @return uint8_t new number of words in the list
+ */
+static uint8_t appendWords(const uint8_t *table, uint8_t count, uint8_t *words, uint8_t numWords){
+  for(uint8_t i = 0; i < count; i++){
+    uint8_t word = pgm_read_byte(&table[i]);
+    if(word != NO_WORD){
+      words[numWords++] = word;
+    }
+  }
+  return numWords;
+}
+
+
+namespace german {
+
+// letters of the layout (row by row)
+//   ESPISTAFUNF
+//   VIERTELZEHN
+//   ZWANZIGUVOR
+//   TECHNICNACH
+//   HALBMELFUNF
+//   XCONTROLLER
+//   EINSEAWZWEI
+//   DREITUMVIER
+//   SECHSQYACHT
+//   SIEBENZWOLF
+//   ZEHNEUNJUHR
+
+// words on the clock (index into clockWords)
+enum ClockWord {
+  W_ES, W_IST, W_FUNF_M, W_VIERTEL, W_ZEHN_M, W_ZWANZIG, W_VOR, W_NACH, W_HALB, W_ELF, W_FUNF_H,
+  W_EIN, W_EINS, W_ZWEI, W_DREI, W_VIER_H, W_SECHS, W_ACHT, W_SIEBEN, W_ZWOLF, W_ZEHN_H, W_NEUN,
+  W_UHR
+};
+
+// position of each word in the letters of the layout
+const WordPosition clockWords[] PROGMEM = {
+  {0, 2},     // W_ES
+  {3, 3},     // W_IST
+  {7, 4},     // W_FUNF_M
+  {11, 7},    // W_VIERTEL
+  {18, 4},    // W_ZEHN_M
+  {22, 7},    // W_ZWANZIG
+  {30, 3},    // W_VOR
+  {40, 4},    // W_NACH
+  {44, 4},    // W_HALB
+  {49, 3},    // W_ELF
+  {51, 4},    // W_FUNF_H
+  {66, 3},    // W_EIN
+  {66, 4},    // W_EINS
+  {73, 4},    // W_ZWEI
+  {77, 4},    // W_DREI
+  {84, 4},    // W_VIER_H
+  {88, 5},    // W_SECHS
+  {95, 4},    // W_ACHT
+  {99, 6},    // W_SIEBEN
+  {105, 5},   // W_ZWOLF
+  {110, 4},   // W_ZEHN_H
+  {113, 4},   // W_NEUN
+  {118, 3}    // W_UHR
+};
+
+// words for each 5 minute step
+const uint8_t minuteWords[12][3] PROGMEM = {
+  {NO_WORD, NO_WORD, NO_WORD},                        // :00
+  {W_FUNF_M, W_NACH, NO_WORD},                        // :05
+  {W_ZEHN_M, W_NACH, NO_WORD},                        // :10
+  {W_VIERTEL, W_NACH, NO_WORD},                       // :15
+  {W_ZWANZIG, W_NACH, NO_WORD},                       // :20
+  {W_FUNF_M, W_VOR, W_HALB},                          // :25
+  {W_HALB, NO_WORD, NO_WORD},                         // :30
+  {W_FUNF_M, W_NACH, W_HALB},                         // :35
+  {W_ZWANZIG, W_VOR, NO_WORD},                        // :40
+  {W_VIERTEL, W_VOR, NO_WORD},                        // :45
+  {W_ZEHN_M, W_VOR, NO_WORD},                         // :50
+  {W_FUNF_M, W_VOR, NO_WORD}                          // :55
+};
+
+// words for the hours in 12h format
+const uint8_t hourWords[12] PROGMEM = {
+  W_ZWOLF, W_EIN, W_ZWEI, W_DREI, W_VIER_H, W_FUNF_H,
+  W_SECHS, W_SIEBEN, W_ACHT, W_NEUN, W_ZEHN_H, W_ELF
+};
+
+/**
+ * @brief Converts the given time to a list of words on the clock
+ * 
+ * @param hours hours of the time value
+ * @param minutes minutes of the time value
+ * @param words list to be filled with the words (index into clockWords), needs space for MAX_WORDS_PER_TIME
+ * @return uint8_t number of words in the list
+ */
+uint8_t timeToWords(uint8_t hours, uint8_t minutes, uint8_t *words){
+  uint8_t numWords = 0;
+
+  //ES IST
+  words[numWords++] = W_ES;
+  words[numWords++] = W_IST;
+
+  //show minutes
+  numWords = appendWords(minuteWords[minutes / 5], sizeof(minuteWords[0]), words, numWords);
+
+  //convert hours to 12h format
+  if(hours >= 12)
+  {
+      hours -= 12;
+  }
+  if(minutes >= 25)
+  {
+      hours++;
+  }
+  if(hours == 12)
+  {
+      hours = 0;
+  }
+
+  // show hours, EIN(S)
+  if(hours == 1 && minutes > 4)
+  {
+    words[numWords++] = W_EINS;
+  }
+  else
+  {
+    words[numWords++] = pgm_read_byte(&hourWords[hours]);
+  }
+
+  if(minutes < 5)
+  {
+    words[numWords++] = W_UHR;
+  }
+
+  return numWords;
+}
+
+} // namespace german
+
+#ifndef LAYOUT_EXCLUDE_ENGLISH
+
+namespace english {
+
+// letters of the layout (row by row)
+//   ITPISKTENNP
+//   QUARTERHALF
+//   TWENTYUFIVE
+//   MINUTESNATO
+//   PASTMEAONEF
+//   TWONTHREELR
+//   FOUREAWFIVE
+//   OSIXZUSEVEN
+//   EIGHTELEVEN
+//   UNINETWELVE
+//   TENAWOCLOCK
+
+// words on the clock (index into clockWords)
+enum ClockWord {
+  W_IT, W_IS, W_TEN_M, W_QUARTER, W_HALF, W_TWENTY, W_FIVE_M, W_MINUTES, W_TO, W_PAST, W_ONE,
+  W_TWO, W_THREE, W_FOUR, W_FIVE_H, W_SIX, W_SEVEN, W_EIGHT, W_ELEVEN, W_NINE, W_TWELVE, W_TEN_H,
+  W_OCLOCK
+};
+
+// position of each word in the letters of the layout
+const WordPosition clockWords[] PROGMEM = {
+  {0, 2},     // W_IT
+  {3, 2},     // W_IS
+  {6, 3},     // W_TEN_M
+  {11, 7},    // W_QUARTER
+  {18, 4},    // W_HALF
+  {22, 6},    // W_TWENTY
+  {29, 4},    // W_FIVE_M
+  {33, 7},    // W_MINUTES
+  {42, 2},    // W_TO
+  {44, 4},    // W_PAST
+  {51, 3},    // W_ONE
+  {55, 3},    // W_TWO
+  {59, 5},    // W_THREE
+  {66, 4},    // W_FOUR
+  {73, 4},    // W_FIVE_H
+  {78, 3},    // W_SIX
+  {83, 5},    // W_SEVEN
+  {88, 5},    // W_EIGHT
+  {93, 6},    // W_ELEVEN
+  {100, 4},   // W_NINE
+  {104, 6},   // W_TWELVE
+  {110, 3},   // W_TEN_H
+  {115, 6}    // W_OCLOCK
+};
+
+// words for each 5 minute step
+const uint8_t minuteWords[12][4] PROGMEM = {
+  {NO_WORD, NO_WORD, NO_WORD, NO_WORD},               // :00
+  {W_FIVE_M, W_MINUTES, W_PAST, NO_WORD},             // :05
+  {W_TEN_M, W_MINUTES, W_PAST, NO_WORD},              // :10
+  {W_QUARTER, W_PAST, NO_WORD, NO_WORD},              // :15
+  {W_TWENTY, W_MINUTES, W_PAST, NO_WORD},             // :20
+  {W_TWENTY, W_FIVE_M, W_MINUTES, W_PAST},            // :25
+  {W_HALF, W_PAST, NO_WORD, NO_WORD},                 // :30
+  {W_TWENTY, W_FIVE_M, W_MINUTES, W_TO},              // :35
+  {W_TWENTY, W_MINUTES, W_TO, NO_WORD},               // :40
+  {W_QUARTER, W_TO, NO_WORD, NO_WORD},                // :45
+  {W_TEN_M, W_MINUTES, W_TO, NO_WORD},                // :50
+  {W_FIVE_M, W_MINUTES, W_TO, NO_WORD}                // :55
+};
+
+// words for the hours in 12h format
+const uint8_t hourWords[12] PROGMEM = {
+  W_TWELVE, W_ONE, W_TWO, W_THREE, W_FOUR, W_FIVE_H,
+  W_SIX, W_SEVEN, W_EIGHT, W_NINE, W_TEN_H, W_ELEVEN
+};
+
+/**
+ * @brief Converts the given time to a list of words on the clock
+ * 
+ * @param hours hours of the time value
+ * @param minutes minutes of the time value
+ * @param words list to be filled with the words (index into clockWords), needs space for MAX_WORDS_PER_TIME
+ * @return uint8_t number of words in the list
+ */
+uint8_t timeToWords(uint8_t hours, uint8_t minutes, uint8_t *words) {
+  uint8_t numWords = 0;
+
+  //IT IS
+  words[numWords++] = W_IT;
+  words[numWords++] = W_IS;
+
+  //show minutes (including PAST/TO)
+  numWords = appendWords(minuteWords[minutes / 5], sizeof(minuteWords[0]), words, numWords);
+
+  // Convert hours to 12h format
+  if (hours >= 12) {
+    hours -= 12;
+  }
+
+  // Increment hour for "TO" phrases (minutes 35 or more)
+  if (minutes >= 35) {
+    hours = (hours + 1) % 12;
+  }
+
+  // show hours
+  words[numWords++] = pgm_read_byte(&hourWords[hours]);
+
+  if (minutes < 5) {
+    words[numWords++] = W_OCLOCK;
+  }
+
+  return numWords;
+}
+
+} // namespace english
+#endif
+
+#ifndef LAYOUT_EXCLUDE_FRENCH
+
+namespace french {
+
+// letters of the layout (row by row)
+//   ILOESTZRTUE
+//   DEUXSTTROIS
+//   QUATRETNEUF
+//   UNESEPTHUIT
+//   SIXDIXKONZE
+//   CINQDHEURES
+//   MIDIRMINUIT
+//   MOINSAECINQ
+//   ETRQUARTDIX
+//   VINGT-CINQE
+//   ETKDEMIEILI
+
+// words on the clock (index into clockWords)
+enum ClockWord {
+  W_IL, W_EST, W_DEUX, W_TROIS, W_QUATRE, W_NEUF, W_UNE, W_SEPT, W_HUIT, W_SIX, W_DIX_H, W_ONZE,
+  W_CINQ_H, W_HEURE, W_HEURES, W_MIDI, W_MINUIT, W_MOINS, W_CINQ_M, W_ET_QUART, W_QUART, W_DIX_M,
+  W_VINGT, W_VINGT_CINQ, W_ET_DEMI, W_DEMI, W_DEMIE
+};
+
+// position of each word in the letters of the layout
+const WordPosition clockWords[] PROGMEM = {
+  {0, 2},     // W_IL
+  {3, 3},     // W_EST
+  {11, 4},    // W_DEUX
+  {17, 5},    // W_TROIS
+  {22, 6},    // W_QUATRE
+  {29, 4},    // W_NEUF
+  {33, 3},    // W_UNE
+  {36, 4},    // W_SEPT
+  {40, 4},    // W_HUIT
+  {44, 3},    // W_SIX
+  {47, 3},    // W_DIX_H
+  {51, 4},    // W_ONZE
+  {55, 4},    // W_CINQ_H
+  {60, 5},    // W_HEURE
+  {60, 6},    // W_HEURES
+  {66, 4},    // W_MIDI
+  {71, 6},    // W_MINUIT
+  {77, 5},    // W_MOINS
+  {84, 4},    // W_CINQ_M
+  {88, 2},    // W_ET_QUART
+  {91, 5},    // W_QUART
+  {96, 3},    // W_DIX_M
+  {99, 5},    // W_VINGT
+  {99, 10},   // W_VINGT_CINQ
+  {110, 2},   // W_ET_DEMI
+  {113, 4},   // W_DEMI
+  {113, 5}    // W_DEMIE
+};
+
+// words for each 5 minute step
+const uint8_t minuteWords[12][2] PROGMEM = {
+  {NO_WORD, NO_WORD},                                 // :00
+  {W_CINQ_M, NO_WORD},                                // :05
+  {W_DIX_M, NO_WORD},                                 // :10
+  {W_ET_QUART, W_QUART},                              // :15
+  {W_VINGT, NO_WORD},                                 // :20
+  {W_VINGT_CINQ, NO_WORD},                            // :25
+  {W_ET_DEMI, W_DEMIE},                               // :30
+  {W_MOINS, W_VINGT_CINQ},                            // :35
+  {W_MOINS, W_VINGT},                                 // :40
+  {W_MOINS, W_QUART},                                 // :45
+  {W_MOINS, W_DIX_M},                                 // :50
+  {W_MOINS, W_CINQ_M}                                 // :55
+};
+
+// words for the hours in 12h format
+const uint8_t hourWords[12] PROGMEM = {
+  NO_WORD, W_UNE, W_DEUX, W_TROIS, W_QUATRE, W_CINQ_H,
+  W_SIX, W_SEPT, W_HUIT, W_NEUF, W_DIX_H, W_ONZE
+};
+
+/**
+ * @brief Converts the given time to a list of words on the clock
+ * 
+ * @param hours hours of the time value
+ * @param minutes minutes of the time value
+ * @param words list to be filled with the words (index into clockWords), needs space for MAX_WORDS_PER_TIME
+ * @return uint8_t number of words in the list
+ */
+uint8_t timeToWords(uint8_t hours, uint8_t minutes, uint8_t *words) {
+  uint8_t numWords = 0;
+
+  // Rounding the minutes to the next 5-minute cycle
+  minutes = minutes / 5 * 5;
+
+  //IL EST
+  words[numWords++] = W_IL;
+  words[numWords++] = W_EST;
+
+  if(minutes >= 35)
+  {
+      hours++;
+  }
+
+  if ((hours == 0 && minutes <= 30) || (hours == 24 && minutes >= 35)) {
+    words[numWords++] = W_MINUIT;
+  } else if (hours == 12) {
+    words[numWords++] = W_MIDI;
+  } else {
+    uint8_t hours12h = hours;
+    if (hours12h > 12) {
+      hours12h -= 12;
+    }
+    words[numWords++] = pgm_read_byte(&hourWords[hours12h]);
+    words[numWords++] = (hours12h > 1 ? W_HEURES : W_HEURE);
+  }
+
+  // Format minutes
+  numWords = appendWords(minuteWords[minutes / 5], sizeof(minuteWords[0]), words, numWords);
+  if (minutes == 30 && (hours == 0 || hours == 12 || hours == 13)) {
+    // ET DEMI instead of ET DEMIE
+    words[numWords - 1] = W_DEMI;
+  }
+
+  return numWords;
+}
+
+} // namespace french
+#endif
+
+#ifndef LAYOUT_EXCLUDE_ITALIAN
+// HINT: I replaced the special Italian letters (E' and L') in the following letters with = and #
+namespace italian {
+
+// letters of the layout (row by row)
+//   SONORLEBORE
+//   =R#UNASDUEZ
+//   TREOTTONOVE
+//   DIECIUNDICI
+//   DODICISETTE
+//   QUATTROCSEI
+//   CINQUEAMENO
+//   ECUNOQUARTO
+//   VENTICINQUE
+//   LVETENAWOCL
+//   DIECIPMEZZA
+
+// words on the clock (index into clockWords)
+enum ClockWord {
+  W_SONO, W_LE, W_E_ACCENT, W_L_APOSTROPHE, W_UNA, W_DUE, W_TRE, W_OTTO, W_NOVE, W_DIECI_H,
+  W_UNDICI, W_DODICI, W_SETTE, W_QUATTRO, W_SEI, W_CINQUE_H, W_MENO, W_E, W_UN, W_QUARTO, W_VENTI,
+  W_VENTICINQUE, W_CINQUE_M, W_DIECI_M, W_MEZZA
+};
+
+// position of each word in the letters of the layout
+const WordPosition clockWords[] PROGMEM = {
+  {0, 4},     // W_SONO
+  {5, 2},     // W_LE
+  {11, 1},    // W_E_ACCENT
+  {13, 1},    // W_L_APOSTROPHE
+  {14, 3},    // W_UNA
+  {18, 3},    // W_DUE
+  {22, 3},    // W_TRE
+  {25, 4},    // W_OTTO
+  {29, 4},    // W_NOVE
+  {33, 5},    // W_DIECI_H
+  {38, 6},    // W_UNDICI
+  {44, 6},    // W_DODICI
+  {50, 5},    // W_SETTE
+  {55, 7},    // W_QUATTRO
+  {63, 3},    // W_SEI
+  {66, 6},    // W_CINQUE_H
+  {73, 4},    // W_MENO
+  {77, 1},    // W_E
+  {79, 2},    // W_UN
+  {82, 6},    // W_QUARTO
+  {88, 5},    // W_VENTI
+  {88, 11},   // W_VENTICINQUE
+  {93, 6},    // W_CINQUE_M
+  {110, 5},   // W_DIECI_M
+  {116, 5}    // W_MEZZA
+};
+
+// words for each 5 minute step
+const uint8_t minuteWords[12][3] PROGMEM = {
+  {NO_WORD, NO_WORD, NO_WORD},                        // :00
+  {W_E, W_CINQUE_M, NO_WORD},                         // :05
+  {W_E, W_DIECI_M, NO_WORD},                          // :10
+  {W_E, W_UN, W_QUARTO},                              // :15
+  {W_E, W_VENTI, NO_WORD},                            // :20
+  {W_E, W_VENTICINQUE, NO_WORD},                      // :25
+  {W_E, W_MEZZA, NO_WORD},                            // :30
+  {W_MENO, W_VENTICINQUE, NO_WORD},                   // :35
+  {W_MENO, W_VENTI, NO_WORD},                         // :40
+  {W_MENO, W_UN, W_QUARTO},                           // :45
+  {W_MENO, W_DIECI_M, NO_WORD},                       // :50
+  {W_MENO, W_CINQUE_M, NO_WORD}                       // :55
+};
+
+// words for the hours in 12h format
+const uint8_t hourWords[12] PROGMEM = {
+  W_DODICI, W_UNA, W_DUE, W_TRE, W_QUATTRO, W_CINQUE_H,
+  W_SEI, W_SETTE, W_OTTO, W_NOVE, W_DIECI_H, W_UNDICI
+};
+
+/**
+ * @brief Converts the given time to a list of words on the clock
+ * 
+ * @param hours hours of the time value
+ * @param minutes minutes of the time value
+ * @param words list to be filled with the words (index into clockWords), needs space for MAX_WORDS_PER_TIME
+ * @return uint8_t number of words in the list
+ */
+uint8_t timeToWords(uint8_t hours, uint8_t minutes, uint8_t *words){
+  uint8_t numWords = 0;
+
+  //convert hours to 12h format
+  if(hours >= 12)
+  {
+      hours -= 12;
+  }
+  if(minutes >= 35)
+  {
+      hours++;
+  }
+  if(hours == 12)
+  {
+      hours = 0;
+  }
+
+  //SONO LE
+  if(hours == 1)
+  {
+    //E' L'
+    words[numWords++] = W_E_ACCENT;
+    words[numWords++] = W_L_APOSTROPHE;
+  }
+  else
+  {
+    words[numWords++] = W_SONO;
+    words[numWords++] = W_LE;
+  }
+
+  // show hours
+  words[numWords++] = pgm_read_byte(&hourWords[hours]);
+
+  //show minutes
+  numWords = appendWords(minuteWords[minutes / 5], sizeof(minuteWords[0]), words, numWords);
+
+  return numWords;
+}
+
+} // namespace italian
+#endif
+
+#ifndef LAYOUT_EXCLUDE_JAVANESE
+
+namespace javanese {
+
+// letters of the layout (row by row)
+//   JAMASETENGA
+//   HTELOROLASI
+//   JIPAPATELUE
+//   NEMPITUWOLU
+//   LIMOSEPULOH
+//   SONGOOSEWEL
+//   ASPASIKURAN
+//   GPUNJULLIMO
+//   SEPRAPATKAT
+//   ESEPULOHIJU
+//   RONGPULOHAT
+//   SELAWEMENIT
+
+// words on the clock (index into clockWords)
+enum ClockWord {
+  W_JAM, W_SETENGAH, W_LORO, W_ROLAS, W_SIJI, W_PAPAT, W_TELU, W_ENEM, W_PITU, W_WOLU, W_LIMO_H,
+  W_SEPULOH_H, W_SONGO, W_SEWELAS, W_PAS, W_KURANG, W_PUNJUL, W_LIMO_M, W_SEPRAPAT, W_SEPULOH_M,
+  W_RONGPULOH, W_SELAWE, W_MENIT
+};
+
+// position of each word in the letters of the layout
+const WordPosition clockWords[] PROGMEM = {
+  {0, 3},     // W_JAM
+  {4, 8},     // W_SETENGAH
+  {14, 4},    // W_LORO
+  {16, 5},    // W_ROLAS
+  {20, 4},    // W_SIJI
+  {24, 5},    // W_PAPAT
+  {28, 4},    // W_TELU
+  {32, 4},    // W_ENEM
+  {36, 4},    // W_PITU
+  {40, 4},    // W_WOLU
+  {44, 4},    // W_LIMO_H
+  {48, 7},    // W_SEPULOH_H
+  {55, 5},    // W_SONGO
+  {61, 7},    // W_SEWELAS
+  {68, 3},    // W_PAS
+  {72, 6},    // W_KURANG
+  {78, 6},    // W_PUNJUL
+  {84, 4},    // W_LIMO_M
+  {88, 8},    // W_SEPRAPAT
+  {100, 7},   // W_SEPULOH_M
+  {110, 9},   // W_RONGPULOH
+  {121, 6},   // W_SELAWE
+  {127, 5}    // W_MENIT
+};
+
+// words for each 5 minute step
+const uint8_t minuteWords[12][2] PROGMEM = {
+  {NO_WORD, NO_WORD},                                 // :00
+  {W_LIMO_M, W_MENIT},                                // :05
+  {W_SEPULOH_M, W_MENIT},                             // :10
+  {W_SEPRAPAT, W_MENIT},                              // :15
+  {W_RONGPULOH, W_MENIT},                             // :20
+  {W_SELAWE, W_MENIT},                                // :25
+  {NO_WORD, NO_WORD},                                 // :30
+  {W_SELAWE, W_MENIT},                                // :35
+  {W_RONGPULOH, W_MENIT},                             // :40
+  {W_SEPRAPAT, W_MENIT},                              // :45
+  {W_SEPULOH_M, W_MENIT},                             // :50
+  {W_LIMO_M, W_MENIT}                                 // :55
+};
+
+// words for the hours in 12h format
+const uint8_t hourWords[12] PROGMEM = {
+  W_ROLAS, W_SIJI, W_LORO, W_TELU, W_PAPAT, W_LIMO_H,
+  W_ENEM, W_PITU, W_WOLU, W_SONGO, W_SEPULOH_H, W_SEWELAS
+};
+
+/**
+ * @brief Converts the given time to a list of words on the clock
+ * 
+ * @param hours hours of the time value
+ * @param minutes minutes of the time value
+ * @param words list to be filled with the words (index into clockWords), needs space for MAX_WORDS_PER_TIME
+ * @return uint8_t number of words in the list
+ */
+uint8_t timeToWords(uint8_t hours, uint8_t minutes, uint8_t *words) {
+  uint8_t numWords = 0;
+
+  //JAM
+  words[numWords++] = W_JAM;
+
+  hours = hours % 12;
+
+  if (minutes >= 30)
+    hours = (hours + 1) % 12;
+
+  if (minutes >= 30 && minutes < 35)
+    words[numWords++] = W_SETENGAH;
+
+  // show hours
+  words[numWords++] = pgm_read_byte(&hourWords[hours]);
+
+  if (minutes >= 35) {
+    words[numWords++] = W_KURANG;
+  } else if (minutes >= 5 && minutes < 30) {
+    words[numWords++] = W_PUNJUL;
+  }
+
+  //show minutes
+  numWords = appendWords(minuteWords[minutes / 5], sizeof(minuteWords[0]), words, numWords);
+
+  if (minutes < 5 || (minutes >= 30 && minutes < 35)) {
+    words[numWords++] = W_PAS;
+  }
+
+  return numWords;
+}
+
+} // namespace javanese
+#endif
+
+#ifndef LAYOUT_EXCLUDE_SWISS
+// Thanks to Sandro for providing this swiss german version
+namespace swiss {
+
+// letters of the layout (row by row)
+//   ESPESCHAFUF
+//   VIERTUBFZAA
+//   ZWANZGSIVOR
+//   ABOHWORTUHR
+//   HAUBIANESSI
+//   EISZWOISDRU
+//   VIERIYFUFIO
+//   SACHSISEBNI
+//   ACHTINUNIEL
+//   ZANIERBEUFI
+//   ZWOUFINAGSI
+
+// words on the clock (index into clockWords)
+enum ClockWord {
+  W_ES, W_ESCH, W_FUF, W_VIERTU, W_ZAA, W_ZWANZG, W_VOR, W_AB, W_HAUBI, W_EIS, W_ZWOI, W_DRU,
+  W_VIERI, W_FUFI, W_SACHSI, W_SEBNI, W_ACHTI, W_NUNI, W_ZANI, W_EUFI, W_ZWOUFI, W_GSI
+};
+
+// position of each word in the letters of the layout
+const WordPosition clockWords[] PROGMEM = {
+  {0, 2},     // W_ES
+  {3, 4},     // W_ESCH
+  {8, 3},     // W_FUF
+  {11, 6},    // W_VIERTU
+  {19, 3},    // W_ZAA
+  {22, 6},    // W_ZWANZG
+  {30, 3},    // W_VOR
+  {33, 2},    // W_AB
+  {44, 5},    // W_HAUBI
+  {55, 3},    // W_EIS
+  {58, 4},    // W_ZWOI
+  {63, 3},    // W_DRU
+  {66, 5},    // W_VIERI
+  {72, 4},    // W_FUFI
+  {77, 6},    // W_SACHSI
+  {83, 5},    // W_SEBNI
+  {88, 5},    // W_ACHTI
+  {93, 4},    // W_NUNI
+  {99, 4},    // W_ZANI
+  {106, 4},   // W_EUFI
+  {110, 6},   // W_ZWOUFI
+  {118, 3}    // W_GSI
+};
+
+// words for each 5 minute step
+const uint8_t minuteWords[12][3] PROGMEM = {
+  {NO_WORD, NO_WORD, NO_WORD},                        // :00
+  {W_FUF, W_AB, NO_WORD},                             // :05
+  {W_ZAA, W_AB, NO_WORD},                             // :10
+  {W_VIERTU, W_AB, NO_WORD},                          // :15
+  {W_ZWANZG, W_AB, NO_WORD},                          // :20
+  {W_FUF, W_VOR, W_HAUBI},                            // :25
+  {W_HAUBI, NO_WORD, NO_WORD},                        // :30
+  {W_FUF, W_AB, W_HAUBI},                             // :35
+  {W_ZWANZG, W_VOR, NO_WORD},                         // :40
+  {W_VIERTU, W_VOR, NO_WORD},                         // :45
+  {W_ZAA, W_VOR, NO_WORD},                            // :50
+  {W_FUF, W_VOR, NO_WORD}                             // :55
+};
+
+// words for the hours in 12h format
+const uint8_t hourWords[12] PROGMEM = {
+  W_ZWOUFI, W_EIS, W_ZWOI, W_DRU, W_VIERI, W_FUFI,
+  W_SACHSI, W_SEBNI, W_ACHTI, W_NUNI, W_ZANI, W_EUFI
+};
+
+/**
+ * @brief Converts the given time to a list of words on the clock
+ * 
+ * @param hours hours of the time value
+ * @param minutes minutes of the time value
+ * @param words list to be filled with the words (index into clockWords), needs space for MAX_WORDS_PER_TIME
+ * @return uint8_t number of words in the list
+ */
+uint8_t timeToWords(uint8_t hours, uint8_t minutes, uint8_t *words){
+  uint8_t numWords = 0;
+
+  //ES ESCH
+  words[numWords++] = W_ES;
+  words[numWords++] = W_ESCH;
+
+  //show minutes
+  numWords = appendWords(minuteWords[minutes / 5], sizeof(minuteWords[0]), words, numWords);
+
+  //convert hours to 12h format
+  if(hours >= 12)
+  {
+      hours -= 12;
+  }
+  if(minutes >= 25)
+  {
+      hours++;
+  }
+  if(hours == 12)
+  {
+      hours = 0;
+  }
+
+  // show hours
+  words[numWords++] = pgm_read_byte(&hourWords[hours]);
+
+  if(minutes < 5)
+  {
+    words[numWords++] = W_GSI;
+  }
+
+  return numWords;
+}
+
+} // namespace swiss
+#endif
+
+// description of a layout, words and timeToWords are NULL if the layout is excluded from the build
+struct WordClockLayout {
+  const char *name;
+  const WordPosition *words;
+  uint8_t (*timeToWords)(uint8_t hours, uint8_t minutes, uint8_t *words);
+};
+
+// all layouts, same order as enum ClockLayout (index is persisted in EEPROM)
+static const WordClockLayout layouts[NUM_LAYOUTS] = {
+  {"german", german::clockWords, german::timeToWords},
+#ifndef LAYOUT_EXCLUDE_ENGLISH
+  {"english", english::clockWords, english::timeToWords},
+#else
+  {"english", NULL, NULL},
+#endif
+#ifndef LAYOUT_EXCLUDE_FRENCH
+  {"french", french::clockWords, french::timeToWords},
+#else
+  {"french", NULL, NULL},
+#endif
+#ifndef LAYOUT_EXCLUDE_ITALIAN
+  {"italian", italian::clockWords, italian::timeToWords},
+#else
+  {"italian", NULL, NULL},
+#endif
+#ifndef LAYOUT_EXCLUDE_JAVANESE
+  {"javanese", javanese::clockWords, javanese::timeToWords},
+#else
+  {"javanese", NULL, NULL},
+#endif
+#ifndef LAYOUT_EXCLUDE_SWISS
+  {"swiss", swiss::clockWords, swiss::timeToWords}
+#else
+  {"swiss", NULL, NULL}
+#endif
+};
+
+/**
+ * @brief Check if the given layout is compiled into the firmware
+ * 
+ * @param layout index of layout (ClockLayout)
+ * @return true if layout can be used
+ */
+bool isLayoutAvailable(uint8_t layout){
+  return layout < NUM_LAYOUTS && layouts[layout].timeToWords != NULL;
+}
+
+/**
+ * @brief Get the name of the given layout (as used for the /cmd?lang= command)
+ * 
+ * @param layout index of layout (ClockLayout)
+ * @return const char* name of layout, empty string if index is invalid
+ */
+const char* getLayoutName(uint8_t layout){
+  if(layout >= NUM_LAYOUTS) return "";
+  return layouts[layout].name;
+}
+
+/**
+ * @brief Find a layout by its name
+ * 
+ * @param name name of the layout (e.g. "english")
+ * @return int8_t index of layout (ClockLayout), -1 if no available layout has this name
+ */
+int8_t findLayout(const char *name){
+  for(uint8_t i = 0; i < NUM_LAYOUTS; i++){
+    if(isLayoutAvailable(i) && strcmp(name, layouts[i].name) == 0){
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Converts the given time to a list of words on the clock of the given layout
+ * 
+ * @param layout index of layout (ClockLayout), needs to be available
+ * @param hours hours of the time value
+ * @param minutes minutes of the time value
+ * @param words list to be filled with the words, needs space for MAX_WORDS_PER_TIME
+ * @return uint8_t number of words in the list
+ */
+uint8_t layoutTimeToWords(uint8_t layout, uint8_t hours, uint8_t minutes, uint8_t *words){
+  if(!isLayoutAvailable(layout)) return 0;
+  return layouts[layout].timeToWords(hours, minutes, words);
+}
+
+/**
+ * @brief Get the position of a word on the clock of the given layout
+ * 
+ * @param layout index of layout (ClockLayout), needs to be available
+ * @param word index of word (as returned by layoutTimeToWords)
+ * @return WordPosition position of the word
+ */
+WordPosition getWordPosition(uint8_t layout, uint8_t word){
+  WordPosition position = {0, 0};
+  if(isLayoutAvailable(layout)){
+    position.start = pgm_read_byte(&layouts[layout].words[word].start);
+    position.length = pgm_read_byte(&layouts[layout].words[word].length);
+  }
+  return position;
+}
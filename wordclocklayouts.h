@@ -0,0 +1,35 @@
+/**
+ * @file wordclocklayouts.h
+ * @brief Word tables of all supported languages (front plate layouts) of the word clock
+ *
+ * All layouts are compiled into the firmware as PROGMEM tables, so the language can be switched at runtime.
+ * To save flash, a layout can be excluded from the build by defining LAYOUT_EXCLUDE_<NAME>
+ * (e.g. -DLAYOUT_EXCLUDE_FRENCH), the german layout is always included as default.
+ *
+ */
+
+#ifndef wordclocklayouts_h
+#define wordclocklayouts_h
+
+#include <Arduino.h>
+
+#define NUM_LAYOUTS 6
+enum ClockLayout {lt_german, lt_english, lt_french, lt_italian, lt_javanese, lt_swiss};
+#define DEFAULT_LAYOUT lt_german
+
+#define NO_WORD 0xFF
+#define MAX_WORDS_PER_TIME 8
+
+// position of a word on the clock (index of first letter in the letters of the layout, number of letters)
+struct WordPosition {
+  uint8_t start;
+  uint8_t length;
+};
+
+bool isLayoutAvailable(uint8_t layout);
+const char* getLayoutName(uint8_t layout);
+int8_t findLayout(const char *name);
+uint8_t layoutTimeToWords(uint8_t layout, uint8_t hours, uint8_t minutes, uint8_t *words);
+WordPosition getWordPosition(uint8_t layout, uint8_t word);
+
+#endif